@@ -0,0 +1,1742 @@
+/* Copyright Swann Perarnau 2009
+*
+*   contact : Swann.Perarnau@imag.fr
+*
+* This software is a computer program whose purpose is to help the
+* random generation of graph structures and adding various properties
+* on those structures.
+*
+* This software is governed by the CeCILL  license under French law and
+* abiding by the rules of distribution of free software.  You can  use,
+* modify and/ or redistribute the software under the terms of the CeCILL
+* license as circulated by CEA, CNRS and INRIA at the following URL
+* "http://www.cecill.info".
+*
+* As a counterpart to the access to the source code and  rights to copy,
+* modify and redistribute granted by the license, users are provided only
+* with a limited warranty  and the software's author,  the holder of the
+* economic rights,  and the successive licensors  have only  limited
+* liability.
+*
+* In this respect, the user's attention is drawn to the risks associated
+* with loading,  using,  modifying and/or developing or reproducing the
+* software by the user in light of its specific status of free software,
+* that may mean  that it is complicated to manipulate,  and  that  also
+* therefore means  that it is reserved for developers  and  experienced
+* professionals having in-depth computer knowledge. Users are therefore
+* encouraged to load and test the software's suitability as regards their
+* requirements in conditions enabling the security of their systems and/or
+* data to be ensured and,  more generally, to use and operate it in the
+* same conditions as regards security.
+*
+* The fact that you are presently reading this means that you have had
+* knowledge of the CeCILL license and that you accept its terms.
+*/
+
+/* Binary graphs:
+ * DOT needs to be parsed again at each step of a pipeline, this format is
+ * loaded with little more than a validation pass. A graph is a single
+ * record, all integers are little endian and every section starts on a
+ * multiple of 8 bytes from the start of the record:
+ *  header (64 bytes):
+ *   8 bytes  magic "GGENGRPH"
+ *   4 bytes  version (1)
+ *   4 bytes  width w of an index in bytes (4 or 8)
+ *   8 bytes  size of the record in bytes
+ *   8 bytes  number of vertices n
+ *   8 bytes  number of edges m
+ *   4 bytes  number of graph, vertex and edge attributes (three times)
+ *   12 bytes reserved, zero
+ *  n+1 indices: CSR offsets, the edges of vertex v are [off[v],off[v+1])
+ *  m indices: heads of the edges
+ *  then the graph, vertex and edge attributes, each of them being:
+ *   4 bytes  type (1 numeric, 2 string)
+ *   4 bytes  length l of its name
+ *   l+1 bytes name, NUL terminated
+ *   numeric: one double (IEEE 754, 8 bytes) per object
+ *   string: 8 bytes number of strings s, 8 bytes size of the table t,
+ *     one index in the table per object, s+1 offsets (8 bytes) of the
+ *     strings in the table, t bytes of NUL terminated strings
+ * There is 1 graph object, n vertices and m edges in CSR order: once
+ * read, edge ids follow the CSR order, like with the DOT readers.
+ *
+ * The edge lists written by ggen_edge_sink_binary() can be read too.
+ *
+ * Several graphs make a corpus: records simply put one after the other,
+ * or a container indexing them:
+ *  8 bytes  magic "GGENCORP"
+ *  4 bytes  version (1)
+ *  4 bytes  reserved, zero
+ *  the records, each of them starting on a multiple of 8 bytes
+ *  index: offset and size (8 bytes each) of every record
+ *  8 bytes  number of records
+ *  8 bytes  offset of the index
+ *  8 bytes  magic "GGENCEND"
+ * A container can be read backwards from its end, without going through
+ * the records.
+ */
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "utils.h"
+#include "log.h"
+
+#define BIN_MAGIC "GGENGRPH"
+#define BIN_VERSION 1
+#define BIN_HEADER_SIZE 64
+#define BIN_NUMERIC 1
+#define BIN_STRING 2
+
+/* see ggen_edge_sink_binary() */
+#define EDGE_MAGIC "GGENEDGE"
+#define EDGE_VERSION 1
+#define EDGE_HEADER_SIZE 32
+
+#define CORPUS_MAGIC "GGENCORP"
+#define CORPUS_END_MAGIC "GGENCEND"
+#define CORPUS_VERSION 1
+#define CORPUS_HEADER_SIZE 16
+#define CORPUS_TRAILER_SIZE 24
+
+#define PAD8(x) (((x) + 7) & ~(uint64_t)7)
+
+/* attributes are stored in this order */
+enum bin_kind { GRAPH_ATTR, VERTEX_ATTR, EDGE_ATTR };
+
+int ggen_is_binary(const char *data, size_t len)
+{
+	return len >= 8 && (!memcmp(data,BIN_MAGIC,8) || !memcmp(data,EDGE_MAGIC,8)
+			|| !memcmp(data,CORPUS_MAGIC,8));
+}
+
+static uint64_t get_le(const unsigned char *p, unsigned int width)
+{
+	uint64_t v = 0;
+	unsigned int i;
+
+	for(i = width; i > 0; i--)
+		v = (v << 8) | p[i-1];
+	return v;
+}
+
+static double get_double(const unsigned char *p)
+{
+	uint64_t bits = get_le(p,8);
+	double v;
+
+	memcpy(&v,&bits,sizeof(double));
+	return v;
+}
+
+/**********************************************************
+ * writing
+ *********************************************************/
+
+#define BIN_BUFFER_SIZE (1 << 20)
+
+struct bin_out {
+	FILE *f;
+	unsigned char *buf;
+	size_t len;
+	uint64_t pos;
+	int err;
+};
+
+static void bin_flush(struct bin_out *o)
+{
+	if(o->len && fwrite(o->buf,1,o->len,o->f) != o->len)
+		o->err = 1;
+	o->len = 0;
+}
+
+static void bin_mem(struct bin_out *o, const void *s, size_t n)
+{
+	o->pos += n;
+	if(o->len + n > BIN_BUFFER_SIZE)
+	{
+		bin_flush(o);
+		if(n > BIN_BUFFER_SIZE)
+		{
+			if(fwrite(s,1,n,o->f) != n)
+				o->err = 1;
+			return;
+		}
+	}
+	memcpy(o->buf + o->len,s,n);
+	o->len += n;
+}
+
+static void bin_le(struct bin_out *o, uint64_t v, unsigned int width)
+{
+	unsigned char tmp[8];
+	unsigned int i;
+
+	for(i = 0; i < width; i++)
+		tmp[i] = (v >> (8*i)) & 0xff;
+	bin_mem(o,tmp,width);
+}
+
+static void bin_pad(struct bin_out *o)
+{
+	static const unsigned char zeros[8] = { 0 };
+
+	bin_mem(o,zeros,PAD8(o->pos) - o->pos);
+}
+
+/* an attribute to write, string values are gathered in a table without
+ * duplicates */
+struct bin_column {
+	const char *name;
+	int type;
+	unsigned long count;
+	unsigned long *index;
+	const char **strings;
+	unsigned long nstrings;
+	uint64_t nbytes;
+};
+
+/* value of an object, in CSR order for edges */
+static const char *bin_string(igraph_t *g, const char *name, int kind,
+		unsigned long *order, unsigned long i)
+{
+	if(kind == GRAPH_ATTR)
+		return GAS(g,name);
+	else if(kind == VERTEX_ATTR)
+		return VAS(g,name,i);
+	return EAS(g,name,order[i]);
+}
+
+static double bin_numeric(igraph_t *g, const char *name, int kind,
+		unsigned long *order, unsigned long i)
+{
+	if(kind == GRAPH_ATTR)
+		return GAN(g,name);
+	else if(kind == VERTEX_ATTR)
+		return VAN(g,name,i);
+	return EAN(g,name,order[i]);
+}
+
+static unsigned long bin_hash_mem(const char *s, size_t len)
+{
+	unsigned long h = 14695981039346656037UL;
+	size_t i;
+
+	for(i = 0; i < len; i++)
+	{
+		h ^= (unsigned char)s[i];
+		h *= 1099511628211UL;
+	}
+	return h;
+}
+
+static unsigned long bin_hash(const char *s)
+{
+	return bin_hash_mem(s,strlen(s));
+}
+
+static int bin_column_strings(struct bin_column *c, igraph_t *g, int kind,
+		unsigned long *order)
+{
+	unsigned long *table = NULL;
+	unsigned long i,h,mask,size;
+	const char *s;
+
+	c->index = malloc((c->count + 1)*sizeof(unsigned long));
+	c->strings = malloc((c->count + 1)*sizeof(char *));
+	for(size = 16; size < 2*c->count; size *= 2);
+	table = calloc(size,sizeof(unsigned long));
+	if(c->index == NULL || c->strings == NULL || table == NULL)
+	{
+		free(table);
+		return 1;
+	}
+
+	mask = size - 1;
+	for(i = 0; i < c->count; i++)
+	{
+		s = bin_string(g,c->name,kind,order,i);
+		if(s == NULL)
+			s = "";
+		h = bin_hash(s) & mask;
+		while(table[h] && strcmp(c->strings[table[h] - 1],s))
+			h = (h + 1) & mask;
+		if(!table[h])
+		{
+			c->strings[c->nstrings] = s;
+			c->nbytes += strlen(s) + 1;
+			table[h] = ++c->nstrings;
+		}
+		c->index[i] = table[h] - 1;
+	}
+	free(table);
+	return 0;
+}
+
+static uint64_t bin_column_size(struct bin_column *c, unsigned int width)
+{
+	uint64_t size = 8 + PAD8(strlen(c->name) + 1);
+
+	if(c->type == BIN_NUMERIC)
+		return size + 8*(uint64_t)c->count;
+	return size + 16 + PAD8(width*(uint64_t)c->count) + 8*((uint64_t)c->nstrings + 1)
+		+ PAD8(c->nbytes);
+}
+
+static void bin_column_write(struct bin_out *o, struct bin_column *c, igraph_t *g,
+		int kind, unsigned long *order, unsigned int width)
+{
+	unsigned long i;
+	uint64_t bits,offset;
+	double v;
+
+	bin_le(o,c->type,4);
+	bin_le(o,strlen(c->name),4);
+	bin_mem(o,c->name,strlen(c->name) + 1);
+	bin_pad(o);
+
+	if(c->type == BIN_NUMERIC)
+	{
+		for(i = 0; i < c->count; i++)
+		{
+			v = bin_numeric(g,c->name,kind,order,i);
+			memcpy(&bits,&v,sizeof(double));
+			bin_le(o,bits,8);
+		}
+		return;
+	}
+
+	bin_le(o,c->nstrings,8);
+	bin_le(o,c->nbytes,8);
+	for(i = 0; i < c->count; i++)
+		bin_le(o,c->index[i],width);
+	bin_pad(o);
+	offset = 0;
+	for(i = 0; i < c->nstrings; i++)
+	{
+		bin_le(o,offset,8);
+		offset += strlen(c->strings[i]) + 1;
+	}
+	bin_le(o,offset,8);
+	for(i = 0; i < c->nstrings; i++)
+		bin_mem(o,c->strings[i],strlen(c->strings[i]) + 1);
+	bin_pad(o);
+}
+
+static void bin_columns_destroy(struct bin_column *c, unsigned long count)
+{
+	unsigned long i;
+
+	for(i = 0; i < count; i++)
+	{
+		free(c[i].index);
+		free(c[i].strings);
+	}
+	free(c);
+}
+
+/* columns of one kind of attributes */
+static struct bin_column *bin_columns_init(igraph_t *g, int kind,
+		igraph_strvector_t *names, igraph_vector_t *types, unsigned long count,
+		unsigned long *order, unsigned long *ncols)
+{
+	struct bin_column *c;
+	long i;
+
+	*ncols = 0;
+	c = calloc(igraph_strvector_size(names) + 1,sizeof(struct bin_column));
+	if(c == NULL)
+		return NULL;
+
+	for(i = 0; i < igraph_strvector_size(names); i++)
+	{
+		if(VECTOR(*types)[i] == IGRAPH_ATTRIBUTE_NUMERIC)
+			c[*ncols].type = BIN_NUMERIC;
+		else if(VECTOR(*types)[i] == IGRAPH_ATTRIBUTE_STRING)
+			c[*ncols].type = BIN_STRING;
+		else
+		{
+			warning("Skipping attribute %s of unsupported type\n",STR(*names,i));
+			continue;
+		}
+		c[*ncols].name = STR(*names,i);
+		c[*ncols].count = count;
+		if(c[*ncols].type == BIN_STRING &&
+				bin_column_strings(&c[*ncols],g,kind,order))
+		{
+			bin_columns_destroy(c,*ncols + 1);
+			return NULL;
+		}
+		(*ncols)++;
+	}
+	return c;
+}
+
+int ggen_write_graph_binary(igraph_t *g, FILE *output)
+{
+	struct bin_out o;
+	struct bin_column *cols[3] = { NULL, NULL, NULL };
+	unsigned long ncols[3] = { 0, 0, 0 };
+	igraph_strvector_t gnames,vnames,enames;
+	igraph_vector_t gtypes,vtypes,etypes;
+	igraph_integer_t from,to;
+	unsigned long i,k,vcount,ecount;
+	unsigned long *start = NULL,*order = NULL,*heads = NULL;
+	unsigned int width;
+	uint64_t size;
+	int err = 1;
+
+	vcount = igraph_vcount(g);
+	ecount = igraph_ecount(g);
+	width = (vcount <= UINT32_MAX && ecount <= UINT32_MAX) ? 4 : 8;
+
+	o.f = output;
+	o.len = 0;
+	o.pos = 0;
+	o.err = 0;
+	o.buf = malloc(BIN_BUFFER_SIZE);
+	if(o.buf == NULL)
+		return 1;
+
+	igraph_strvector_init(&gnames,0);
+	igraph_strvector_init(&vnames,0);
+	igraph_strvector_init(&enames,0);
+	igraph_vector_init(&gtypes,0);
+	igraph_vector_init(&vtypes,0);
+	igraph_vector_init(&etypes,0);
+
+	/* CSR: edges are sorted by tail, keeping their order otherwise */
+	start = calloc(vcount + 2,sizeof(unsigned long));
+	order = malloc((ecount + 1)*sizeof(unsigned long));
+	heads = malloc((ecount + 1)*sizeof(unsigned long));
+	if(start == NULL || order == NULL || heads == NULL)
+		goto cleanup;
+
+	for(i = 0; i < ecount; i++)
+	{
+		igraph_edge(g,i,&from,&to);
+		start[(unsigned long)from + 2]++;
+	}
+	for(i = 0; i < vcount; i++)
+		start[i+2] += start[i+1];
+	for(i = 0; i < ecount; i++)
+	{
+		igraph_edge(g,i,&from,&to);
+		k = start[(unsigned long)from + 1]++;
+		order[k] = i;
+		heads[k] = (unsigned long)to;
+	}
+	/* start[v] is now the first edge of v */
+
+	if(igraph_cattribute_list(g,&gnames,&gtypes,&vnames,&vtypes,&enames,&etypes))
+		goto cleanup;
+
+	cols[0] = bin_columns_init(g,GRAPH_ATTR,&gnames,&gtypes,1,order,&ncols[0]);
+	cols[1] = bin_columns_init(g,VERTEX_ATTR,&vnames,&vtypes,vcount,order,&ncols[1]);
+	cols[2] = bin_columns_init(g,EDGE_ATTR,&enames,&etypes,ecount,order,&ncols[2]);
+	if(cols[0] == NULL || cols[1] == NULL || cols[2] == NULL)
+		goto cleanup;
+
+	size = BIN_HEADER_SIZE + PAD8(width*((uint64_t)vcount + 1)) + PAD8(width*(uint64_t)ecount);
+	for(k = 0; k < 3; k++)
+		for(i = 0; i < ncols[k]; i++)
+			size += bin_column_size(&cols[k][i],width);
+
+	/* header */
+	bin_mem(&o,BIN_MAGIC,8);
+	bin_le(&o,BIN_VERSION,4);
+	bin_le(&o,width,4);
+	bin_le(&o,size,8);
+	bin_le(&o,vcount,8);
+	bin_le(&o,ecount,8);
+	for(k = 0; k < 3; k++)
+		bin_le(&o,ncols[k],4);
+	bin_pad(&o);
+	bin_le(&o,0,8);
+
+	/* structure */
+	for(i = 0; i <= vcount; i++)
+		bin_le(&o,start[i],width);
+	bin_pad(&o);
+	for(i = 0; i < ecount; i++)
+		bin_le(&o,heads[i],width);
+	bin_pad(&o);
+
+	for(k = 0; k < 3; k++)
+		for(i = 0; i < ncols[k]; i++)
+			bin_column_write(&o,&cols[k][i],g,k,order,width);
+
+	bin_flush(&o);
+	if(o.pos != size)
+		error("Binary graph size mismatch, this is a bug\n");
+	err = o.err || o.pos != size || fflush(output) != 0;
+cleanup:
+	for(k = 0; k < 3; k++)
+		if(cols[k] != NULL)
+			bin_columns_destroy(cols[k],ncols[k]);
+	igraph_strvector_destroy(&gnames);
+	igraph_strvector_destroy(&vnames);
+	igraph_strvector_destroy(&enames);
+	igraph_vector_destroy(&gtypes);
+	igraph_vector_destroy(&vtypes);
+	igraph_vector_destroy(&etypes);
+	free(start);
+	free(order);
+	free(heads);
+	free(o.buf);
+	return err;
+}
+
+/**********************************************************
+ * reading
+ *********************************************************/
+
+/* bounded cursor over a record */
+struct bin_in {
+	const unsigned char *p;
+	uint64_t pos;
+	uint64_t size;
+};
+
+/* count elements of size bytes, the cursor is aligned afterwards */
+static const unsigned char *bin_take(struct bin_in *in, uint64_t count, uint64_t size)
+{
+	const unsigned char *r;
+
+	if(in->pos > in->size || (size && count > (in->size - in->pos)/size))
+		return NULL;
+	r = in->p + in->pos;
+	in->pos = PAD8(in->pos + count*size);
+	return r;
+}
+
+/* an attribute of a record, once checked */
+struct bin_view {
+	const char *name;
+	uint64_t type;
+	unsigned int width;
+	const unsigned char *values;
+	const unsigned char *offsets;
+	const char *table;
+	uint64_t nstrings;
+};
+
+static int bin_view_column(struct bin_view *c, struct bin_in *in, uint64_t count,
+		unsigned int width)
+{
+	const unsigned char *h;
+	uint64_t i,len,nbytes,off,next;
+
+	h = bin_take(in,1,8);
+	if(h == NULL)
+		return 1;
+	c->type = get_le(h,4);
+	c->width = width;
+	len = get_le(h + 4,4);
+	c->name = (const char *)bin_take(in,len + 1,1);
+	if(c->name == NULL || c->name[len] != '\0' || strlen(c->name) != len)
+		return 1;
+
+	if(c->type == BIN_NUMERIC)
+	{
+		c->values = bin_take(in,count,8);
+		return c->values == NULL;
+	}
+	if(c->type != BIN_STRING)
+		return 1;
+
+	h = bin_take(in,2,8);
+	if(h == NULL)
+		return 1;
+	c->nstrings = get_le(h,8);
+	nbytes = get_le(h + 8,8);
+	c->values = bin_take(in,count,width);
+	if(c->values == NULL || c->nstrings == UINT64_MAX)
+		return 1;
+	c->offsets = bin_take(in,c->nstrings + 1,8);
+	c->table = (const char *)bin_take(in,nbytes,1);
+	if(c->offsets == NULL || c->table == NULL)
+		return 1;
+
+	/* every string must end in the table, and with a NUL */
+	off = 0;
+	for(i = 0; i < c->nstrings; i++)
+	{
+		if(get_le(c->offsets + 8*i,8) != off)
+			return 1;
+		next = get_le(c->offsets + 8*(i+1),8);
+		if(next <= off || next > nbytes || c->table[next - 1] != '\0')
+			return 1;
+		off = next;
+	}
+	for(i = 0; i < count; i++)
+		if(get_le(c->values + width*i,width) >= c->nstrings)
+			return 1;
+	return 0;
+}
+
+static const char *bin_view_string(const struct bin_view *c, uint64_t i)
+{
+	return c->table + get_le(c->offsets + 8*get_le(c->values + c->width*i,c->width),8);
+}
+
+static int bin_read_column(igraph_t *g, struct bin_in *in, int kind,
+		uint64_t count, unsigned int width)
+{
+	struct bin_view c;
+	igraph_vector_t numbers;
+	igraph_strvector_t strings;
+	const char *s;
+	uint64_t i;
+	int err;
+
+	if(bin_view_column(&c,in,count,width))
+		return 1;
+	/* bin_kind and ggen_object agree */
+	if(!ggen_attr_wanted(kind,c.name,strlen(c.name)))
+		return 0;
+
+	if(c.type == BIN_NUMERIC)
+	{
+		if(kind == GRAPH_ATTR)
+			return SETGAN(g,c.name,get_double(c.values));
+
+		err = igraph_vector_init(&numbers,count);
+		if(err) return err;
+		for(i = 0; i < count; i++)
+			VECTOR(numbers)[i] = get_double(c.values + 8*i);
+		err = kind == VERTEX_ATTR ? SETVANV(g,c.name,&numbers) : SETEANV(g,c.name,&numbers);
+		igraph_vector_destroy(&numbers);
+		return err;
+	}
+
+	if(kind == GRAPH_ATTR)
+		return SETGAS(g,c.name,bin_view_string(&c,0));
+
+	err = igraph_strvector_init(&strings,count);
+	if(err) return err;
+	for(i = 0; i < count; i++)
+	{
+		s = bin_view_string(&c,i);
+		/* igraph strings are empty by default */
+		if(*s == '\0')
+			continue;
+		err = igraph_strvector_set(&strings,i,s);
+		if(err) break;
+	}
+	if(!err)
+		err = kind == VERTEX_ATTR ? SETVASV(g,c.name,&strings) : SETEASV(g,c.name,&strings);
+	igraph_strvector_destroy(&strings);
+	return err;
+}
+
+/* edge lists written by the binary sink, the counts are all ones when
+ * the output was not seekable. Edges are grouped by tail, like the other
+ * readers do */
+static int bin_edges_header(const unsigned char *p, size_t len, unsigned int *width,
+		uint64_t *n, uint64_t *m)
+{
+	if(len < EDGE_HEADER_SIZE || get_le(p + 8,4) != EDGE_VERSION)
+		return 1;
+	*width = get_le(p + 12,4);
+	if(*width != 4 && *width != 8)
+		return 1;
+	*n = get_le(p + 16,8);
+	*m = get_le(p + 24,8);
+	if(*m == UINT64_MAX)
+		*m = (len - EDGE_HEADER_SIZE)/(2 * *width);
+	return *m > (len - EDGE_HEADER_SIZE)/(2 * *width);
+}
+
+static int bin_read_edges(igraph_t *g, const unsigned char *p, size_t len)
+{
+	igraph_vector_t edges;
+	uint64_t i,k,n,m,from,max;
+	uint64_t *start;
+	unsigned int width;
+	int err;
+
+	if(bin_edges_header(p,len,&width,&n,&m))
+		return 1;
+	p += EDGE_HEADER_SIZE;
+
+	max = 0;
+	for(i = 0; i < 2*m; i++)
+		if(get_le(p + width*i,width) >= max)
+			max = get_le(p + width*i,width) + 1;
+	if(n == UINT64_MAX)
+		n = max;
+	if(max > n)
+		return 1;
+
+	start = calloc(n + 1,sizeof(uint64_t));
+	if(start == NULL)
+		return 1;
+	err = igraph_vector_init(&edges,2*m);
+	if(err) goto cleanup_s;
+
+	for(i = 0; i < m; i++)
+		start[get_le(p + 2*width*i,width) + 1]++;
+	for(i = 0; i < n; i++)
+		start[i+1] += start[i];
+	for(i = 0; i < m; i++)
+	{
+		from = get_le(p + 2*width*i,width);
+		k = start[from]++;
+		VECTOR(edges)[2*k] = from;
+		VECTOR(edges)[2*k+1] = get_le(p + 2*width*i + width,width);
+	}
+
+	err = igraph_empty(g,n,1);
+	if(err) goto cleanup;
+	err = igraph_add_edges(g,&edges,NULL);
+	if(err)
+		igraph_destroy(g);
+cleanup:
+	igraph_vector_destroy(&edges);
+cleanup_s:
+	free(start);
+	return err;
+}
+
+/* header and structure of a record, the cursor is left on the
+ * attributes */
+static int bin_open(struct bin_in *in, const char *data, size_t len,
+		unsigned int *width, uint64_t *n, uint64_t *m, uint64_t *ncols,
+		const unsigned char **offsets, const unsigned char **heads)
+{
+	const unsigned char *p = (const unsigned char *)data;
+	uint64_t k,size;
+
+	if(len < BIN_HEADER_SIZE || memcmp(data,BIN_MAGIC,8))
+		goto invalid;
+	if(get_le(p + 8,4) != BIN_VERSION)
+	{
+		error("Unsupported binary graph version %lu\n",(unsigned long)get_le(p + 8,4));
+		return 1;
+	}
+	*width = get_le(p + 12,4);
+	size = get_le(p + 16,8);
+	*n = get_le(p + 24,8);
+	*m = get_le(p + 32,8);
+	for(k = 0; k < 3; k++)
+		ncols[k] = get_le(p + 40 + 4*k,4);
+	if((*width != 4 && *width != 8) || size > len || size < BIN_HEADER_SIZE)
+		goto invalid;
+
+	in->p = p;
+	in->pos = BIN_HEADER_SIZE;
+	in->size = size;
+	*offsets = *n == UINT64_MAX ? NULL : bin_take(in,*n + 1,*width);
+	*heads = bin_take(in,*m,*width);
+	if(*offsets == NULL || *heads == NULL)
+		goto invalid;
+
+	/* structure */
+	if(get_le(*offsets,*width) != 0 || get_le(*offsets + *width * *n,*width) != *m)
+		goto invalid;
+	return 0;
+invalid:
+	error("Invalid binary graph\n");
+	return 1;
+}
+
+int ggen_read_graph_binary(igraph_t *g, const char *data, size_t len)
+{
+	const unsigned char *p = (const unsigned char *)data;
+	const unsigned char *offsets,*heads;
+	struct bin_in in;
+	igraph_vector_t edges;
+	uint64_t i,k,n,m,off,next,head,size;
+	uint64_t ncols[3];
+	unsigned int width;
+	int err;
+
+	/* only the first graph of a corpus */
+	if(len >= 8 && !memcmp(data,CORPUS_MAGIC,8))
+	{
+		if(ggen_container_index(data,len,&i) || i == 0
+				|| ggen_container_graph(data,len,0,&off,&size))
+			goto invalid;
+		return ggen_read_graph_binary(g,data + off,size);
+	}
+	if(len >= 8 && !memcmp(data,EDGE_MAGIC,8))
+	{
+		err = bin_read_edges(g,p,len);
+		if(err) error("Invalid binary edge list\n");
+		return err;
+	}
+
+	if(bin_open(&in,data,len,&width,&n,&m,ncols,&offsets,&heads))
+		return 1;
+
+	err = igraph_vector_init(&edges,2*m);
+	if(err) return err;
+	off = 0;
+	for(i = 0; i < n; i++)
+	{
+		next = get_le(offsets + width*(i+1),width);
+		if(next < off || next > m)
+			goto invalid_e;
+		for(k = off; k < next; k++)
+		{
+			head = get_le(heads + width*k,width);
+			if(head >= n)
+				goto invalid_e;
+			VECTOR(edges)[2*k] = i;
+			VECTOR(edges)[2*k+1] = head;
+		}
+		off = next;
+	}
+
+	err = igraph_empty(g,n,1);
+	if(err) goto cleanup;
+	err = igraph_add_edges(g,&edges,NULL);
+	if(err) goto error;
+
+	/* attributes */
+	for(k = 0; k < 3; k++)
+		for(i = 0; i < ncols[k]; i++)
+		{
+			err = bin_read_column(g,&in,k,k == GRAPH_ATTR ? 1 : k == VERTEX_ATTR ? n : m,width);
+			if(err)
+			{
+				error("Invalid binary graph attribute\n");
+				goto error;
+			}
+		}
+	goto cleanup;
+error:
+	igraph_destroy(g);
+cleanup:
+	igraph_vector_destroy(&edges);
+	return err;
+invalid_e:
+	igraph_vector_destroy(&edges);
+invalid:
+	error("Invalid binary graph\n");
+	return 1;
+}
+
+/**********************************************************
+ * corpora
+ *********************************************************/
+
+/* size of the record starting at data, the whole input when it cannot be
+ * told (the reader will complain if it is not a graph) */
+size_t ggen_binary_record_size(const char *data, size_t len)
+{
+	const unsigned char *p = (const unsigned char *)data;
+	uint64_t size,width,m;
+
+	if(len >= BIN_HEADER_SIZE && !memcmp(data,BIN_MAGIC,8))
+	{
+		size = get_le(p + 16,8);
+		if(size >= BIN_HEADER_SIZE && size <= len)
+			return size;
+	}
+	else if(len >= EDGE_HEADER_SIZE && !memcmp(data,EDGE_MAGIC,8))
+	{
+		/* lists written on a pipe do not know their size */
+		width = get_le(p + 12,4);
+		m = get_le(p + 24,8);
+		if((width == 4 || width == 8) && m <= (len - EDGE_HEADER_SIZE)/(2*width))
+			return EDGE_HEADER_SIZE + 2*width*m;
+	}
+	return len;
+}
+
+int ggen_is_container(const char *data, size_t len)
+{
+	return len >= 8 && !memcmp(data,CORPUS_MAGIC,8);
+}
+
+int ggen_container_index(const char *data, size_t len, uint64_t *count)
+{
+	const unsigned char *p = (const unsigned char *)data;
+	const unsigned char *t;
+	uint64_t i,index,off,size;
+
+	if(len < CORPUS_HEADER_SIZE + CORPUS_TRAILER_SIZE || !ggen_is_container(data,len))
+		goto invalid;
+	if(get_le(p + 8,4) != CORPUS_VERSION)
+	{
+		error("Unsupported binary corpus version %lu\n",(unsigned long)get_le(p + 8,4));
+		return 1;
+	}
+	t = p + len - CORPUS_TRAILER_SIZE;
+	if(memcmp(t + 16,CORPUS_END_MAGIC,8))
+		goto invalid;
+	*count = get_le(t,8);
+	index = get_le(t + 8,8);
+	if(index < CORPUS_HEADER_SIZE || index > len - CORPUS_TRAILER_SIZE
+			|| *count != (len - CORPUS_TRAILER_SIZE - index)/16
+			|| (len - CORPUS_TRAILER_SIZE - index) % 16)
+		goto invalid;
+
+	for(i = 0; i < *count; i++)
+	{
+		off = get_le(p + index + 16*i,8);
+		size = get_le(p + index + 16*i + 8,8);
+		if(off < CORPUS_HEADER_SIZE || off > index || size > index - off)
+			goto invalid;
+	}
+	return 0;
+invalid:
+	error("Invalid binary corpus\n");
+	return 1;
+}
+
+/* the container must have been checked by ggen_container_index() */
+int ggen_container_graph(const char *data, size_t len, uint64_t i,
+		uint64_t *offset, uint64_t *size)
+{
+	const unsigned char *p = (const unsigned char *)data;
+	uint64_t index;
+
+	index = get_le(p + len - CORPUS_TRAILER_SIZE + 8,8);
+	if(i >= get_le(p + len - CORPUS_TRAILER_SIZE,8))
+		return 1;
+	*offset = get_le(p + index + 16*i,8);
+	*size = get_le(p + index + 16*i + 8,8);
+	return 0;
+}
+
+int ggen_container_open(struct ggen_container *c, FILE *output)
+{
+	unsigned char header[CORPUS_HEADER_SIZE] = { 0 };
+
+	c->f = output;
+	c->pos = CORPUS_HEADER_SIZE;
+	c->index = NULL;
+	c->count = 0;
+	c->size = 0;
+	memcpy(header,CORPUS_MAGIC,8);
+	header[8] = CORPUS_VERSION;
+	return fwrite(header,1,CORPUS_HEADER_SIZE,output) != CORPUS_HEADER_SIZE;
+}
+
+int ggen_container_add(struct ggen_container *c, const char *data, size_t len)
+{
+	static const char zeros[8] = { 0 };
+	uint64_t *tmp;
+	size_t pad;
+
+	if(c->count == c->size)
+	{
+		c->size = c->size ? 2*c->size : 64;
+		tmp = realloc(c->index,2*c->size*sizeof(uint64_t));
+		if(tmp == NULL)
+			return 1;
+		c->index = tmp;
+	}
+	c->index[2*c->count] = c->pos;
+	c->index[2*c->count+1] = len;
+	c->count++;
+
+	pad = PAD8(len) - len;
+	if(fwrite(data,1,len,c->f) != len || fwrite(zeros,1,pad,c->f) != pad)
+		return 1;
+	c->pos += len + pad;
+	return 0;
+}
+
+int ggen_container_close(struct ggen_container *c)
+{
+	struct bin_out o;
+	uint64_t i;
+	int err;
+
+	o.f = c->f;
+	o.len = 0;
+	o.pos = 0;
+	o.err = 0;
+	o.buf = malloc(BIN_BUFFER_SIZE);
+	if(o.buf == NULL)
+	{
+		free(c->index);
+		return 1;
+	}
+
+	for(i = 0; i < 2*c->count; i++)
+		bin_le(&o,c->index[i],8);
+	bin_le(&o,c->count,8);
+	bin_le(&o,c->pos,8);
+	bin_mem(&o,CORPUS_END_MAGIC,8);
+	bin_flush(&o);
+
+	err = o.err || fflush(c->f) != 0;
+	free(o.buf);
+	free(c->index);
+	c->index = NULL;
+	return err;
+}
+
+/**********************************************************
+ * streaming
+ *********************************************************/
+
+/* attributes of one object, numbers are printed in buf */
+static unsigned long bin_view_row(const struct bin_view *cols, uint64_t ncols,
+		uint64_t skip, uint64_t i, struct ggen_field *row, char *buf)
+{
+	unsigned long n = 0;
+	uint64_t k;
+	char *s;
+
+	for(k = 0; k < ncols; k++)
+	{
+		if(k == skip)
+			continue;
+		row[2*n].s = cols[k].name;
+		row[2*n].len = strlen(cols[k].name);
+		if(cols[k].type == BIN_NUMERIC)
+		{
+			s = buf + GGEN_DEFAULT_NAME_SIZE*k;
+			d2s(get_double(cols[k].values + 8*i),s,GGEN_DEFAULT_NAME_SIZE);
+			row[2*n+1].s = s;
+		}
+		else
+			row[2*n+1].s = bin_view_string(&cols[k],i);
+		row[2*n+1].len = strlen(row[2*n+1].s);
+		n++;
+	}
+	return n;
+}
+
+static const struct ggen_field *bin_view_name(const struct bin_view *c, uint64_t i,
+		struct ggen_field *f)
+{
+	if(c == NULL)
+		return NULL;
+	f->s = bin_view_string(c,i);
+	f->len = strlen(f->s);
+	return f->len ? f : NULL;
+}
+
+/* edges in the order of the list, vertices known to be isolated after
+ * them */
+static int bin_stream_edges(const unsigned char *p, size_t len, struct ggen_stream *s)
+{
+	unsigned char *seen = NULL;
+	unsigned int width;
+	uint64_t i,n,m,from,to;
+	int err;
+
+	if(bin_edges_header(p,len,&width,&n,&m))
+		goto invalid;
+	p += EDGE_HEADER_SIZE;
+	if(n != UINT64_MAX)
+	{
+		seen = calloc(n/8 + 1,1);
+		if(seen == NULL)
+			return 1;
+	}
+
+	err = s->graph(s,NULL);
+	for(i = 0; !err && i < m; i++)
+	{
+		from = get_le(p + 2*width*i,width);
+		to = get_le(p + 2*width*i + width,width);
+		if(seen != NULL)
+		{
+			if(from >= n || to >= n)
+			{
+				free(seen);
+				goto invalid;
+			}
+			seen[from/8] |= 1 << (from % 8);
+			seen[to/8] |= 1 << (to % 8);
+		}
+		err = s->edge(s,from,NULL,to,NULL,0,NULL);
+	}
+	for(i = 0; !err && seen != NULL && i < n; i++)
+		if(!(seen[i/8] & (1 << (i % 8))))
+			err = s->vertex(s,i,NULL,0,NULL);
+	free(seen);
+	return err;
+invalid:
+	error("Invalid binary edge list\n");
+	return 1;
+}
+
+/* every vertex, then the edges in CSR order */
+int ggen_stream_binary(const char *data, size_t len, struct ggen_stream *s)
+{
+	const unsigned char *offsets,*heads;
+	struct bin_view *cols[3] = { NULL, NULL, NULL };
+	const struct bin_view *names = NULL;
+	struct ggen_field *row = NULL;
+	struct ggen_field name,tname;
+	struct bin_in in;
+	char *buf = NULL;
+	unsigned long nrow;
+	uint64_t i,k,n,m,off,next,head,size,gname,vname,max;
+	uint64_t ncols[3];
+	unsigned int width;
+	int err = 1;
+
+	if(ggen_is_container(data,len))
+	{
+		if(ggen_container_index(data,len,&i) || i == 0
+				|| ggen_container_graph(data,len,0,&off,&size))
+		{
+			error("Invalid binary corpus\n");
+			return 1;
+		}
+		return ggen_stream_binary(data + off,size,s);
+	}
+	if(len >= 8 && !memcmp(data,EDGE_MAGIC,8))
+		return bin_stream_edges((const unsigned char *)data,len,s);
+
+	if(bin_open(&in,data,len,&width,&n,&m,ncols,&offsets,&heads))
+		return 1;
+
+	max = 0;
+	for(k = 0; k < 3; k++)
+	{
+		cols[k] = malloc((ncols[k] + 1)*sizeof(struct bin_view));
+		if(cols[k] == NULL)
+			goto cleanup;
+		for(i = 0; i < ncols[k]; i++)
+			if(bin_view_column(&cols[k][i],&in,k == GRAPH_ATTR ? 1 : k == VERTEX_ATTR ? n : m,width))
+			{
+				error("Invalid binary graph attribute\n");
+				goto cleanup;
+			}
+		if(ncols[k] > max)
+			max = ncols[k];
+	}
+	row = malloc(2*(max + 1)*sizeof(struct ggen_field));
+	buf = malloc((max + 1)*GGEN_DEFAULT_NAME_SIZE);
+	if(row == NULL || buf == NULL)
+		goto cleanup;
+
+	/* names of the graph and of the vertices are not attributes */
+	gname = vname = UINT64_MAX;
+	for(i = 0; i < ncols[GRAPH_ATTR]; i++)
+		if(cols[GRAPH_ATTR][i].type == BIN_STRING
+				&& !strcmp(cols[GRAPH_ATTR][i].name,GGEN_GRAPH_NAME_ATTR))
+			gname = i;
+	for(i = 0; i < ncols[VERTEX_ATTR]; i++)
+		if(cols[VERTEX_ATTR][i].type == BIN_STRING
+				&& !strcmp(cols[VERTEX_ATTR][i].name,GGEN_VERTEX_NAME_ATTR))
+		{
+			vname = i;
+			names = &cols[VERTEX_ATTR][i];
+		}
+
+	if(s->graph(s,gname == UINT64_MAX ? NULL :
+				bin_view_name(&cols[GRAPH_ATTR][gname],0,&name)))
+		goto cleanup;
+	nrow = bin_view_row(cols[GRAPH_ATTR],ncols[GRAPH_ATTR],gname,0,row,buf);
+	for(i = 0; i < nrow; i++)
+		if(s->attr(s,GGEN_OBJECT_GRAPH,&row[2*i],&row[2*i+1]))
+			goto cleanup;
+
+	for(i = 0; i < n; i++)
+	{
+		nrow = bin_view_row(cols[VERTEX_ATTR],ncols[VERTEX_ATTR],vname,i,row,buf);
+		if(s->vertex(s,i,bin_view_name(names,i,&name),nrow,row))
+			goto cleanup;
+	}
+
+	off = 0;
+	for(i = 0; i < n; i++)
+	{
+		next = get_le(offsets + width*(i+1),width);
+		if(next < off || next > m)
+			goto invalid;
+		for(k = off; k < next; k++)
+		{
+			head = get_le(heads + width*k,width);
+			if(head >= n)
+				goto invalid;
+			nrow = bin_view_row(cols[EDGE_ATTR],ncols[EDGE_ATTR],UINT64_MAX,k,row,buf);
+			if(s->edge(s,i,bin_view_name(names,i,&name),head,
+						bin_view_name(names,head,&tname),nrow,row))
+				goto cleanup;
+		}
+		off = next;
+	}
+	err = 0;
+	goto cleanup;
+invalid:
+	error("Invalid binary graph\n");
+cleanup:
+	for(k = 0; k < 3; k++)
+		free(cols[k]);
+	free(row);
+	free(buf);
+	return err;
+}
+
+/* the writer needs the whole structure before writing anything: pass 0
+ * counts vertices, edges and values and finds the type of attributes,
+ * pass 1 gathers the strings of string attributes and pass 2 puts
+ * every value in place */
+struct bin_wcol {
+	struct ggen_field name;
+	/* default value, s is NULL if there is none */
+	struct ggen_field def;
+	int numeric;
+	uint64_t count;
+	/* objects given a value, and which vertices */
+	uint64_t nset;
+	unsigned char *set;
+	uint64_t setsize;
+	/* distinct strings */
+	struct ggen_field *strings;
+	uint64_t nstrings,size,nbytes;
+	uint64_t *table;
+	uint64_t tsize;
+	/* pass 2: values in the output */
+	unsigned char *values;
+};
+
+struct bin_stream {
+	struct ggen_stream s;
+	FILE *out;
+	unsigned int pass;
+	int err;
+	uint64_t n,m,size;
+	/* out-degrees, then where the next edge of each vertex goes */
+	uint64_t *start;
+	uint64_t nstart;
+	struct bin_wcol *cols[3];
+	unsigned long ncols[3];
+	long vname;
+	/* numbers to convert */
+	char *cbuf;
+	size_t csize;
+	/* pass 2 */
+	unsigned int width;
+	unsigned char *map,*heads;
+	FILE *tmp;
+};
+
+static void put_le(unsigned char *p, uint64_t v, unsigned int width)
+{
+	unsigned int i;
+
+	for(i = 0; i < width; i++)
+		p[i] = (v >> (8*i)) & 0xff;
+}
+
+static void put_double(unsigned char *p, double v)
+{
+	uint64_t bits;
+
+	memcpy(&bits,&v,sizeof(double));
+	put_le(p,bits,8);
+}
+
+static int bin_field_copy(struct ggen_field *to, const struct ggen_field *from)
+{
+	char *s;
+
+	s = malloc(from->len + 1);
+	if(s == NULL)
+		return 1;
+	memcpy(s,from->s,from->len);
+	s[from->len] = '\0';
+	to->s = s;
+	to->len = from->len;
+	return 0;
+}
+
+static int bin_field_eq(const struct ggen_field *a, const struct ggen_field *b)
+{
+	return a->len == b->len && !memcmp(a->s,b->s,a->len);
+}
+
+static double bin_stream_number(struct bin_stream *b, const struct ggen_field *f)
+{
+	char *tmp;
+
+	if(f->len >= b->csize)
+	{
+		tmp = realloc(b->cbuf,f->len + 1);
+		if(tmp == NULL)
+		{
+			b->err = 1;
+			return 0;
+		}
+		b->cbuf = tmp;
+		b->csize = f->len + 1;
+	}
+	memcpy(b->cbuf,f->s,f->len);
+	b->cbuf[f->len] = '\0';
+	return strtod(b->cbuf,NULL);
+}
+
+/* index of a string of the column, added to it if asked */
+static uint64_t bin_wcol_string(struct bin_wcol *c, const struct ggen_field *f, int add)
+{
+	uint64_t *table;
+	uint64_t i,h,mask;
+	void *tmp;
+
+	if(2*(c->nstrings + 1) > c->tsize)
+	{
+		if(!add)
+			return UINT64_MAX;
+		c->tsize = c->tsize ? 2*c->tsize : 16;
+		table = calloc(c->tsize,sizeof(uint64_t));
+		if(table == NULL)
+			return UINT64_MAX;
+		mask = c->tsize - 1;
+		for(i = 0; i < c->nstrings; i++)
+		{
+			h = bin_hash_mem(c->strings[i].s,c->strings[i].len) & mask;
+			while(table[h])
+				h = (h + 1) & mask;
+			table[h] = i + 1;
+		}
+		free(c->table);
+		c->table = table;
+	}
+
+	mask = c->tsize - 1;
+	h = bin_hash_mem(f->s,f->len) & mask;
+	while(c->table[h] && !bin_field_eq(&c->strings[c->table[h] - 1],f))
+		h = (h + 1) & mask;
+	if(c->table[h])
+		return c->table[h] - 1;
+	if(!add)
+		return UINT64_MAX;
+
+	if(c->nstrings == c->size)
+	{
+		c->size = c->size ? 2*c->size : 16;
+		tmp = realloc(c->strings,c->size*sizeof(struct ggen_field));
+		if(tmp == NULL)
+			return UINT64_MAX;
+		c->strings = tmp;
+	}
+	if(bin_field_copy(&c->strings[c->nstrings],f))
+		return UINT64_MAX;
+	c->nbytes += f->len + 1;
+	c->table[h] = ++c->nstrings;
+	return c->nstrings - 1;
+}
+
+static const struct ggen_field *bin_wcol_default(struct bin_wcol *c)
+{
+	static const struct ggen_field empty = { "", 0 };
+
+	return c->def.s != NULL ? &c->def : &empty;
+}
+
+static long bin_stream_column(struct bin_stream *b, enum ggen_object kind,
+		const struct ggen_field *name)
+{
+	struct bin_wcol *c;
+	unsigned long i;
+
+	for(i = 0; i < b->ncols[kind]; i++)
+		if(bin_field_eq(&b->cols[kind][i].name,name))
+			return i;
+	if(b->pass > 0)
+		return -1;
+
+	c = realloc(b->cols[kind],(b->ncols[kind] + 1)*sizeof(struct bin_wcol));
+	if(c == NULL)
+		return -1;
+	b->cols[kind] = c;
+	c += b->ncols[kind];
+	memset(c,0,sizeof(struct bin_wcol));
+	if(bin_field_copy(&c->name,name))
+		return -1;
+	c->numeric = 1;
+	c->count = kind == GGEN_OBJECT_GRAPH;
+	return b->ncols[kind]++;
+}
+
+static int bin_stream_grow(struct bin_stream *b, uint64_t id)
+{
+	uint64_t *tmp;
+	uint64_t size;
+
+	if(id >= b->n)
+		b->n = id + 1;
+	if(b->n + 1 <= b->nstart)
+		return 0;
+	for(size = b->nstart ? b->nstart : 1024; size < b->n + 1; size *= 2);
+	tmp = realloc(b->start,size*sizeof(uint64_t));
+	if(tmp == NULL)
+		return 1;
+	memset(tmp + b->nstart,0,(size - b->nstart)*sizeof(uint64_t));
+	b->start = tmp;
+	b->nstart = size;
+	return 0;
+}
+
+/* a value of an object, pos is where it goes in the column */
+static int bin_stream_value(struct bin_stream *b, struct bin_wcol *c, int vertex,
+		uint64_t pos, const struct ggen_field *value)
+{
+	unsigned char *tmp;
+	uint64_t i,size;
+
+	if(b->pass == 0)
+	{
+		if(c->numeric && !ggen_is_number(value->s,value->len))
+			c->numeric = 0;
+		if(!vertex)
+		{
+			c->nset++;
+			return 0;
+		}
+		if(pos/8 >= c->setsize)
+		{
+			for(size = c->setsize ? c->setsize : 1024; size <= pos/8; size *= 2);
+			tmp = realloc(c->set,size);
+			if(tmp == NULL)
+				return 1;
+			memset(tmp + c->setsize,0,size - c->setsize);
+			c->set = tmp;
+			c->setsize = size;
+		}
+		if(!(c->set[pos/8] & (1 << (pos % 8))))
+		{
+			c->set[pos/8] |= 1 << (pos % 8);
+			c->nset++;
+		}
+		return 0;
+	}
+	if(b->pass == 1)
+		return !c->numeric && bin_wcol_string(c,value,1) == UINT64_MAX;
+
+	if(c->numeric)
+	{
+		put_double(c->values + 8*pos,bin_stream_number(b,value));
+		return b->err;
+	}
+	i = bin_wcol_string(c,value,0);
+	if(i == UINT64_MAX)
+		return 1;
+	put_le(c->values + b->width*pos,i,b->width);
+	return 0;
+}
+
+static int bin_stream_name(struct bin_stream *b, uint64_t id, const struct ggen_field *name)
+{
+	struct ggen_field vname = { GGEN_VERTEX_NAME_ATTR, strlen(GGEN_VERTEX_NAME_ATTR) };
+
+	if(name == NULL)
+		return 0;
+	if(b->vname < 0)
+	{
+		b->vname = bin_stream_column(b,GGEN_OBJECT_VERTEX,&vname);
+		if(b->vname < 0)
+			return 1;
+		b->cols[GGEN_OBJECT_VERTEX][b->vname].numeric = 0;
+	}
+	return bin_stream_value(b,&b->cols[GGEN_OBJECT_VERTEX][b->vname],1,id,name);
+}
+
+static int bin_stream_attrs(struct bin_stream *b, enum ggen_object kind, uint64_t pos,
+		unsigned long nattrs, const struct ggen_field *attrs)
+{
+	unsigned long i;
+	long k;
+
+	for(i = 0; i < nattrs; i++)
+	{
+		k = bin_stream_column(b,kind,&attrs[2*i]);
+		if(k < 0)
+		{
+			if(b->pass == 0)
+				return 1;
+			continue;
+		}
+		if(bin_stream_value(b,&b->cols[kind][k],kind == GGEN_OBJECT_VERTEX,pos,&attrs[2*i+1]))
+			return 1;
+	}
+	return 0;
+}
+
+static int bin_stream_graph(struct ggen_stream *s, const struct ggen_field *name)
+{
+	struct bin_stream *b = (struct bin_stream *)s;
+	struct ggen_field gname = { GGEN_GRAPH_NAME_ATTR, strlen(GGEN_GRAPH_NAME_ATTR) };
+	struct ggen_field empty = { "", 0 };
+	long k;
+
+	if(b->err || b->pass > 0)
+		return b->err;
+	k = bin_stream_column(b,GGEN_OBJECT_GRAPH,&gname);
+	if(k < 0)
+		return 1;
+	b->cols[GGEN_OBJECT_GRAPH][k].numeric = 0;
+	return bin_field_copy(&b->cols[GGEN_OBJECT_GRAPH][k].def,name ? name : &empty);
+}
+
+/* graph attributes are columns holding only their default */
+static int bin_stream_attr(struct ggen_stream *s, enum ggen_object kind,
+		const struct ggen_field *name, const struct ggen_field *value)
+{
+	struct bin_stream *b = (struct bin_stream *)s;
+	struct bin_wcol *c;
+	long k;
+
+	if(b->pass > 0)
+		return 0;
+	k = bin_stream_column(b,kind,name);
+	if(k < 0)
+		return 1;
+	c = &b->cols[kind][k];
+	free((char *)c->def.s);
+	c->def.s = NULL;
+	if(kind == GGEN_OBJECT_GRAPH)
+		c->numeric = ggen_is_number(value->s,value->len);
+	return bin_field_copy(&c->def,value);
+}
+
+static int bin_stream_vertex(struct ggen_stream *s, unsigned long id,
+		const struct ggen_field *name, unsigned long nattrs,
+		const struct ggen_field *attrs)
+{
+	struct bin_stream *b = (struct bin_stream *)s;
+
+	if(b->pass == 0 && bin_stream_grow(b,id))
+		return 1;
+	return bin_stream_name(b,id,name) || bin_stream_attrs(b,GGEN_OBJECT_VERTEX,id,nattrs,attrs);
+}
+
+static int bin_stream_edge(struct ggen_stream *s, unsigned long from,
+		const struct ggen_field *fname, unsigned long to,
+		const struct ggen_field *tname, unsigned long nattrs,
+		const struct ggen_field *attrs)
+{
+	struct bin_stream *b = (struct bin_stream *)s;
+	uint64_t pos = 0;
+
+	if(b->pass == 0)
+	{
+		if(bin_stream_grow(b,from > to ? from : to))
+			return 1;
+		b->start[from + 1]++;
+		b->m++;
+	}
+	else if(b->pass == 2)
+	{
+		pos = b->start[from]++;
+		put_le(b->heads + b->width*pos,to,b->width);
+	}
+	return bin_stream_name(b,from,fname) || bin_stream_name(b,to,tname)
+		|| bin_stream_attrs(b,GGEN_OBJECT_EDGE,pos,nattrs,attrs);
+}
+
+/* outputs are seldom open for reading, which mapping them needs: the
+ * record is put together in a temporary file and copied */
+static int bin_stream_map(struct bin_stream *b)
+{
+	b->tmp = tmpfile();
+	if(b->tmp == NULL || ftruncate(fileno(b->tmp),b->size))
+		return 1;
+	b->map = mmap(NULL,b->size,PROT_READ | PROT_WRITE,MAP_SHARED,fileno(b->tmp),0);
+	if(b->map == MAP_FAILED)
+	{
+		b->map = NULL;
+		return 1;
+	}
+	return 0;
+}
+
+/* header of the column, its strings, and its values set to the default */
+static unsigned char *bin_stream_layout(struct bin_stream *b, struct bin_wcol *c,
+		unsigned char *p)
+{
+	uint64_t i,off,def;
+	double v;
+
+	put_le(p,c->numeric ? BIN_NUMERIC : BIN_STRING,4);
+	put_le(p + 4,c->name.len,4);
+	memcpy(p + 8,c->name.s,c->name.len);
+	p += 8 + PAD8(c->name.len + 1);
+	c->values = p;
+
+	if(c->numeric)
+	{
+		v = c->def.s != NULL ? strtod(c->def.s,NULL) : 0;
+		for(i = 0; i < c->count; i++)
+			put_double(p + 8*i,v);
+		return p + 8*c->count;
+	}
+
+	put_le(p,c->nstrings,8);
+	put_le(p + 8,c->nbytes,8);
+	p += 16;
+	c->values = p;
+	/* the output starts zeroed */
+	def = bin_wcol_string(c,bin_wcol_default(c),0);
+	if(def != UINT64_MAX && def != 0)
+		for(i = 0; i < c->count; i++)
+			put_le(p + b->width*i,def,b->width);
+	p += PAD8(b->width*c->count);
+
+	off = 0;
+	for(i = 0; i < c->nstrings; i++)
+	{
+		put_le(p + 8*i,off,8);
+		off += c->strings[i].len + 1;
+	}
+	put_le(p + 8*c->nstrings,off,8);
+	p += 8*(c->nstrings + 1);
+	for(i = 0; i < c->nstrings; i++)
+	{
+		memcpy(p,c->strings[i].s,c->strings[i].len);
+		p += c->strings[i].len + 1;
+	}
+	return p + (PAD8(c->nbytes) - c->nbytes);
+}
+
+static void bin_stream_pass(struct ggen_stream *s, unsigned int pass)
+{
+	struct bin_stream *b = (struct bin_stream *)s;
+	struct bin_wcol *c;
+	struct bin_column size;
+	unsigned char *p;
+	uint64_t i,k;
+
+	b->pass = pass;
+	if(b->err || pass == 0)
+		return;
+
+	if(pass == 1)
+	{
+		/* CSR offsets, and the type of attributes now that every
+		 * object is known */
+		for(i = 1; i <= b->n; i++)
+			b->start[i] += b->start[i-1];
+		for(k = GGEN_OBJECT_VERTEX; k <= GGEN_OBJECT_EDGE; k++)
+			for(i = 0; i < b->ncols[k]; i++)
+			{
+				c = &b->cols[k][i];
+				c->count = k == GGEN_OBJECT_VERTEX ? b->n : b->m;
+				c->numeric = c->numeric && c->count > 0 && (c->nset >= c->count
+						|| (c->def.s != NULL && ggen_is_number(c->def.s,c->def.len)));
+				free(c->set);
+				c->set = NULL;
+			}
+		return;
+	}
+
+	/* objects without a value take the default */
+	b->width = (b->n <= UINT32_MAX && b->m <= UINT32_MAX) ? 4 : 8;
+	b->size = BIN_HEADER_SIZE + PAD8(b->width*(b->n + 1)) + PAD8(b->width*b->m);
+	for(k = 0; k < 3; k++)
+		for(i = 0; i < b->ncols[k]; i++)
+		{
+			c = &b->cols[k][i];
+			if(!c->numeric && c->nset < c->count
+					&& bin_wcol_string(c,bin_wcol_default(c),1) == UINT64_MAX)
+			{
+				b->err = 1;
+				return;
+			}
+			size.name = c->name.s;
+			size.type = c->numeric ? BIN_NUMERIC : BIN_STRING;
+			size.count = c->count;
+			size.nstrings = c->nstrings;
+			size.nbytes = c->nbytes;
+			b->size += bin_column_size(&size,b->width);
+		}
+
+	if(bin_stream_map(b))
+	{
+		error("Cannot map the binary output\n");
+		b->err = 1;
+		return;
+	}
+	p = b->map;
+	memcpy(p,BIN_MAGIC,8);
+	put_le(p + 8,BIN_VERSION,4);
+	put_le(p + 12,b->width,4);
+	put_le(p + 16,b->size,8);
+	put_le(p + 24,b->n,8);
+	put_le(p + 32,b->m,8);
+	for(k = 0; k < 3; k++)
+		put_le(p + 40 + 4*k,b->ncols[k],4);
+	p += BIN_HEADER_SIZE;
+
+	for(i = 0; i <= b->n; i++)
+		put_le(p + b->width*i,b->start[i],b->width);
+	p += PAD8(b->width*(b->n + 1));
+	b->heads = p;
+	p += PAD8(b->width*b->m);
+
+	for(k = 0; k < 3; k++)
+		for(i = 0; i < b->ncols[k]; i++)
+			p = bin_stream_layout(b,&b->cols[k][i],p);
+	if(p != b->map + b->size)
+	{
+		error("Binary graph size mismatch, this is a bug\n");
+		b->err = 1;
+	}
+}
+
+static int bin_stream_close(struct ggen_stream *s)
+{
+	struct bin_stream *b = (struct bin_stream *)s;
+	struct bin_wcol *c;
+	uint64_t i,j,k;
+	int err = b->err;
+
+	if(b->map != NULL)
+	{
+		if(!err)
+		{
+			madvise(b->map,b->size,MADV_SEQUENTIAL);
+			err = fwrite(b->map,1,b->size,b->out) != b->size || fflush(b->out) != 0;
+		}
+		munmap(b->map,b->size);
+	}
+	else
+		err = 1;
+	if(b->tmp != NULL)
+		fclose(b->tmp);
+
+	for(k = 0; k < 3; k++)
+	{
+		for(i = 0; i < b->ncols[k]; i++)
+		{
+			c = &b->cols[k][i];
+			for(j = 0; j < c->nstrings; j++)
+				free((char *)c->strings[j].s);
+			free((char *)c->name.s);
+			free((char *)c->def.s);
+			free(c->set);
+			free(c->strings);
+			free(c->table);
+		}
+		free(b->cols[k]);
+	}
+	free(b->start);
+	free(b->cbuf);
+	free(b);
+	return err;
+}
+
+struct ggen_stream *ggen_stream_binary_writer(FILE *output)
+{
+	struct bin_stream *b;
+
+	b = calloc(1,sizeof(struct bin_stream));
+	if(b == NULL)
+		return NULL;
+	b->out = output;
+	b->vname = -1;
+	b->s.graph = bin_stream_graph;
+	b->s.attr = bin_stream_attr;
+	b->s.vertex = bin_stream_vertex;
+	b->s.edge = bin_stream_edge;
+	b->s.passes = 3;
+	b->s.pass = bin_stream_pass;
+	b->s.close = bin_stream_close;
+	return &b->s;
+}
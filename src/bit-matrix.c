@@ -0,0 +1,112 @@
+/* Copyright Swann Perarnau 2009
+ *
+ *   contributor(s) :
+ *
+ *   contact : Swann.Perarnau@imag.fr
+ *
+ * This software is a computer program whose purpose is to help the
+ * random generation of graph structures and adding various properties
+ * on those structures.
+ *
+ * This software is governed by the CeCILL  license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+/* GGen is a random graph generator :
+ * it provides means to generate a graph following a
+ * collection of methods found in the litterature.
+ *
+ * This is a research project founded by the MOAIS Team,
+ * INRIA, Grenoble Universities.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bit-matrix.h"
+
+int bit_matrix_init(struct bit_matrix *bm, unsigned long n)
+{
+	unsigned long v;
+
+	bm->n = n;
+	bm->offset = malloc((n+1)*sizeof(unsigned long));
+	if(bm->offset == NULL)
+		return 1;
+
+	bm->offset[0] = 0;
+	for(v = 0; v < n; v++)
+		bm->offset[v+1] = bm->offset[v] + BM_WORDS(v);
+
+	bm->words = calloc(bm->offset[n] ? bm->offset[n] : 1,sizeof(uint64_t));
+	if(bm->words == NULL)
+	{
+		free(bm->offset);
+		return 1;
+	}
+	return 0;
+}
+
+void bit_matrix_destroy(struct bit_matrix *bm)
+{
+	free(bm->words);
+	free(bm->offset);
+}
+
+void bit_matrix_set_prefix(struct bit_matrix *bm, unsigned long v, unsigned long len)
+{
+	uint64_t *col = bit_matrix_column(bm,v);
+
+	memset(col,0xff,(len/64)*sizeof(uint64_t));
+	if(len % 64)
+		col[len/64] |= (UINT64_C(1) << (len % 64)) - 1;
+}
+
+int bit_matrix_stream(struct bit_matrix *bm, struct edge_batch *b, const unsigned long *labels,
+		unsigned long first, unsigned long last)
+{
+	unsigned long u,v,w;
+	uint64_t *col;
+	uint64_t bits;
+	int err;
+
+	for(v = first; v < last; v++)
+	{
+		col = bit_matrix_column(bm,v);
+		for(w = 0; w < BM_WORDS(v); w++)
+		{
+			// walk the bits set, lowest first
+			for(bits = col[w]; bits; bits &= bits - 1)
+			{
+				u = w*64 + __builtin_ctzll(bits);
+				err = edge_batch_push(b,labels ? labels[u] : u,
+						labels ? labels[v] : v);
+				if(err) return err;
+			}
+		}
+	}
+	return 0;
+}
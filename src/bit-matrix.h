@@ -0,0 +1,108 @@
+/* Copyright Swann Perarnau 2009
+ *
+ *   contributor(s) :
+ *
+ *   contact : Swann.Perarnau@imag.fr
+ *
+ * This software is a computer program whose purpose is to help the
+ * random generation of graph structures and adding various properties
+ * on those structures.
+ *
+ * This software is governed by the CeCILL  license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+/* GGen is a random graph generator :
+ * it provides means to generate a graph following a
+ * collection of methods found in the litterature.
+ *
+ * This is a research project founded by the MOAIS Team,
+ * INRIA, Grenoble Universities.
+ */
+
+
+#ifndef BIT_MATRIX_H
+#define BIT_MATRIX_H 1
+
+#include <stdint.h>
+#include "ggen.h"
+#include "edge-sink.h"
+
+/* A bit matrix storing the strict upper triangle of the adjacency
+ * matrix of a DAG, using one bit per cell.
+ * Cells are stored by column: column v holds the possible predecessors
+ * u < v of the vertex v, on BM_WORDS(v) 64 bits words. Reading all the
+ * predecessors of a vertex is thus sequential, and rows of different
+ * vertices can be combined word by word.
+ * This is a private structure of the library, used by the generators
+ * whenever they need a dense representation of the graph.
+ */
+
+/* number of 64 bits words needed to store v bits */
+#define BM_WORDS(v) (((v)+63)/64)
+
+struct bit_matrix {
+	unsigned long n;	// number of vertices
+	unsigned long *offset;	// first word of each column
+	uint64_t *words;
+};
+
+/* allocates a bit matrix with all cells cleared.
+ * returns 0 on success */
+int bit_matrix_init(struct bit_matrix *bm, unsigned long n);
+
+void bit_matrix_destroy(struct bit_matrix *bm);
+
+/* sets the first len cells of column v, that is the edges
+ * from vertices [0,len) to v */
+void bit_matrix_set_prefix(struct bit_matrix *bm, unsigned long v, unsigned long len);
+
+/* pushes the edges of columns [first,last) to a batch, column by column.
+ * If labels is not NULL, vertex i is written as labels[i].
+ */
+int bit_matrix_stream(struct bit_matrix *bm, struct edge_batch *b, const unsigned long *labels,
+		unsigned long first, unsigned long last);
+
+static inline uint64_t *bit_matrix_column(struct bit_matrix *bm, unsigned long v)
+{
+	return bm->words + bm->offset[v];
+}
+
+static inline void bit_matrix_set(struct bit_matrix *bm, unsigned long u, unsigned long v)
+{
+	bit_matrix_column(bm,v)[u/64] |= UINT64_C(1) << (u % 64);
+}
+
+static inline void bit_matrix_clear(struct bit_matrix *bm, unsigned long u, unsigned long v)
+{
+	bit_matrix_column(bm,v)[u/64] &= ~(UINT64_C(1) << (u % 64));
+}
+
+static inline int bit_matrix_test(struct bit_matrix *bm, unsigned long u, unsigned long v)
+{
+	return (bit_matrix_column(bm,v)[u/64] >> (u % 64)) & 1;
+}
+
+#endif // BIT_MATRIX_H
@@ -43,6 +43,7 @@
  */
 
 #include <getopt.h>
+#include <math.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -61,8 +62,13 @@ const char* help_analyse[] = {
 	"out-degree           : gives the outdegree of each vertex\n",
 	"in-degree            : gives the indegree of each vertex\n",
 	"max-independent-set  : gives a maximum independent set of the graph\n",
+	"width                : gives a maximum antichain and a minimum chain cover\n",
 	"strong-components    : gives the number of strong components in the graph\n",
-	"maximal-paths        : gives the list of all maximal paths (ending by a sink)\n",
+	"maximal-paths <limit>: gives the list of all maximal paths (ending by a sink),\n",
+	"                       at most limit of them if it is not 0\n",
+	"path-count <mode>    : gives the number of maximal paths through each vertex,\n",
+	"                       mode is exact or log (approximate, for huge counts)\n",
+	"summary              : gives the main structural metrics, one per line\n",
 	NULL,
 };
 
@@ -90,76 +96,159 @@ static int cmd_mst(int argc, char **argv)
 	return err;
 }
 
-static int cmd_lp(int argc, char **argv)
+/* costs of the objects of type ptype from property pname, the vector
+ * is left uninitialized if pname is NULL */
+static int load_costs(igraph_vector_t *v, char *pname, int ptype)
 {
-	int err = 0;
-	unsigned long i = 0;
-	igraph_vector_t *lp = NULL;
+	int err,attr_type;
+	long i,size;
+	if(pname == NULL)
+		return 0;
+	attr_type = find_attribute(&g,ptype,pname);
+	if(attr_type == -1)
+	{
+		error("error: could not find property (%s)\n",pname);
+		return 1;
+	}
+	size = ptype == EDGE_PROPERTY ? igraph_ecount(&g) : igraph_vcount(&g);
+	err = igraph_vector_init(v,size);
+	if(err) return err;
+	for(i = 0; i < size; i++)
+	{
+		err = get_property(&g,&VECTOR(*v)[i],pname,attr_type,ptype,i);
+		if(err)
+		{
+			error("error: invalid cost in property (%s)\n",pname);
+			igraph_vector_destroy(v);
+			return err;
+		}
+	}
+	return 0;
+}
+
+static void print_path(igraph_vector_t *p)
+{
+	unsigned long i;
 	char name[GGEN_DEFAULT_NAME_SIZE];
 	char *s = NULL;
-	lp = ggen_analyze_longest_path(&g);
-	if(!lp) return 1;
-
-	s = ggen_vname(name,&g,(unsigned long)VECTOR(*lp)[0]);
-	fprintf(outfile,"%s",s==NULL?name:s);
-	for(i = 1; i < igraph_vector_size(lp); i++)
+	for(i = 0; i < igraph_vector_size(p); i++)
 	{
-		s = ggen_vname(name,&g,(unsigned long)VECTOR(*lp)[i]);
-		fprintf(outfile,",%s",s==NULL?name:s);
+		s = ggen_vname(name,&g,(unsigned long)VECTOR(*p)[i]);
+		fprintf(outfile,"%s%s",i?",":"",s==NULL?name:s);
 	}
 	fprintf(outfile,"\n");
-
-	igraph_vector_destroy(lp);
-	free(lp);
-	return 0;
 }
 
-static int cmd_out_degree(int argc, char **argv)
+/* without costs, each edge costs 1 and only the path is printed */
+static int cmd_lp(int argc, char **argv)
 {
 	int err = 0;
 	unsigned long i;
-	igraph_vector_t d;
+	igraph_vector_t *lp = NULL;
+	igraph_vector_t path,start,vcost,ecost,ones;
+	double length;
 	char name[GGEN_DEFAULT_NAME_SIZE];
 	char *s = NULL;
-	err = igraph_vector_init(&d,igraph_vcount(&g));
-	if(err) goto ret;
+	igraph_vector_t *vc = NULL, *ec = NULL;
 
-	err = igraph_degree(&g,&d,igraph_vss_all(),IGRAPH_OUT,0);
-	if(err) goto error;
+	if(vcostname == NULL && ecostname == NULL && !ask_start)
+	{
+		lp = ggen_analyze_longest_path(&g);
+		if(!lp) return 1;
+		print_path(lp);
+		igraph_vector_destroy(lp);
+		free(lp);
+		return 0;
+	}
 
-	for(i = 0; i < igraph_vcount(&g); i++)
+	err = load_costs(&vcost,vcostname,VERTEX_PROPERTY);
+	if(err) return 1;
+	if(vcostname != NULL)
+		vc = &vcost;
+
+	if(vcostname == NULL && ecostname == NULL)
 	{
-		s = ggen_vname(name,&g,i);
-		fprintf(outfile,"%s,%lu\n",s==NULL?name:s,(unsigned long)VECTOR(d)[i]);
+		err = igraph_vector_init(&ones,igraph_ecount(&g));
+		if(err) goto free_vc;
+		igraph_vector_fill(&ones,1.0);
+		ec = &ones;
 	}
-error:
-	igraph_vector_destroy(&d);
-ret:
-	return err;
+	else
+	{
+		err = load_costs(&ecost,ecostname,EDGE_PROPERTY);
+		if(err) goto free_vc;
+		if(ecostname != NULL)
+			ec = &ecost;
+	}
+
+	err = igraph_vector_init(&path,0);
+	if(err) goto free_ec;
+	err = igraph_vector_init(&start,0);
+	if(err) goto free_path;
+
+	err = ggen_analyze_critical_path(&g,vc,ec,&path,&start,&length);
+	if(err) goto free_start;
+
+	print_path(&path);
+	fprintf(outfile,"Critical path weight: %g\n",length);
+	if(ask_start)
+		for(i = 0; i < igraph_vcount(&g); i++)
+		{
+			s = ggen_vname(name,&g,i);
+			fprintf(outfile,"%s,%g\n",s==NULL?name:s,VECTOR(start)[i]);
+		}
+free_start:
+	igraph_vector_destroy(&start);
+free_path:
+	igraph_vector_destroy(&path);
+free_ec:
+	if(ec != NULL)
+		igraph_vector_destroy(ec);
+free_vc:
+	if(vc != NULL)
+		igraph_vector_destroy(vc);
+	return err != 0;
 }
 
-static int cmd_in_degree(int argc, char **argv)
+/* degrees are read from a dag view, self loops do not count */
+static uint32_t dag_degree(const struct ggen_dag *d, uint32_t v, int in)
 {
-	int err = 0;
-	unsigned long i = 0;
-	igraph_vector_t d;
+	uint32_t k,first,last,*adj,deg = 0;
+
+	first = in ? d->in_off[v] : d->out_off[v];
+	last = in ? d->in_off[v+1] : d->out_off[v+1];
+	adj = in ? d->in : d->out;
+	for(k = first; k < last; k++)
+		deg += adj[k] != v;
+	return deg;
+}
+
+static int print_degrees(int in)
+{
+	struct ggen_dag d;
+	uint32_t v;
 	char name[GGEN_DEFAULT_NAME_SIZE];
 	char *s = NULL;
-	err = igraph_vector_init(&d,igraph_vcount(&g));
-	if(err) goto ret;
 
-	err = igraph_degree(&g,&d,igraph_vss_all(),IGRAPH_IN,0);
-	if(err) goto error;
-
-	for(i = 0; i < igraph_vcount(&g); i++)
+	if(ggen_dag_init(&d,&g))
+		return 1;
+	for(v = 0; v < d.n; v++)
 	{
-		s = ggen_vname(name,&g,i);
-		fprintf(outfile,"%s,%lu\n",s==NULL?name:s,(unsigned long)VECTOR(d)[i]);
+		s = ggen_vname(name,&g,v);
+		fprintf(outfile,"%s,%lu\n",s==NULL?name:s,(unsigned long)dag_degree(&d,v,in));
 	}
-error:
-	igraph_vector_destroy(&d);
-ret:
-	return err;
+	ggen_dag_destroy(&d);
+	return 0;
+}
+
+static int cmd_out_degree(int argc, char **argv)
+{
+	return print_degrees(0);
+}
+
+static int cmd_in_degree(int argc, char **argv)
+{
+	return print_degrees(1);
 }
 
 static int cmd_max_indep_set(int argc, char **argv)
@@ -188,6 +277,200 @@ error:
 	igraph_vector_ptr_destroy(&l);
 	return err;
 }
+/* the width, a maximum antichain, then one chain of a minimum cover per
+ * line, its vertices in topological order */
+static int cmd_width(int argc, char **argv)
+{
+	int err;
+	struct ggen_dag d;
+	igraph_vector_t antichain,chain;
+	unsigned long width,c,i;
+	uint32_t v,*first = NULL,*next = NULL,*last = NULL;
+	char name[GGEN_DEFAULT_NAME_SIZE];
+	char *s = NULL;
+
+	if(ggen_dag_init(&d,&g))
+		return 1;
+	err = igraph_vector_init(&antichain,0);
+	if(err) goto free_dag;
+	err = igraph_vector_init(&chain,0);
+	if(err) goto free_anti;
+
+	err = ggen_dag_width(&d,&antichain,&chain,&width);
+	if(err) goto free_chain;
+
+	fprintf(outfile,"Width: %lu\n",width);
+	for(i = 0; i < igraph_vector_size(&antichain); i++)
+	{
+		s = ggen_vname(name,&g,(unsigned long)VECTOR(antichain)[i]);
+		fprintf(outfile,"%s%s",i?",":"",s==NULL?name:s);
+	}
+	fprintf(outfile,"\n");
+
+	/* link the vertices of each chain in topological order */
+	err = 1;
+	first = malloc((width + 1)*sizeof(uint32_t));
+	last = malloc((width + 1)*sizeof(uint32_t));
+	next = malloc((d.n + 1)*sizeof(uint32_t));
+	if(first == NULL || last == NULL || next == NULL)
+		goto free_lists;
+	for(c = 0; c < width; c++)
+		first[c] = UINT32_MAX;
+	for(i = 0; i < d.n; i++)
+	{
+		v = d.order[i];
+		c = VECTOR(chain)[v];
+		next[v] = UINT32_MAX;
+		if(first[c] == UINT32_MAX)
+			first[c] = v;
+		else
+			next[last[c]] = v;
+		last[c] = v;
+	}
+	for(c = 0; c < width; c++)
+	{
+		for(v = first[c]; v != UINT32_MAX; v = next[v])
+		{
+			s = ggen_vname(name,&g,v);
+			fprintf(outfile,"%s%s",v == first[c]?"":",",s==NULL?name:s);
+		}
+		fprintf(outfile,"\n");
+	}
+	err = 0;
+free_lists:
+	free(first);
+	free(last);
+	free(next);
+free_chain:
+	igraph_vector_destroy(&chain);
+free_anti:
+	igraph_vector_destroy(&antichain);
+free_dag:
+	ggen_dag_destroy(&d);
+	return err;
+}
+
+static int print_maximal_path(const uint32_t *path, uint32_t len, void *data)
+{
+	uint32_t i;
+	char name[GGEN_DEFAULT_NAME_SIZE];
+	char *s = NULL;
+	for(i = 0; i < len; i++)
+	{
+		s = ggen_vname(name,&g,path[i]);
+		fprintf(outfile,"%s%s",i?",":"",s==NULL?name:s);
+	}
+	fprintf(outfile,"\n");
+	return ferror(outfile);
+}
+
+static int cmd_maximal_paths(int argc, char **argv)
+{
+	int err;
+	struct ggen_dag d;
+	unsigned long limit,count;
+
+	err = s2ul(argv[0],&limit);
+	if(err)
+	{
+		error("Invalid limit of paths\n");
+		return 1;
+	}
+	if(ggen_dag_init(&d,&g))
+		return 1;
+	err = ggen_dag_maximal_paths(&d,limit,print_maximal_path,NULL,&count);
+	ggen_dag_destroy(&d);
+	if(!err)
+		info("%lu maximal paths written\n",count);
+	return err;
+}
+
+/* a count given by its natural logarithm, in scientific notation */
+static void print_log_count(const char *prefix, double l)
+{
+	double x,m;
+	/* no path at all, e.g. in an empty graph */
+	if(isinf(l) && l < 0)
+	{
+		fprintf(outfile,"%s0\n",prefix);
+		return;
+	}
+	x = l / M_LN10;
+	m = pow(10,x - floor(x));
+	x = floor(x);
+	if(m >= 9.9999995)
+	{
+		m /= 10;
+		x++;
+	}
+	fprintf(outfile,"%s%.6fe%+.0f\n",prefix,m,x);
+}
+
+/* the total first, then the count of each vertex */
+static int cmd_path_count(int argc, char **argv)
+{
+	int err = 1;
+	struct ggen_dag d;
+	igraph_vector_t lthrough;
+	igraph_strvector_t through;
+	double ltotal;
+	char *total = NULL;
+	unsigned long i;
+	char name[GGEN_DEFAULT_NAME_SIZE];
+	char *s = NULL;
+	int exact;
+
+	if(!strcmp(argv[0],"exact"))
+		exact = 1;
+	else if(!strcmp(argv[0],"log"))
+		exact = 0;
+	else
+	{
+		error("Unknown counting mode, must be exact or log\n");
+		return 1;
+	}
+	if(ggen_dag_init(&d,&g))
+		return 1;
+
+	if(exact)
+	{
+		if(igraph_strvector_init(&through,0))
+			goto free_dag;
+		err = ggen_dag_count_paths_exact(&d,&through,&total);
+		if(!err)
+		{
+			fprintf(outfile,"Nb of maximal paths: %s\n",total);
+			for(i = 0; i < d.n; i++)
+			{
+				s = ggen_vname(name,&g,i);
+				fprintf(outfile,"%s,%s\n",s==NULL?name:s,STR(through,i));
+			}
+		}
+		free(total);
+		igraph_strvector_destroy(&through);
+	}
+	else
+	{
+		if(igraph_vector_init(&lthrough,0))
+			goto free_dag;
+		err = ggen_dag_count_paths(&d,&lthrough,&ltotal);
+		if(!err)
+		{
+			print_log_count("Nb of maximal paths: ",ltotal);
+			for(i = 0; i < d.n; i++)
+			{
+				s = ggen_vname(name,&g,i);
+				fprintf(outfile,"%s,",s==NULL?name:s);
+				print_log_count("",VECTOR(lthrough)[i]);
+			}
+		}
+		igraph_vector_destroy(&lthrough);
+	}
+free_dag:
+	ggen_dag_destroy(&d);
+	return err;
+}
+
 static int cmd_strong_components(int argc, char **argv)
 {
 	int err;
@@ -199,14 +482,138 @@ static int cmd_strong_components(int argc, char **argv)
 	return 0;
 }
 
+/* count holds at least m + 1 counters, parallel edges make degrees
+ * larger than n */
+static void print_histogram(const char *key, const struct ggen_dag *d, int in,
+		unsigned long *count)
+{
+	uint32_t v,deg,max = 0;
+	int first = 1;
+	memset(count,0,(d->m + 1)*sizeof(unsigned long));
+	for(v = 0; v < d->n; v++)
+	{
+		deg = dag_degree(d,v,in);
+		count[deg]++;
+		if(deg > max)
+			max = deg;
+	}
+	fprintf(outfile,"%s:",key);
+	for(v = 0; v <= max && d->n > 0; v++)
+		if(count[v])
+		{
+			fprintf(outfile,"%s%lu:%lu",first?" ":",",(unsigned long)v,count[v]);
+			first = 0;
+		}
+	fprintf(outfile,"\n");
+}
+
+/* all the metrics from one view of the graph, as "key: value" lines.
+ * Work and critical path use the costs given, a vertex weighs one and
+ * an edge nothing otherwise */
+static int cmd_summary(int argc, char **argv)
+{
+	int err = 1;
+	struct ggen_dag d;
+	igraph_vector_t vcost,ecost;
+	igraph_vector_t *vc = NULL, *ec = NULL;
+	igraph_integer_t ncomp;
+	unsigned long *count = NULL,sources = 0,sinks = 0,depth = 0;
+	double work,cp,pairs;
+	uint32_t v;
+
+	if(ggen_dag_init(&d,&g))
+		return 1;
+	/* histograms and level widths share the counters */
+	count = calloc((d.n > d.m ? d.n : d.m) + 1,sizeof(unsigned long));
+	if(count == NULL)
+		goto free_dag;
+	if(load_costs(&vcost,vcostname,VERTEX_PROPERTY))
+		goto free_count;
+	if(vcostname != NULL)
+		vc = &vcost;
+	if(load_costs(&ecost,ecostname,EDGE_PROPERTY))
+		goto free_vc;
+	if(ecostname != NULL)
+		ec = &ecost;
+
+	for(v = 0; v < d.n; v++)
+	{
+		sources += dag_degree(&d,v,1) == 0;
+		sinks += dag_degree(&d,v,0) == 0;
+	}
+	pairs = (double)d.n*(d.n - 1)/2;
+	fprintf(outfile,"vertices: %lu\n",(unsigned long)d.n);
+	fprintf(outfile,"edges: %lu\n",(unsigned long)d.m);
+	fprintf(outfile,"density: %g\n",pairs > 0 ? d.m/pairs : 0);
+	fprintf(outfile,"sources: %lu\n",sources);
+	fprintf(outfile,"sinks: %lu\n",sinks);
+	print_histogram("in-degree",&d,1,count);
+	print_histogram("out-degree",&d,0,count);
+	fprintf(outfile,"acyclic: %s\n",d.is_dag ? "yes" : "no");
+
+	/* a dag has only trivial components, the others go through igraph */
+	if(d.is_dag)
+		ncomp = d.n;
+	else if(igraph_clusters(&g,NULL,NULL,&ncomp,IGRAPH_STRONG))
+		goto free_ec;
+	fprintf(outfile,"strong-components: %lu\n",(unsigned long)ncomp);
+
+	if(d.is_dag)
+	{
+		memset(count,0,(d.n + 1)*sizeof(unsigned long));
+		for(v = 0; v < d.n; v++)
+		{
+			count[d.level[v]]++;
+			if(d.level[v] + 1 > depth)
+				depth = d.level[v] + 1;
+		}
+		fprintf(outfile,"depth: %lu\n",depth);
+		fprintf(outfile,"level-widths:");
+		for(v = 0; v < depth; v++)
+			fprintf(outfile,"%s%lu",v?",":" ",count[v]);
+		fprintf(outfile,"\n");
+
+		/* vertices weigh one without costs of their own */
+		if(vc == NULL)
+		{
+			if(igraph_vector_init(&vcost,d.n))
+				goto free_ec;
+			igraph_vector_fill(&vcost,1.0);
+			vc = &vcost;
+		}
+		work = igraph_vector_sum(vc);
+		if(ggen_dag_critical_path(&d,vc,ec,NULL,NULL,&cp))
+			goto free_ec;
+		fprintf(outfile,"work: %g\n",work);
+		fprintf(outfile,"critical-path: %g\n",cp);
+		fprintf(outfile,"parallelism: %g\n",cp > 0 ? work/cp : 0);
+	}
+	err = 0;
+free_ec:
+	if(ec != NULL)
+		igraph_vector_destroy(ec);
+free_vc:
+	if(vc != NULL)
+		igraph_vector_destroy(vc);
+free_count:
+	free(count);
+free_dag:
+	ggen_dag_destroy(&d);
+	return err;
+}
+
 struct second_lvl_cmd  cmds_analyse[] = {
-	{ "nb-vertices", 0, NULL, cmd_nb_vertices },
-	{ "nb-edges", 0, NULL, cmd_nb_edges },
+	{ "nb-vertices", 0, NULL, cmd_nb_vertices, GGEN_ATTRS_ALL },
+	{ "nb-edges", 0, NULL, cmd_nb_edges, GGEN_ATTRS_ALL },
         { "mst", 0, NULL, cmd_mst },
-        { "lp", 0, NULL, cmd_lp },
-        { "out-degree", 0, NULL, cmd_out_degree },
-        { "in-degree", 0, NULL, cmd_in_degree },
-        { "max-independent-set", 0, NULL, cmd_max_indep_set },
-        { "strong-components", 0, NULL, cmd_strong_components },
+        { "lp", 0, NULL, cmd_lp, GGEN_ATTRS_OTHERS },
+        { "out-degree", 0, NULL, cmd_out_degree, GGEN_ATTRS_OTHERS },
+        { "in-degree", 0, NULL, cmd_in_degree, GGEN_ATTRS_OTHERS },
+        { "max-independent-set", 0, NULL, cmd_max_indep_set, GGEN_ATTRS_OTHERS },
+        { "width", 0, NULL, cmd_width, GGEN_ATTRS_OTHERS },
+        { "maximal-paths", 1, NULL, cmd_maximal_paths, GGEN_ATTRS_OTHERS },
+        { "path-count", 1, NULL, cmd_path_count, GGEN_ATTRS_OTHERS },
+        { "summary", 0, NULL, cmd_summary, GGEN_ATTRS_ALL },
+        { "strong-components", 0, NULL, cmd_strong_components, GGEN_ATTRS_ALL },
 	{ 0, 0, 0, 0},
 };
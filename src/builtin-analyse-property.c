@@ -115,7 +115,7 @@ int cmd_print(int argc, char **argv)
 {
 	unsigned long count;
 	int attr_type;
-	char n[GGEN_DEFAULT_NAME_SIZE];
+	char n[GGEN_DEFAULT_NAME_SIZE],v[GGEN_DEFAULT_NAME_SIZE];
 	char *s;
 	attr_type = find_attribute(&g,ptype,name);
 	if(attr_type == -1)
@@ -131,7 +131,11 @@ int cmd_print(int argc, char **argv)
 			if(attr_type == 0)
 				fprintf(outfile,"%lu,%s\n",i,EAS(&g,name,i));
 			else
-				fprintf(outfile,"%lu,%f\n",i,(double)EAN(&g,name,i));
+			{
+				/* numbers are printed as they were read */
+				d2s((double)EAN(&g,name,i),v,GGEN_DEFAULT_NAME_SIZE);
+				fprintf(outfile,"%lu,%s\n",i,v);
+			}
 		}
 	}
 	else if(ptype == VERTEX_PROPERTY)
@@ -143,7 +147,10 @@ int cmd_print(int argc, char **argv)
 			if(attr_type == 0)
 				fprintf(outfile,"%s,%s\n",s==NULL?n:s,VAS(&g,name,i));
 			else
-				fprintf(outfile,"%s,%f\n",s==NULL?n:s,(double)VAN(&g,name,i));
+			{
+				d2s((double)VAN(&g,name,i),v,GGEN_DEFAULT_NAME_SIZE);
+				fprintf(outfile,"%s,%s\n",s==NULL?n:s,v);
+			}
 		}
 	}
 	return 0;
@@ -283,8 +290,8 @@ free_h:
 }
 
 struct second_lvl_cmd cmds_analyse_prop[] = {
-	{ "print", 0, NULL, cmd_print },
-	{ "stats", 0, NULL, cmd_stats },
-	{ "hist", 3, NULL, cmd_hist },
+	{ "print", 0, NULL, cmd_print, GGEN_ATTRS_OTHERS },
+	{ "stats", 0, NULL, cmd_stats, GGEN_ATTRS_NAMES | GGEN_ATTRS_OTHERS },
+	{ "hist", 3, NULL, cmd_hist, GGEN_ATTRS_NAMES | GGEN_ATTRS_OTHERS },
 	{ 0, 0, 0, 0},
 };
@@ -0,0 +1,189 @@
+/* Copyright Swann Perarnau 2009
+ *
+ *   contributor(s) :
+ *
+ *   contact : Swann.Perarnau@imag.fr
+ *
+ * This software is a computer program whose purpose is to help the
+ * random generation of graph structures and adding various properties
+ * on those structures.
+ *
+ * This software is governed by the CeCILL  license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+/* GGen is a random graph generator :
+ * it provides means to generate a graph following a
+ * collection of methods found in the litterature.
+ *
+ * This is a research project founded by the MOAIS Team,
+ * INRIA, Grenoble Universities.
+ */
+
+/* Conversion between graph formats: the graph goes from the reader to
+ * the writer piece by piece and is never built, see struct ggen_stream
+ * in utils.h. The input itself is in memory, mapped when it is a regular
+ * file and read as a whole otherwise */
+#include "builtin.h"
+#include "ggen.h"
+#include "utils.h"
+
+const char* help_convert[] = {
+	"Commands:\n",
+	"dot                     : convert the input graph to DOT\n",
+	"edgelist                : convert the input graph to an edge list\n",
+	"binary                  : convert the input graph to a binary graph\n",
+	NULL,
+};
+
+/* checks that an input can be streamed, before writing anything */
+static int nop_graph(struct ggen_stream *s, const struct ggen_field *name)
+{
+	return 0;
+}
+
+static int nop_attr(struct ggen_stream *s, enum ggen_object kind,
+		const struct ggen_field *name, const struct ggen_field *value)
+{
+	return 0;
+}
+
+static int nop_vertex(struct ggen_stream *s, unsigned long id,
+		const struct ggen_field *name, unsigned long nattrs,
+		const struct ggen_field *attrs)
+{
+	return 0;
+}
+
+static int nop_edge(struct ggen_stream *s, unsigned long from,
+		const struct ggen_field *fname, unsigned long to,
+		const struct ggen_field *tname, unsigned long nattrs,
+		const struct ggen_field *attrs)
+{
+	return 0;
+}
+
+static struct ggen_stream nop = { nop_graph, nop_attr, nop_vertex, nop_edge, 1, NULL, NULL };
+
+static int convert(enum ggen_format to)
+{
+	struct ggen_corpus corpus;
+	struct ggen_stream *w = NULL;
+	int (*reader)(const char *,size_t,struct ggen_stream *);
+	char *data,*next;
+	size_t len,nlen;
+	unsigned int i;
+	int err;
+
+	err = ggen_corpus_open(&corpus,infile);
+	if(err)
+	{
+		error("Failed to read graph\n");
+		return err;
+	}
+	if(ggen_corpus_next(&corpus,&data,&len) != 1)
+	{
+		error("Empty graph input\n");
+		err = 1;
+		goto cleanup;
+	}
+	if(ggen_corpus_next(&corpus,&next,&nlen) == 1)
+		warning("Only the first graph of the input is converted\n");
+
+	if(corpus.format == GGEN_FORMAT_BINARY)
+		reader = ggen_stream_binary;
+	else if(corpus.format == GGEN_FORMAT_EDGELIST)
+		reader = ggen_stream_edgelist;
+	else
+	{
+		/* the native DOT reader does not know every DOT feature, check
+		 * before the writer gets anything */
+		reader = ggen_stream_dot;
+		err = reader(data,len,&nop);
+		if(err == GGEN_STREAM_UNSUPPORTED)
+			goto whole;
+		if(err)
+			goto cleanup;
+	}
+
+	if(to == GGEN_FORMAT_BINARY)
+		w = ggen_stream_binary_writer(outfile);
+	else if(to == GGEN_FORMAT_EDGELIST)
+		w = ggen_stream_edgelist_writer(outfile);
+	else
+		w = ggen_stream_dot_writer(outfile);
+	if(w == NULL)
+	{
+		err = 1;
+		goto cleanup;
+	}
+
+	for(i = 0; !err && i < w->passes; i++)
+	{
+		if(w->pass != NULL)
+			w->pass(w,i);
+		err = reader(data,len,w);
+	}
+	err = w->close(w) || err;
+	if(err)
+		error("Conversion failed\n");
+	goto cleanup;
+whole:
+	info("Input cannot be streamed, reading it as a whole\n");
+	err = ggen_read_graph_data(&g,corpus.format,data,len);
+	if(err)
+	{
+		error("Failed to read graph\n");
+		goto cleanup;
+	}
+	ggen_output_format = to;
+	err = ggen_write_graph(&g,outfile);
+	igraph_destroy(&g);
+cleanup:
+	ggen_corpus_close(&corpus);
+	return err;
+}
+
+static int cmd_dot(int argc, char** argv)
+{
+	return convert(GGEN_FORMAT_DOT);
+}
+
+static int cmd_edgelist(int argc, char** argv)
+{
+	return convert(GGEN_FORMAT_EDGELIST);
+}
+
+static int cmd_binary(int argc, char** argv)
+{
+	return convert(GGEN_FORMAT_BINARY);
+}
+
+struct second_lvl_cmd cmds_convert[] = {
+	{ "dot", 0, NULL, cmd_dot },
+	{ "edgelist", 0, NULL, cmd_edgelist },
+	{ "binary", 0, NULL, cmd_binary },
+	{ 0, 0, 0, 0},
+};
@@ -41,6 +41,7 @@
 * INRIA, Grenoble Universities.
 */
 
+#include <limits.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <sys/types.h>
@@ -50,6 +51,7 @@
 #include <getopt.h>
 #include <inttypes.h>
 #include <string.h>
+#include <pthread.h>
 
 #include "builtin.h"
 #include "ggen.h"
@@ -65,6 +67,7 @@ static int cmd_gnm(int argc, char** argv);
 static int cmd_lbl(int argc, char** argv);
 static int cmd_fifo(int argc, char** argv);
 static int cmd_ro(int argc, char** argv);
+static int cmd_ro_hasse(int argc, char** argv);
 
 /* help strings, there is a lot of them */
 const char* help_generate[] = {
@@ -73,7 +76,13 @@ const char* help_generate[] = {
 	"gnm                      : selection of edges in the complete graph\n",
 	"lbl                      : the classical layer by layer method\n",
 	"ro                       : generation of a DAG by intersection of total orders\n",
+	"ro-hasse                 : same as ro, but only keep the hasse diagram of the order\n",
 	"fifo                     : succeeding expension and contraction phases\n",
+	"With --threads, gnp and lbl split the work between threads. The graph then\n",
+	"only depends on the RNG, not on the number of threads.\n",
+	"With --count, several graphs are generated, each from its own RNG substream,\n",
+	"on the output or in the files named by --output-pattern. --threads then\n",
+	"spreads the graphs between threads.\n",
 	NULL
 };
 
@@ -115,6 +124,16 @@ static const char* ro_help[] = {
 	NULL
 };
 
+static const char* ro_hasse_help[] = {
+	"\nRandom Orders, Hasse diagram:\n",
+	"Build a partial order from the intersection of random total orders and transform its\n",
+	"transitive reduction (only the covering edges) into a DAG.\n",
+	"Arguments:\n",
+	"     - number of vertices    : how many vertices in this graph\n",
+	"     - number of total orders: how many total orders should we intersect\n",
+	NULL
+};
+
 static const char* fifo_help[] = {
 	"\nFan-in / Fan-out:\n",
 	"Build a graph by a succession of fan-in and fan-out steps.\n",
@@ -130,104 +149,374 @@ struct second_lvl_cmd cmds_generate[] = {
 	{ "gnm", 2, gnm_help, cmd_gnm },
 	{ "lbl", 3, lbl_help, cmd_lbl },
 	{ "ro", 2, ro_help, cmd_ro },
+	{ "ro-hasse", 2, ro_hasse_help, cmd_ro_hasse },
 	{ "fifo" , 3, fifo_help, cmd_fifo },
 	{ 0, 0, 0, 0},
 };
 
+/* Each command parses its arguments into a gen_args, and the actual
+ * generation goes through generate(), which either writes a single graph
+ * to the output, or runs a batch of --count graphs.
+ */
+struct gen_args {
+	int (*fn)(gsl_rng *r, struct gen_args *a, unsigned int threads, struct ggen_edge_sink *s);
+	unsigned long n;
+	unsigned long m;	// edges, layers, orders or max out degree
+	unsigned long k;	// max in degree
+	double p;
+};
+
+/* Batch mode:
+ * graph i is generated from its own RNG substream, derived from a seed
+ * drawn once from the main RNG, so that the batch is reproducible and
+ * does not depend on the number of threads. Each worker keeps its RNG
+ * and output buffer from one graph to the next.
+ * Without an output pattern, graphs are written one after the other on
+ * the output, in order.
+ */
+#define BATCH_BUFFER_SIZE (1 << 20)
+
+struct batch {
+	struct gen_args *args;
+	unsigned long seed;
+	unsigned long next;	// next graph to generate
+	unsigned long written;	// next graph to write on the output
+	int direct;		// a single worker writes directly on the output
+	int err;
+	pthread_mutex_t lock;
+	pthread_cond_t turn;
+};
+
+/* a pattern must hold a single int conversion, without length modifier:
+ * graph numbers are given as int */
+static int check_pattern(const char *pattern)
+{
+	const char *c;
+	int conv = 0;
+
+	for(c = pattern; *c; c++)
+	{
+		if(*c != '%')
+			continue;
+		if(*++c == '%')
+			continue;
+		c += strspn(c,"-+ #0");
+		c += strspn(c,"0123456789");
+		if(*c != 'd' && *c != 'i' && *c != 'u' && *c != 'x' && *c != 'X' && *c != 'o')
+			return 1;
+		conv++;
+	}
+	return conv != 1;
+}
+
+static int batch_write(struct batch *b, unsigned long i, const char *mem, size_t size, int err)
+{
+	pthread_mutex_lock(&b->lock);
+	while(b->written != i)
+		pthread_cond_wait(&b->turn,&b->lock);
+	if(!err && !b->err && fwrite(mem,1,size,outfile) != size)
+		err = 1;
+	b->written++;
+	pthread_cond_broadcast(&b->turn);
+	pthread_mutex_unlock(&b->lock);
+	return err;
+}
+
+static int batch_graph(struct batch *b, gsl_rng *r, char *buf, unsigned long i)
+{
+	struct ggen_edge_sink *s;
+	char fname[FILENAME_MAX];
+	char *mem = NULL;
+	size_t size = 0;
+	FILE *f;
+	int err = 1;
+
+	gsl_rng_set(r,ggen_rng_derive_seed(b->seed,i));
+	if(outpattern)
+	{
+		snprintf(fname,FILENAME_MAX,outpattern,(int)i);
+		f = ggen_fopen_output(fname);
+		if(f == NULL)
+			error("Failed to open file %s for output\n",fname);
+		else
+			setvbuf(f,buf,_IOFBF,BATCH_BUFFER_SIZE);
+	}
+	else if(b->direct)
+		f = outfile;
+	else
+		f = open_memstream(&mem,&size);
+
+	if(f != NULL)
+	{
+		s = ggen_output_sink(f);
+		if(s != NULL)
+		{
+			err = b->args->fn(r,b->args,0,s);
+			ggen_edge_sink_free(s);
+		}
+		if(f != outfile && fclose(f))
+			err = 1;
+	}
+	if(!outpattern && !b->direct)
+		err = batch_write(b,i,mem,size,err);
+	free(mem);
+	debug("Graph %lu generated\n",i);
+	return err;
+}
+
+static void *batch_worker(void *arg)
+{
+	struct batch *b = arg;
+	unsigned long i;
+	gsl_rng *r;
+	char *buf;
+	int err;
+
+	// on failure, the other workers take care of the graphs
+	r = gsl_rng_alloc(rng->type);
+	buf = malloc(BATCH_BUFFER_SIZE);
+	if(r == NULL || buf == NULL)
+		goto cleanup;
+
+	for(;;)
+	{
+		pthread_mutex_lock(&b->lock);
+		i = b->next++;
+		err = b->err;
+		pthread_mutex_unlock(&b->lock);
+		if(i >= ngraphs)
+			break;
+
+		// after an error, graphs are only skipped, in order
+		if(!err)
+			err = batch_graph(b,r,buf,i);
+		else if(!outpattern && !b->direct)
+			batch_write(b,i,NULL,0,err);
+
+		if(err)
+		{
+			pthread_mutex_lock(&b->lock);
+			b->err = 1;
+			pthread_mutex_unlock(&b->lock);
+		}
+	}
+cleanup:
+	free(buf);
+	if(r != NULL)
+		gsl_rng_free(r);
+	return NULL;
+}
+
+static int batch(struct gen_args *a)
+{
+	struct batch b;
+	pthread_t *tids;
+	unsigned long i,started,threads;
+
+	threads = nthreads ? nthreads : 1;
+	if(threads > ngraphs)
+		threads = ngraphs;
+
+	b.args = a;
+	b.seed = gsl_rng_get(rng);
+	b.next = 0;
+	b.written = 0;
+	b.direct = (threads == 1);
+	// each thread compresses its own files
+	if(threads > 1)
+		ggen_io_threads = 1;
+	b.err = 0;
+
+	tids = malloc(threads*sizeof(pthread_t));
+	if(tids == NULL)
+		return 1;
+	pthread_mutex_init(&b.lock,NULL);
+	pthread_cond_init(&b.turn,NULL);
+
+	info("Generating %lu graphs with %lu threads\n",ngraphs,threads);
+	// the current thread works too
+	for(started = 0; started < threads - 1; started++)
+		if(pthread_create(tids + started,NULL,batch_worker,&b))
+			break;
+	batch_worker(&b);
+	for(i = 0; i < started; i++)
+		pthread_join(tids[i],NULL);
+
+	// no worker could start at all
+	if(b.next < ngraphs)
+		b.err = 1;
+
+	pthread_cond_destroy(&b.turn);
+	pthread_mutex_destroy(&b.lock);
+	free(tids);
+	return b.err;
+}
+
+static int generate(struct gen_args *a)
+{
+	struct ggen_edge_sink *s;
+	int err;
+
+	if(ngraphs)
+	{
+		if(outpattern && check_pattern(outpattern))
+		{
+			error("Invalid output pattern, it must contain a single integer conversion\n");
+			return 1;
+		}
+		if(outpattern && ngraphs - 1 > INT_MAX)
+		{
+			error("Too many graphs for an output pattern\n");
+			return 1;
+		}
+		return batch(a);
+	}
+
+	// generated graphs are written to the output as they are built,
+	// instead of being stored in memory first
+	s = ggen_output_sink(outfile);
+	if(s == NULL)
+	{
+		error("Failed to create the output sink\n");
+		return 1;
+	}
+	err = a->fn(rng,a,nthreads,s);
+	ggen_edge_sink_free(s);
+	return err;
+}
+
+static int gen_gnp(gsl_rng *r, struct gen_args *a, unsigned int threads, struct ggen_edge_sink *s)
+{
+	if(threads)
+		return ggen_stream_erdos_gnp_parallel(r,a->n,a->p,threads,s);
+	return ggen_stream_erdos_gnp(r,a->n,a->p,s);
+}
+
+static int gen_gnm(gsl_rng *r, struct gen_args *a, unsigned int threads, struct ggen_edge_sink *s)
+{
+	return ggen_stream_erdos_gnm(r,a->n,a->m,s);
+}
+
+static int gen_lbl(gsl_rng *r, struct gen_args *a, unsigned int threads, struct ggen_edge_sink *s)
+{
+	if(threads)
+		return ggen_stream_erdos_lbl_parallel(r,a->n,a->p,a->m,threads,s);
+	return ggen_stream_erdos_lbl(r,a->n,a->p,a->m,s);
+}
+
+static int gen_ro(gsl_rng *r, struct gen_args *a, unsigned int threads, struct ggen_edge_sink *s)
+{
+	return ggen_stream_random_orders(r,a->n,a->m,s);
+}
+
+static int gen_ro_hasse(gsl_rng *r, struct gen_args *a, unsigned int threads, struct ggen_edge_sink *s)
+{
+	return ggen_stream_random_orders_hasse(r,a->n,a->m,s);
+}
+
+static int gen_fifo(gsl_rng *r, struct gen_args *a, unsigned int threads, struct ggen_edge_sink *s)
+{
+	return ggen_stream_fifo(r,a->n,a->m,a->k,s);
+}
+
 static int cmd_gnp(int argc, char** argv)
 {
+	struct gen_args a = { gen_gnp };
 	int err = 0;
-	unsigned long number;
-	double prob;
 
-	err = s2ul(argv[0],&number);
+	err = s2ul(argv[0],&a.n);
 	if(err) goto ret;
 
-	err = s2d(argv[1],&prob);
+	err = s2d(argv[1],&a.p);
 	if(err) goto ret;
 
-	g_p = ggen_generate_erdos_gnp(rng,number,prob);
-	if(g_p == NULL)
-		err = 1;
+	err = generate(&a);
 ret:
 	return err;
 }
 
 static int cmd_gnm(int argc, char** argv)
 {
+	struct gen_args a = { gen_gnm };
 	int err = 0;
-	unsigned long n,m;
 
-	err = s2ul(argv[0],&n);
+	err = s2ul(argv[0],&a.n);
 	if(err) goto ret;
 
-	err = s2ul(argv[1],&m);
+	err = s2ul(argv[1],&a.m);
 	if(err) goto ret;
 
-	g_p = ggen_generate_erdos_gnm(rng,n,m);
-	if(g_p == NULL)
-		err = 1;
+	err = generate(&a);
 ret:
 	return err;
 }
 
 static int cmd_lbl(int argc, char** argv)
 {
+	struct gen_args a = { gen_lbl };
 	int err = 0;
-	unsigned long n,l;
-	double p;
 
-	err = s2ul(argv[0],&n);
+	err = s2ul(argv[0],&a.n);
 	if(err) goto ret;
 
-	err = s2ul(argv[1],&l);
+	err = s2ul(argv[1],&a.m);
 	if(err) goto ret;
 
-	err = s2d(argv[2],&p);
+	err = s2d(argv[2],&a.p);
 	if(err) goto ret;
 
-	g_p = ggen_generate_erdos_lbl(rng,n,p,l);
-	if(g_p == NULL)
-		err = 1;
+	err = generate(&a);
 ret:
 	return err;
 }
 
 static int cmd_ro(int argc, char** argv)
 {
+	struct gen_args a = { gen_ro };
 	int err = 0;
-	unsigned long n,o;
 
-	err = s2ul(argv[0],&n);
+	err = s2ul(argv[0],&a.n);
 	if(err) goto ret;
 
-	err = s2ul(argv[1],&o);
+	err = s2ul(argv[1],&a.m);
 	if(err) goto ret;
 
-	g_p = ggen_generate_random_orders(rng,n,o);
-	if(g_p == NULL)
-		err = 1;
+	err = generate(&a);
+ret:
+	return err;
+}
+
+static int cmd_ro_hasse(int argc, char** argv)
+{
+	struct gen_args a = { gen_ro_hasse };
+	int err = 0;
+
+	err = s2ul(argv[0],&a.n);
+	if(err) goto ret;
+
+	err = s2ul(argv[1],&a.m);
+	if(err) goto ret;
+
+	err = generate(&a);
 ret:
 	return err;
 }
 
 static int cmd_fifo(int argc, char** argv)
 {
+	struct gen_args a = { gen_fifo };
 	int err = 0;
-	unsigned long n,i,o;
 
-	err = s2ul(argv[0],&n);
+	err = s2ul(argv[0],&a.n);
 	if(err) goto ret;
 
-	err = s2ul(argv[1],&o);
+	err = s2ul(argv[1],&a.m);
 	if(err) goto ret;
 
-	err = s2ul(argv[2],&i);
+	err = s2ul(argv[2],&a.k);
 	if(err) goto ret;
 
-	g_p = ggen_generate_fifo(rng,n,o,i);
-	if(g_p == NULL)
-		err = 1;
+	err = generate(&a);
 ret:
 	return err;
 }
@@ -49,7 +49,6 @@
  * passed globally from one function to the other.
  */
 extern igraph_t g;
-extern igraph_t *g_p;
 extern gsl_rng *rng;
 extern FILE *infile;
 extern FILE *outfile;
@@ -60,11 +59,28 @@ extern char *name;
 #define	GRAPH_PROPERTY 2
 extern int ptype;
 
+/* number of threads asked for, 0 if the option was not given */
+extern unsigned long nthreads;
+
+/* batch mode: number of graphs asked for (0 if the option was not
+ * given) and the printf pattern of their file names, if any */
+extern unsigned long ngraphs;
+extern char *outpattern;
+
+/* scheduling analyses: properties holding the vertex and edge costs
+ * (NULL if not given) and whether earliest starts are printed */
+extern char *vcostname;
+extern char *ecostname;
+extern int ask_start;
+
 struct second_lvl_cmd {
 	const char *name;
 	unsigned int nargs;
 	const char **help;
 	int (*fn)(int,char**);
+	/* attributes of the input graph the command does not use
+	 * (GGEN_ATTRS_* in utils.h), they are not read */
+	unsigned int unused;
 };
 
 /* flags tell us which options
@@ -72,10 +88,15 @@ struct second_lvl_cmd {
  */
 #define NEED_INPUT	1	// a graph needs read
 #define NEED_OUTPUT	2	// a graph needs output
-#define IS_GRAPH_P	4	// a graph pointer needs output
 #define NEED_RNG	8	// a rng must be initialized
 #define NEED_TYPE	16	// a type must be set
 #define NEED_NAME	32	// a name must be set
+#define NEED_THREADS	64	// work can be split between threads
+#define NEED_BATCH	128	// several graphs can be generated at once
+#define NEED_SINK	256	// graphs are written by an edge sink
+#define NEED_CORPUS	512	// each graph of a corpus goes through the command
+#define NEED_STREAM	1024	// the command reads the input itself
+#define NEED_COSTS	2048	// vertex and edge costs can be given
 
 struct first_lvl_cmd {
 	const char *name;
@@ -90,16 +111,22 @@ struct first_lvl_cmd {
 /* second lvl commands and help arrays are provided
  * by builtin-* files
  */
+/* property access shared by the analyses, see builtin-analyse-property.c */
+int find_attribute(igraph_t *ig,int attr_type,char *attr_name);
+int get_property(igraph_t *ig, double *dest, char *pname, int attr_type, int ptype, int index);
+
 extern const char *help_generate[];
 extern const char *help_analyse[];
 extern const char *help_transform[];
 extern const char *help_add_prop[];
 extern const char *help_analyse_prop[];
+extern const char *help_convert[];
 
 extern struct second_lvl_cmd cmds_generate[];
 extern struct second_lvl_cmd cmds_analyse[];
 extern struct second_lvl_cmd cmds_transform[];
 extern struct second_lvl_cmd cmds_add_prop[];
 extern struct second_lvl_cmd cmds_analyse_prop[];
+extern struct second_lvl_cmd cmds_convert[];
 
 #endif
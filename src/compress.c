@@ -0,0 +1,783 @@
+/* Copyright Swann Perarnau 2009
+*
+*   contact : Swann.Perarnau@imag.fr
+*
+* This software is a computer program whose purpose is to help the
+* random generation of graph structures and adding various properties
+* on those structures.
+*
+* This software is governed by the CeCILL  license under French law and
+* abiding by the rules of distribution of free software.  You can  use,
+* modify and/ or redistribute the software under the terms of the CeCILL
+* license as circulated by CEA, CNRS and INRIA at the following URL
+* "http://www.cecill.info".
+*
+* As a counterpart to the access to the source code and  rights to copy,
+* modify and redistribute granted by the license, users are provided only
+* with a limited warranty  and the software's author,  the holder of the
+* economic rights,  and the successive licensors  have only  limited
+* liability.
+*
+* In this respect, the user's attention is drawn to the risks associated
+* with loading,  using,  modifying and/or developing or reproducing the
+* software by the user in light of its specific status of free software,
+* that may mean  that it is complicated to manipulate,  and  that  also
+* therefore means  that it is reserved for developers  and  experienced
+* professionals having in-depth computer knowledge. Users are therefore
+* encouraged to load and test the software's suitability as regards their
+* requirements in conditions enabling the security of their systems and/or
+* data to be ensured and,  more generally, to use and operate it in the
+* same conditions as regards security.
+*
+* The fact that you are presently reading this means that you have had
+* knowledge of the CeCILL license and that you accept its terms.
+*/
+
+/* Compressed streams:
+ * graphs compress very well, so ggen reads and writes gzip and zstd
+ * streams itself. An input is recognized by its first bytes and is
+ * decompressed by a background thread, a few blocks ahead of the reader.
+ * Graph readers load the whole input before parsing it (see graph-io.c),
+ * so decompression overlaps with that copy, not with parsing.
+ * An output is compressed when its file name ends in .gz or .zst: it is
+ * cut in large blocks, compressed by several threads as independent gzip
+ * members or zstd frames (both formats accept several of them one after
+ * the other) and written in order.
+ */
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "config.h"
+#ifdef HAVE_LIBZ
+#include <zlib.h>
+#endif
+#ifdef HAVE_LIBZSTD
+#include <zstd.h>
+#endif
+
+#include "utils.h"
+#include "log.h"
+
+enum codec { CODEC_NONE, CODEC_GZIP, CODEC_ZSTD };
+
+static const char *codec_names[] = { "none", "gzip", "zstd" };
+
+/* size of a block of uncompressed data */
+#define BLOCK_SIZE (4 << 20)
+/* size of the reads of compressed data */
+#define READ_SIZE (1 << 20)
+/* decompressed blocks waiting for the reader */
+#define INPUT_BLOCKS 4
+/* blocks in flight per compressing thread */
+#define OUTPUT_BLOCKS 2
+
+static int codec_supported(enum codec c)
+{
+#ifdef HAVE_LIBZ
+	if(c == CODEC_GZIP)
+		return 1;
+#endif
+#ifdef HAVE_LIBZSTD
+	if(c == CODEC_ZSTD)
+		return 1;
+#endif
+	error("ggen was built without %s support\n",codec_names[c]);
+	return 0;
+}
+
+/**********************************************************
+ * reading
+ *********************************************************/
+
+struct zin {
+	FILE *f;
+	enum codec codec;
+	/* first bytes of the input, read to recognize it */
+	unsigned char head[4];
+	size_t nhead;
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	/* ring of decompressed blocks, count of them are full from first */
+	char *blocks[INPUT_BLOCKS];
+	size_t lens[INPUT_BLOCKS];
+	unsigned int first,count;
+	size_t pos;
+	int done,err,stop;
+};
+
+/* compressed data, starting with the bytes we already read */
+static size_t zin_read(struct zin *z, unsigned char *buf, size_t size)
+{
+	size_t n = 0;
+
+	if(z->nhead)
+	{
+		n = z->nhead < size ? z->nhead : size;
+		memcpy(buf,z->head,n);
+		memmove(z->head,z->head + n,z->nhead - n);
+		z->nhead -= n;
+	}
+	return n + fread(buf + n,1,size - n,z->f);
+}
+
+/* a free block to decompress into, NULL if the reader is gone */
+static char *zin_slot(struct zin *z)
+{
+	char *b = NULL;
+
+	pthread_mutex_lock(&z->lock);
+	while(z->count == INPUT_BLOCKS && !z->stop)
+		pthread_cond_wait(&z->cond,&z->lock);
+	if(!z->stop)
+		b = z->blocks[(z->first + z->count) % INPUT_BLOCKS];
+	pthread_mutex_unlock(&z->lock);
+	return b;
+}
+
+static void zin_publish(struct zin *z, size_t len)
+{
+	if(len == 0)
+		return;
+	pthread_mutex_lock(&z->lock);
+	z->lens[(z->first + z->count) % INPUT_BLOCKS] = len;
+	z->count++;
+	pthread_cond_broadcast(&z->cond);
+	pthread_mutex_unlock(&z->lock);
+}
+
+#ifdef HAVE_LIBZ
+static int zin_gzip(struct zin *z, unsigned char *in)
+{
+	z_stream s;
+	char *out;
+	int ret = Z_OK,err = 0,end = 0;
+
+	memset(&s,0,sizeof(s));
+	/* gzip or zlib header */
+	if(inflateInit2(&s,15 + 32) != Z_OK)
+		return 1;
+	while(!err && !end && (out = zin_slot(z)) != NULL)
+	{
+		s.next_out = (unsigned char *)out;
+		s.avail_out = BLOCK_SIZE;
+		while(s.avail_out > 0)
+		{
+			if(s.avail_in == 0)
+			{
+				s.next_in = in;
+				s.avail_in = zin_read(z,in,READ_SIZE);
+				if(s.avail_in == 0)
+				{
+					end = 1;
+					err = ret != Z_STREAM_END;
+					break;
+				}
+			}
+			/* another member follows */
+			if(ret == Z_STREAM_END)
+				inflateReset(&s);
+			ret = inflate(&s,Z_NO_FLUSH);
+			if(ret != Z_OK && ret != Z_STREAM_END)
+			{
+				err = 1;
+				break;
+			}
+		}
+		zin_publish(z,BLOCK_SIZE - s.avail_out);
+	}
+	inflateEnd(&s);
+	return err;
+}
+#endif
+
+#ifdef HAVE_LIBZSTD
+static int zin_zstd(struct zin *z, unsigned char *in)
+{
+	ZSTD_DStream *ds;
+	ZSTD_inBuffer ib = { in, 0, 0 };
+	ZSTD_outBuffer ob;
+	size_t ret = 0;
+	int err = 0,end = 0;
+
+	ds = ZSTD_createDStream();
+	if(ds == NULL)
+		return 1;
+	ZSTD_initDStream(ds);
+	while(!err && !end && (ob.dst = zin_slot(z)) != NULL)
+	{
+		ob.size = BLOCK_SIZE;
+		ob.pos = 0;
+		while(ob.pos < ob.size)
+		{
+			if(ib.pos == ib.size)
+			{
+				ib.pos = 0;
+				ib.size = zin_read(z,in,READ_SIZE);
+				if(ib.size == 0)
+				{
+					end = 1;
+					/* in the middle of a frame */
+					err = ret != 0;
+					break;
+				}
+			}
+			/* frames one after the other are decoded in turn */
+			ret = ZSTD_decompressStream(ds,&ob,&ib);
+			if(ZSTD_isError(ret))
+			{
+				err = 1;
+				break;
+			}
+		}
+		zin_publish(z,ob.pos);
+	}
+	ZSTD_freeDStream(ds);
+	return err;
+}
+#endif
+
+static void *zin_thread(void *arg)
+{
+	struct zin *z = arg;
+	unsigned char *in;
+	int err = 1;
+
+	in = malloc(READ_SIZE);
+	if(in != NULL)
+	{
+#ifdef HAVE_LIBZ
+		if(z->codec == CODEC_GZIP)
+			err = zin_gzip(z,in);
+#endif
+#ifdef HAVE_LIBZSTD
+		if(z->codec == CODEC_ZSTD)
+			err = zin_zstd(z,in);
+#endif
+		err = err || ferror(z->f);
+	}
+	free(in);
+	if(err)
+		error("Corrupted %s input\n",codec_names[z->codec]);
+
+	pthread_mutex_lock(&z->lock);
+	z->done = 1;
+	z->err = err;
+	pthread_cond_broadcast(&z->cond);
+	pthread_mutex_unlock(&z->lock);
+	return NULL;
+}
+
+static ssize_t zin_cookie_read(void *cookie, char *buf, size_t size)
+{
+	struct zin *z = cookie;
+	size_t n;
+
+	pthread_mutex_lock(&z->lock);
+	while(z->count == 0 && !z->done)
+		pthread_cond_wait(&z->cond,&z->lock);
+	if(z->count == 0)
+	{
+		pthread_mutex_unlock(&z->lock);
+		return z->err ? -1 : 0;
+	}
+	pthread_mutex_unlock(&z->lock);
+
+	/* the first block is ours until we give it back */
+	n = z->lens[z->first] - z->pos;
+	if(n > size)
+		n = size;
+	memcpy(buf,z->blocks[z->first] + z->pos,n);
+	z->pos += n;
+
+	if(z->pos == z->lens[z->first])
+	{
+		pthread_mutex_lock(&z->lock);
+		z->first = (z->first + 1) % INPUT_BLOCKS;
+		z->count--;
+		z->pos = 0;
+		pthread_cond_broadcast(&z->cond);
+		pthread_mutex_unlock(&z->lock);
+	}
+	return n;
+}
+
+static void zin_free(struct zin *z)
+{
+	unsigned int i;
+
+	for(i = 0; i < INPUT_BLOCKS; i++)
+		free(z->blocks[i]);
+	pthread_mutex_destroy(&z->lock);
+	pthread_cond_destroy(&z->cond);
+	free(z);
+}
+
+static int zin_cookie_close(void *cookie)
+{
+	struct zin *z = cookie;
+	int err;
+
+	/* the decompressing thread might wait for a free block */
+	pthread_mutex_lock(&z->lock);
+	z->stop = 1;
+	pthread_cond_broadcast(&z->cond);
+	pthread_mutex_unlock(&z->lock);
+	if(z->codec != CODEC_NONE)
+		pthread_join(z->thread,NULL);
+
+	err = fclose(z->f);
+	zin_free(z);
+	return err;
+}
+
+/* plain input we had to read the first bytes of */
+static ssize_t zin_plain_read(void *cookie, char *buf, size_t size)
+{
+	return zin_read(cookie,(unsigned char *)buf,size);
+}
+
+static enum codec codec_magic(const unsigned char *p, size_t len)
+{
+	if(len >= 2 && p[0] == 0x1f && p[1] == 0x8b)
+		return CODEC_GZIP;
+	if(len >= 4 && p[0] == 0x28 && p[1] == 0xb5 && p[2] == 0x2f && p[3] == 0xfd)
+		return CODEC_ZSTD;
+	return CODEC_NONE;
+}
+
+/* f is left open on failure */
+FILE *ggen_open_input(FILE *f)
+{
+	cookie_io_functions_t fns = { NULL, NULL, NULL, zin_cookie_close };
+	struct zin *z;
+	FILE *r;
+	unsigned int i;
+	int c;
+
+	z = calloc(1,sizeof(struct zin));
+	if(z == NULL)
+		return NULL;
+	z->f = f;
+
+	/* a file is read again from the start, so that it can still be
+	 * mapped. Other inputs are only looked at if they might be
+	 * compressed, no text starts with those bytes */
+	if(ftello(f) == 0 && fseeko(f,0,SEEK_CUR) == 0)
+	{
+		z->nhead = fread(z->head,1,sizeof(z->head),f);
+		z->codec = codec_magic(z->head,z->nhead);
+		if(fseeko(f,0,SEEK_SET))
+			goto error;
+		if(z->codec == CODEC_NONE)
+		{
+			free(z);
+			return f;
+		}
+		z->nhead = 0;
+	}
+	else
+	{
+		c = getc(f);
+		if(c != 0x1f && c != 0x28)
+		{
+			free(z);
+			if(c != EOF)
+				ungetc(c,f);
+			return f;
+		}
+		z->head[0] = c;
+		z->nhead = 1 + fread(z->head + 1,1,sizeof(z->head) - 1,f);
+		z->codec = codec_magic(z->head,z->nhead);
+	}
+
+	pthread_mutex_init(&z->lock,NULL);
+	pthread_cond_init(&z->cond,NULL);
+	if(z->codec == CODEC_NONE)
+	{
+		fns.read = zin_plain_read;
+		goto open;
+	}
+
+	if(!codec_supported(z->codec))
+		goto error_l;
+	info("Decompressing %s input\n",codec_names[z->codec]);
+	for(i = 0; i < INPUT_BLOCKS; i++)
+	{
+		z->blocks[i] = malloc(BLOCK_SIZE);
+		if(z->blocks[i] == NULL)
+			goto error_l;
+	}
+	if(pthread_create(&z->thread,NULL,zin_thread,z))
+		goto error_l;
+	fns.read = zin_cookie_read;
+open:
+	r = fopencookie(z,"r",fns);
+	if(r != NULL)
+		return r;
+	if(z->codec != CODEC_NONE)
+	{
+		pthread_mutex_lock(&z->lock);
+		z->stop = 1;
+		pthread_cond_broadcast(&z->cond);
+		pthread_mutex_unlock(&z->lock);
+		pthread_join(z->thread,NULL);
+	}
+error_l:
+	zin_free(z);
+	return NULL;
+error:
+	free(z);
+	return NULL;
+}
+
+/**********************************************************
+ * writing
+ *********************************************************/
+
+/* block i goes through slot i % nslots: filled by the writer of the
+ * stream, compressed by any thread, written by the thread that compressed
+ * it once block i-1 is written */
+struct zout_slot {
+	char *data;
+	size_t len;
+	char *out;
+	size_t outsize;
+};
+
+struct zout {
+	FILE *f;
+	enum codec codec;
+	pthread_t *threads;
+	unsigned long nthreads;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	struct zout_slot *slots;
+	unsigned long nslots;
+	/* blocks filled, taken by a thread, written */
+	unsigned long filled,taken,written;
+	/* block being filled */
+	char *cur;
+	size_t len;
+	int closing,err;
+};
+
+/* compress a slot as a complete gzip member or zstd frame */
+static int zout_compress(struct zout *z, struct zout_slot *s, void *ctx, size_t *outlen)
+{
+	size_t bound = 0;
+	char *tmp;
+
+#ifdef HAVE_LIBZ
+	z_stream *zs = ctx;
+	if(z->codec == CODEC_GZIP)
+	{
+		deflateReset(zs);
+		bound = deflateBound(zs,s->len);
+	}
+#endif
+#ifdef HAVE_LIBZSTD
+	if(z->codec == CODEC_ZSTD)
+		bound = ZSTD_compressBound(s->len);
+#endif
+	if(bound > s->outsize)
+	{
+		tmp = realloc(s->out,bound);
+		if(tmp == NULL)
+			return 1;
+		s->out = tmp;
+		s->outsize = bound;
+	}
+
+#ifdef HAVE_LIBZ
+	if(z->codec == CODEC_GZIP)
+	{
+		zs->next_in = (unsigned char *)s->data;
+		zs->avail_in = s->len;
+		zs->next_out = (unsigned char *)s->out;
+		zs->avail_out = s->outsize;
+		if(deflate(zs,Z_FINISH) != Z_STREAM_END)
+			return 1;
+		*outlen = s->outsize - zs->avail_out;
+		return 0;
+	}
+#endif
+#ifdef HAVE_LIBZSTD
+	if(z->codec == CODEC_ZSTD)
+	{
+		*outlen = ZSTD_compressCCtx(ctx,s->out,s->outsize,s->data,s->len,ZSTD_CLEVEL_DEFAULT);
+		return ZSTD_isError(*outlen);
+	}
+#endif
+	return 1;
+}
+
+/* per thread compression state */
+static void *zout_ctx_new(struct zout *z)
+{
+#ifdef HAVE_LIBZ
+	z_stream *zs;
+	if(z->codec == CODEC_GZIP)
+	{
+		zs = calloc(1,sizeof(z_stream));
+		/* gzip header */
+		if(zs != NULL && deflateInit2(zs,Z_DEFAULT_COMPRESSION,Z_DEFLATED,15 + 16,8,
+					Z_DEFAULT_STRATEGY) != Z_OK)
+		{
+			free(zs);
+			zs = NULL;
+		}
+		return zs;
+	}
+#endif
+#ifdef HAVE_LIBZSTD
+	if(z->codec == CODEC_ZSTD)
+		return ZSTD_createCCtx();
+#endif
+	return NULL;
+}
+
+static void zout_ctx_free(struct zout *z, void *ctx)
+{
+	if(ctx == NULL)
+		return;
+#ifdef HAVE_LIBZ
+	if(z->codec == CODEC_GZIP)
+	{
+		deflateEnd(ctx);
+		free(ctx);
+	}
+#endif
+#ifdef HAVE_LIBZSTD
+	if(z->codec == CODEC_ZSTD)
+		ZSTD_freeCCtx(ctx);
+#endif
+}
+
+static void *zout_thread(void *arg)
+{
+	struct zout *z = arg;
+	struct zout_slot *s;
+	unsigned long i;
+	size_t outlen = 0;
+	void *ctx;
+	int err;
+
+	ctx = zout_ctx_new(z);
+	pthread_mutex_lock(&z->lock);
+	for(;;)
+	{
+		while(z->taken == z->filled && !z->closing)
+			pthread_cond_wait(&z->cond,&z->lock);
+		if(z->taken == z->filled)
+			break;
+		i = z->taken++;
+		s = &z->slots[i % z->nslots];
+		pthread_mutex_unlock(&z->lock);
+
+		err = ctx == NULL || zout_compress(z,s,ctx,&outlen);
+
+		pthread_mutex_lock(&z->lock);
+		while(z->written != i)
+			pthread_cond_wait(&z->cond,&z->lock);
+		pthread_mutex_unlock(&z->lock);
+
+		/* our turn, nobody else writes */
+		if(!err && !z->err)
+			err = fwrite(s->out,1,outlen,z->f) != outlen;
+
+		pthread_mutex_lock(&z->lock);
+		z->err = z->err || err;
+		z->written++;
+		pthread_cond_broadcast(&z->cond);
+	}
+	pthread_mutex_unlock(&z->lock);
+	zout_ctx_free(z,ctx);
+	return NULL;
+}
+
+/* stop the threads once every block is written */
+static void zout_stop(struct zout *z)
+{
+	unsigned long i;
+
+	pthread_mutex_lock(&z->lock);
+	z->closing = 1;
+	pthread_cond_broadcast(&z->cond);
+	pthread_mutex_unlock(&z->lock);
+	for(i = 0; i < z->nthreads; i++)
+		pthread_join(z->threads[i],NULL);
+	z->nthreads = 0;
+}
+
+/* threads are only started for outputs bigger than a block */
+static int zout_start(struct zout *z)
+{
+	unsigned long i,n;
+
+	n = ggen_io_threads ? ggen_io_threads : 1;
+	z->nslots = OUTPUT_BLOCKS*n;
+	z->threads = malloc(n*sizeof(pthread_t));
+	z->slots = calloc(z->nslots,sizeof(struct zout_slot));
+	if(z->threads == NULL || z->slots == NULL)
+		return 1;
+	for(i = 0; i < n; i++)
+	{
+		if(pthread_create(&z->threads[i],NULL,zout_thread,z))
+		{
+			zout_stop(z);
+			return 1;
+		}
+		z->nthreads++;
+	}
+	info("Compressing output with %s on %lu threads\n",codec_names[z->codec],n);
+	return 0;
+}
+
+/* hand the current block to the compressing threads */
+static int zout_submit(struct zout *z)
+{
+	struct zout_slot *s;
+	char *tmp;
+
+	if(z->nthreads == 0 && zout_start(z))
+		return 1;
+
+	pthread_mutex_lock(&z->lock);
+	while(z->filled - z->written == z->nslots)
+		pthread_cond_wait(&z->cond,&z->lock);
+	s = &z->slots[z->filled % z->nslots];
+	pthread_mutex_unlock(&z->lock);
+
+	/* the slot is free: swap buffers */
+	tmp = s->data != NULL ? s->data : malloc(BLOCK_SIZE);
+	if(tmp == NULL)
+		return 1;
+	s->data = z->cur;
+	s->len = z->len;
+	z->cur = tmp;
+	z->len = 0;
+
+	pthread_mutex_lock(&z->lock);
+	z->filled++;
+	pthread_cond_broadcast(&z->cond);
+	pthread_mutex_unlock(&z->lock);
+	return z->err;
+}
+
+static ssize_t zout_cookie_write(void *cookie, const char *buf, size_t size)
+{
+	struct zout *z = cookie;
+	size_t n,done = 0;
+
+	while(done < size)
+	{
+		n = BLOCK_SIZE - z->len;
+		if(n > size - done)
+			n = size - done;
+		memcpy(z->cur + z->len,buf + done,n);
+		z->len += n;
+		done += n;
+		if(z->len == BLOCK_SIZE && zout_submit(z))
+			return -1;
+	}
+	return size;
+}
+
+static void zout_free(struct zout *z)
+{
+	unsigned long i;
+
+	for(i = 0; z->slots != NULL && i < z->nslots; i++)
+	{
+		free(z->slots[i].data);
+		free(z->slots[i].out);
+	}
+	free(z->slots);
+	free(z->threads);
+	free(z->cur);
+	pthread_mutex_destroy(&z->lock);
+	pthread_cond_destroy(&z->cond);
+	free(z);
+}
+
+static int zout_cookie_close(void *cookie)
+{
+	struct zout *z = cookie;
+	struct zout_slot s;
+	size_t outlen;
+	void *ctx;
+	int err = 0;
+
+	if(z->nthreads == 0 && !z->err)
+	{
+		/* a single block, compressed here. Even an empty output is a
+		 * valid stream */
+		memset(&s,0,sizeof(s));
+		s.data = z->cur;
+		s.len = z->len;
+		ctx = zout_ctx_new(z);
+		err = ctx == NULL || zout_compress(z,&s,ctx,&outlen)
+			|| fwrite(s.out,1,outlen,z->f) != outlen;
+		zout_ctx_free(z,ctx);
+		free(s.out);
+	}
+	else if(z->len > 0)
+		err = zout_submit(z);
+	zout_stop(z);
+	err = err || z->err;
+	if(err)
+		error("Failed to write %s output\n",codec_names[z->codec]);
+	err = fclose(z->f) || err;
+	zout_free(z);
+	return err ? EOF : 0;
+}
+
+static enum codec codec_extension(const char *path)
+{
+	size_t len = strlen(path);
+
+	if(len > 3 && !strcmp(path + len - 3,".gz"))
+		return CODEC_GZIP;
+	if(len > 4 && !strcmp(path + len - 4,".zst"))
+		return CODEC_ZSTD;
+	return CODEC_NONE;
+}
+
+FILE *ggen_fopen_output(const char *path)
+{
+	cookie_io_functions_t fns = { NULL, zout_cookie_write, NULL, zout_cookie_close };
+	struct zout *z;
+	enum codec codec;
+	FILE *f,*r;
+
+	codec = codec_extension(path);
+	if(codec != CODEC_NONE && !codec_supported(codec))
+		return NULL;
+	f = fopen(path,"w");
+	if(f == NULL || codec == CODEC_NONE)
+		return f;
+
+	z = calloc(1,sizeof(struct zout));
+	if(z == NULL)
+		goto error;
+	z->f = f;
+	z->codec = codec;
+	pthread_mutex_init(&z->lock,NULL);
+	pthread_cond_init(&z->cond,NULL);
+	z->cur = malloc(BLOCK_SIZE);
+	if(z->cur != NULL)
+	{
+		r = fopencookie(z,"w",fns);
+		if(r != NULL)
+			return r;
+	}
+	zout_free(z);
+error:
+	fclose(f);
+	return NULL;
+}
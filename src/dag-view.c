@@ -0,0 +1,185 @@
+/* Copyright Swann Perarnau 2009
+ *
+ *   contributor(s) :
+ *
+ *   contact : Swann.Perarnau@imag.fr
+ *
+ * This software is a computer program whose purpose is to help the
+ * random generation of graph structures and adding various properties
+ * on those structures.
+ *
+ * This software is governed by the CeCILL  license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+/* GGen is a random graph generator :
+ * it provides means to generate a graph following a
+ * collection of methods found in the litterature.
+ *
+ * This is a research project founded by the MOAIS Team,
+ * INRIA, Grenoble Universities.
+ */
+
+/* Immutable view of a graph for analyses: both adjacencies in compressed
+ * sparse row form, a topological order and the level of each vertex, all
+ * computed once so that analyses walk plain arrays in order.
+ */
+#include "ggen.h"
+#include <stdlib.h>
+
+/* sorts the m edges (tails[i],heads[i]) by tail into off/adj/eid,
+ * keeping the edge order otherwise */
+static void dag_csr(uint32_t n, uint32_t m, const uint32_t *tails,
+		const uint32_t *heads, uint32_t *off, uint32_t *adj, uint32_t *eid)
+{
+	uint32_t i,k;
+	for(i = 0; i <= n; i++)
+		off[i] = 0;
+	for(i = 0; i < m; i++)
+		off[tails[i] + 1]++;
+	for(i = 0; i < n; i++)
+		off[i+1] += off[i];
+	/* off[v] moves to the end of the edges of v, then back */
+	for(i = 0; i < m; i++)
+	{
+		k = off[tails[i]]++;
+		adj[k] = heads[i];
+		eid[k] = i;
+	}
+	for(i = n; i > 0; i--)
+		off[i] = off[i-1];
+	off[0] = 0;
+}
+
+/* Kahn's algorithm on the out adjacency, levels along the way */
+static void dag_order(struct ggen_dag *d)
+{
+	uint32_t *indeg = d->level;
+	uint32_t first,last,u,v,k;
+
+	last = 0;
+	for(v = 0; v < d->n; v++)
+	{
+		indeg[v] = GGEN_DAG_INDEG(d,v);
+		if(indeg[v] == 0)
+			d->order[last++] = v;
+	}
+	/* level holds the in-degrees left until the order is known */
+	for(first = 0; first < last; first++)
+	{
+		u = d->order[first];
+		for(k = d->out_off[u]; k < d->out_off[u+1]; k++)
+			if(--indeg[d->out[k]] == 0)
+				d->order[last++] = d->out[k];
+	}
+	d->is_dag = last == d->n;
+	if(!d->is_dag)
+		return;
+
+	for(first = 0; first < d->n; first++)
+	{
+		v = d->order[first];
+		d->level[v] = 0;
+		for(k = d->in_off[v]; k < d->in_off[v+1]; k++)
+			if(d->level[d->in[k]] + 1 > d->level[v])
+				d->level[v] = d->level[d->in[k]] + 1;
+	}
+}
+
+int ggen_dag_init(struct ggen_dag *d, const igraph_t *g)
+{
+	igraph_vector_t edges;
+	uint32_t *tails = NULL,*heads = NULL;
+	unsigned long n,m,i;
+	int err = 1;
+
+	if(d == NULL || g == NULL)
+		return 1;
+	n = igraph_vcount(g);
+	m = igraph_ecount(g);
+	/* indices are 32 bits wide, the view of larger graphs is refused */
+	if(n >= UINT32_MAX || m >= UINT32_MAX)
+		return 1;
+
+	d->n = n;
+	d->m = m;
+	d->out_off = malloc((n + 1)*sizeof(uint32_t));
+	d->in_off = malloc((n + 1)*sizeof(uint32_t));
+	d->out = malloc((m + 1)*sizeof(uint32_t));
+	d->out_eid = malloc((m + 1)*sizeof(uint32_t));
+	d->in = malloc((m + 1)*sizeof(uint32_t));
+	d->in_eid = malloc((m + 1)*sizeof(uint32_t));
+	d->order = malloc((n + 1)*sizeof(uint32_t));
+	d->level = malloc((n + 1)*sizeof(uint32_t));
+	tails = malloc((m + 1)*sizeof(uint32_t));
+	heads = malloc((m + 1)*sizeof(uint32_t));
+	if(d->out_off == NULL || d->in_off == NULL || d->out == NULL
+			|| d->out_eid == NULL || d->in == NULL || d->in_eid == NULL
+			|| d->order == NULL || d->level == NULL
+			|| tails == NULL || heads == NULL)
+		goto cleanup;
+
+	if(igraph_vector_init(&edges,2*m))
+		goto cleanup;
+	if(igraph_get_edgelist(g,&edges,0))
+	{
+		igraph_vector_destroy(&edges);
+		goto cleanup;
+	}
+	for(i = 0; i < m; i++)
+	{
+		tails[i] = VECTOR(edges)[2*i];
+		heads[i] = VECTOR(edges)[2*i+1];
+	}
+	igraph_vector_destroy(&edges);
+
+	dag_csr(d->n,d->m,tails,heads,d->out_off,d->out,d->out_eid);
+	dag_csr(d->n,d->m,heads,tails,d->in_off,d->in,d->in_eid);
+	dag_order(d);
+	err = 0;
+cleanup:
+	free(tails);
+	free(heads);
+	if(err)
+		ggen_dag_destroy(d);
+	return err;
+}
+
+void ggen_dag_destroy(struct ggen_dag *d)
+{
+	if(d == NULL)
+		return;
+	free(d->out_off);
+	free(d->out);
+	free(d->out_eid);
+	free(d->in_off);
+	free(d->in);
+	free(d->in_eid);
+	free(d->order);
+	free(d->level);
+	d->out_off = d->out = d->out_eid = NULL;
+	d->in_off = d->in = d->in_eid = NULL;
+	d->order = d->level = NULL;
+}
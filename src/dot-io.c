@@ -0,0 +1,1705 @@
+/* Copyright Swann Perarnau 2009
+*
+*   contact : Swann.Perarnau@imag.fr
+*
+* This software is a computer program whose purpose is to help the
+* random generation of graph structures and adding various properties
+* on those structures.
+*
+* This software is governed by the CeCILL  license under French law and
+* abiding by the rules of distribution of free software.  You can  use,
+* modify and/ or redistribute the software under the terms of the CeCILL
+* license as circulated by CEA, CNRS and INRIA at the following URL
+* "http://www.cecill.info".
+*
+* As a counterpart to the access to the source code and  rights to copy,
+* modify and redistribute granted by the license, users are provided only
+* with a limited warranty  and the software's author,  the holder of the
+* economic rights,  and the successive licensors  have only  limited
+* liability.
+*
+* In this respect, the user's attention is drawn to the risks associated
+* with loading,  using,  modifying and/or developing or reproducing the
+* software by the user in light of its specific status of free software,
+* that may mean  that it is complicated to manipulate,  and  that  also
+* therefore means  that it is reserved for developers  and  experienced
+* professionals having in-depth computer knowledge. Users are therefore
+* encouraged to load and test the software's suitability as regards their
+* requirements in conditions enabling the security of their systems and/or
+* data to be ensured and,  more generally, to use and operate it in the
+* same conditions as regards security.
+*
+* The fact that you are presently reading this means that you have had
+* knowledge of the CeCILL license and that you accept its terms.
+*/
+
+/* Native DOT input/output:
+ * cgraph builds a complete Agraph_t mirror of the graph before writing
+ * it, which doubles the memory needed and spends most of its time in
+ * dictionaries. Graphs are written here directly from igraph, in one pass
+ * through a large buffer. The output follows the layout of agwrite:
+ * graph attributes, default values of vertex and edge attributes, every
+ * vertex then every edge, with the attributes that differ from their
+ * default.
+ *
+ * Graphs are read the same way: the input, mapped in memory by graph-io.c,
+ * is tokenized in place and identifiers are never copied until they are
+ * given to igraph. The reader only knows the subset of DOT that ggen and
+ * most tools write; anything else is handed to cgraph.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#include "utils.h"
+#include "log.h"
+
+enum ggen_writer ggen_dot_writer = GGEN_WRITER_NATIVE;
+
+int ggen_write_graph_dot(igraph_t *g, FILE *output)
+{
+	if(ggen_dot_writer == GGEN_WRITER_CGRAPH)
+		return ggen_write_graph_cgraph(g,output);
+	return ggen_write_graph_native(g,output);
+}
+
+/* buffered output */
+#define DOT_BUFFER_SIZE (1 << 20)
+
+struct dot_out {
+	FILE *f;
+	char *buf;
+	size_t len;
+	int err;
+};
+
+static void out_flush(struct dot_out *o)
+{
+	if(o->len && fwrite(o->buf,1,o->len,o->f) != o->len)
+		o->err = 1;
+	o->len = 0;
+}
+
+static void out_mem(struct dot_out *o, const char *s, size_t n)
+{
+	if(o->len + n > DOT_BUFFER_SIZE)
+	{
+		out_flush(o);
+		// too big for the buffer anyway
+		if(n > DOT_BUFFER_SIZE)
+		{
+			if(fwrite(s,1,n,o->f) != n)
+				o->err = 1;
+			return;
+		}
+	}
+	memcpy(o->buf + o->len,s,n);
+	o->len += n;
+}
+
+static void out_str(struct dot_out *o, const char *s)
+{
+	out_mem(o,s,strlen(s));
+}
+
+static void out_ulong(struct dot_out *o, unsigned long v)
+{
+	char tmp[32];
+	int i = sizeof(tmp);
+
+	do {
+		tmp[--i] = '0' + v % 10;
+		v /= 10;
+	} while(v);
+	out_mem(o,tmp + i,sizeof(tmp) - i);
+}
+
+/* an ID is written as is if it is a valid DOT identifier or numeral
+ * (as agcanonStr does), and quoted otherwise */
+static int dot_is_keyword(const char *s)
+{
+	static const char *keywords[] = { "node", "edge", "graph", "digraph",
+		"subgraph", "strict", NULL };
+	int i;
+
+	for(i = 0; keywords[i] != NULL; i++)
+		if(!strcasecmp(s,keywords[i]))
+			return 1;
+	return 0;
+}
+
+static int dot_is_plain(const char *s)
+{
+	const unsigned char *c = (const unsigned char *)s;
+	int dot = 0, digits = 0;
+
+	if(*c == '\0')
+		return 0;
+
+	// identifier
+	if(*c == '_' || (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z') || *c >= 128)
+	{
+		for(c++; *c; c++)
+			if(!(*c == '_' || (*c >= 'a' && *c <= 'z') || (*c >= 'A' && *c <= 'Z')
+					|| (*c >= '0' && *c <= '9') || *c >= 128))
+				return 0;
+		return !dot_is_keyword(s);
+	}
+
+	// numeral
+	if(*c == '-')
+		c++;
+	for(; *c; c++)
+	{
+		if(*c == '.' && !dot)
+			dot = 1;
+		else if(*c >= '0' && *c <= '9')
+			digits++;
+		else
+			return 0;
+	}
+	return digits > 0;
+}
+
+static void out_id(struct dot_out *o, const char *s)
+{
+	const char *c;
+
+	if(dot_is_plain(s))
+	{
+		out_str(o,s);
+		return;
+	}
+	out_mem(o,"\"",1);
+	for(c = s; *c; c++)
+	{
+		if(*c == '"')
+			out_mem(o,"\\",1);
+		out_mem(o,c,1);
+	}
+	out_mem(o,"\"",1);
+}
+
+/* attribute values, numeric attributes are printed like the cgraph
+ * writer does, with enough digits to be read back exactly */
+static void out_value(struct dot_out *o, int numeric, double v, const char *s)
+{
+	char tmp[GGEN_DEFAULT_NAME_SIZE];
+
+	if(numeric)
+	{
+		d2s(v,tmp,GGEN_DEFAULT_NAME_SIZE);
+		out_id(o,tmp);
+	}
+	else
+		out_id(o,s);
+}
+
+/* attributes of one kind, without the ggen specific ones */
+struct dot_attrs {
+	long count;
+	const char **names;
+	int *numeric;
+	/* the values of every attribute, see dot_attrs_fetch */
+	long fetched;
+	igraph_vector_t *num;
+	igraph_strvector_t *str;
+};
+
+static int dot_attrs_init(struct dot_attrs *a, igraph_strvector_t *names,
+		igraph_vector_t *types, const char *skip)
+{
+	long i;
+
+	a->count = 0;
+	a->fetched = 0;
+	a->num = NULL;
+	a->str = NULL;
+	a->names = malloc((igraph_strvector_size(names)+1)*sizeof(char *));
+	a->numeric = malloc((igraph_strvector_size(names)+1)*sizeof(int));
+	if(a->names == NULL || a->numeric == NULL)
+		return 1;
+
+	for(i = 0; i < igraph_strvector_size(names); i++)
+	{
+		if(skip != NULL && !strcmp(STR(*names,i),skip))
+			continue;
+		a->names[a->count] = STR(*names,i);
+		a->numeric[a->count++] = VECTOR(*types)[i] == IGRAPH_ATTRIBUTE_NUMERIC;
+	}
+	return 0;
+}
+
+/* retrieves each vertex or edge attribute column once, so that writing an
+ * element only indexes into vectors instead of looking up its attributes
+ * by name */
+static int dot_attrs_fetch(struct dot_attrs *a, igraph_t *g, int vertex)
+{
+	long i;
+	int err;
+
+	a->num = malloc((a->count+1)*sizeof(igraph_vector_t));
+	a->str = malloc((a->count+1)*sizeof(igraph_strvector_t));
+	if(a->num == NULL || a->str == NULL)
+		return 1;
+
+	for(; a->fetched < a->count; a->fetched++)
+	{
+		if(igraph_vector_init(&a->num[a->fetched],0))
+			return 1;
+		if(igraph_strvector_init(&a->str[a->fetched],0))
+		{
+			igraph_vector_destroy(&a->num[a->fetched]);
+			return 1;
+		}
+	}
+
+	for(i = 0; i < a->count; i++)
+	{
+		if(a->numeric[i])
+			err = vertex ? VANV(g,a->names[i],&a->num[i]) :
+				EANV(g,a->names[i],&a->num[i]);
+		else
+			err = vertex ? VASV(g,a->names[i],&a->str[i]) :
+				EASV(g,a->names[i],&a->str[i]);
+		if(err)
+			return 1;
+	}
+	return 0;
+}
+
+static void dot_attrs_destroy(struct dot_attrs *a)
+{
+	long i;
+
+	for(i = 0; i < a->fetched; i++)
+	{
+		igraph_vector_destroy(&a->num[i]);
+		igraph_strvector_destroy(&a->str[i]);
+	}
+	free(a->num);
+	free(a->str);
+	free(a->names);
+	free(a->numeric);
+}
+
+/* writes the list of attributes of a vertex or an edge that differ from the
+ * default (empty) value. Numeric values are always written */
+static void out_attrs(struct dot_out *o, struct dot_attrs *a, unsigned long id)
+{
+	const char *s = NULL;
+	double v = 0;
+	long i;
+	int first = 1;
+
+	for(i = 0; i < a->count; i++)
+	{
+		if(a->numeric[i])
+			v = VECTOR(a->num[i])[id];
+		else
+		{
+			s = STR(a->str[i],id);
+			if(s == NULL || *s == '\0')
+				continue;
+		}
+		out_str(o,first ? "\t[" : ", ");
+		first = 0;
+		out_id(o,a->names[i]);
+		out_mem(o,"=",1);
+		out_value(o,a->numeric[i],v,s);
+	}
+	if(!first)
+		out_mem(o,"]",1);
+}
+
+/* declares the attributes of a kind with their default value */
+static void out_defaults(struct dot_out *o, const char *kind, struct dot_attrs *a)
+{
+	long i;
+
+	if(a->count == 0)
+		return;
+
+	out_mem(o,"\t",1);
+	out_str(o,kind);
+	for(i = 0; i < a->count; i++)
+	{
+		out_str(o,i ? ", " : " [");
+		out_id(o,a->names[i]);
+		out_str(o,"=\"\"");
+	}
+	out_str(o,"];\n");
+}
+
+/* names is the vertex name column, or NULL if the graph has none */
+static void out_vertex(struct dot_out *o, igraph_strvector_t *names,
+		unsigned long id)
+{
+	const char *s;
+
+	if(names != NULL)
+	{
+		s = STR(*names,id);
+		if(s != NULL)
+		{
+			out_id(o,s);
+			return;
+		}
+	}
+	out_ulong(o,id);
+}
+
+int ggen_write_graph_native(igraph_t *g, FILE *output)
+{
+	struct dot_out o;
+	struct dot_attrs ga,va,ea;
+	igraph_strvector_t gnames,vnames,enames,names;
+	igraph_vector_t gtypes,vtypes,etypes;
+	igraph_integer_t from,to;
+	unsigned long i,vcount,ecount;
+	int named = 0,err = 1;
+	long j;
+
+	vcount = igraph_vcount(g);
+	ecount = igraph_ecount(g);
+
+	o.f = output;
+	o.len = 0;
+	o.err = 0;
+	o.buf = malloc(DOT_BUFFER_SIZE);
+	if(o.buf == NULL)
+		return 1;
+
+	ga.names = va.names = ea.names = NULL;
+	ga.numeric = va.numeric = ea.numeric = NULL;
+	ga.num = va.num = ea.num = NULL;
+	ga.str = va.str = ea.str = NULL;
+	ga.fetched = va.fetched = ea.fetched = 0;
+
+	/* find all properties */
+	igraph_strvector_init(&gnames,0);
+	igraph_strvector_init(&vnames,0);
+	igraph_strvector_init(&enames,0);
+	igraph_vector_init(&gtypes,0);
+	igraph_vector_init(&vtypes,0);
+	igraph_vector_init(&etypes,0);
+	igraph_strvector_init(&names,0);
+
+	if(igraph_cattribute_list(g,&gnames,&gtypes,&vnames,&vtypes,&enames,&etypes))
+		goto cleanup;
+
+	if(dot_attrs_init(&ga,&gnames,&gtypes,GGEN_GRAPH_NAME_ATTR) ||
+			dot_attrs_init(&va,&vnames,&vtypes,GGEN_VERTEX_NAME_ATTR) ||
+			dot_attrs_init(&ea,&enames,&etypes,NULL))
+		goto cleanup;
+
+	for(j = 0; j < igraph_strvector_size(&vnames); j++)
+		if(!strcmp(STR(vnames,j),GGEN_VERTEX_NAME_ATTR) &&
+				VECTOR(vtypes)[j] == IGRAPH_ATTRIBUTE_STRING)
+			named = 1;
+
+	if(dot_attrs_fetch(&va,g,1) || dot_attrs_fetch(&ea,g,0))
+		goto cleanup;
+	if(named && VASV(g,GGEN_VERTEX_NAME_ATTR,&names))
+		goto cleanup;
+
+	/* open graph
+	 * its name is saved in __ggen_graph_name if it exists
+	 */
+	out_str(&o,"digraph ");
+	for(j = 0; j < igraph_strvector_size(&gnames); j++)
+		if(!strcmp(STR(gnames,j),GGEN_GRAPH_NAME_ATTR) &&
+				VECTOR(gtypes)[j] == IGRAPH_ATTRIBUTE_STRING)
+			break;
+	if(j < igraph_strvector_size(&gnames))
+		out_id(&o,GAS(g,GGEN_GRAPH_NAME_ATTR));
+	else
+		out_str(&o,GGEN_DEFAULT_GRAPH_NAME);
+	out_str(&o," {\n");
+
+	/* graph properties */
+	for(j = 0; j < ga.count; j++)
+	{
+		out_str(&o,j ? ", " : "\tgraph [");
+		out_id(&o,ga.names[j]);
+		out_mem(&o,"=",1);
+		out_value(&o,ga.numeric[j],ga.numeric[j] ? GAN(g,ga.names[j]) : 0,
+				ga.numeric[j] ? NULL : GAS(g,ga.names[j]));
+	}
+	if(ga.count)
+		out_str(&o,"];\n");
+
+	out_defaults(&o,"node",&va);
+	out_defaults(&o,"edge",&ea);
+
+	for(i = 0; i < vcount; i++)
+	{
+		out_mem(&o,"\t",1);
+		out_vertex(&o,named ? &names : NULL,i);
+		out_attrs(&o,&va,i);
+		out_str(&o,";\n");
+	}
+
+	for(i = 0; i < ecount; i++)
+	{
+		igraph_edge(g,i,&from,&to);
+		out_mem(&o,"\t",1);
+		out_vertex(&o,named ? &names : NULL,(unsigned long)from);
+		out_str(&o," -> ");
+		out_vertex(&o,named ? &names : NULL,(unsigned long)to);
+		out_attrs(&o,&ea,i);
+		out_str(&o,";\n");
+	}
+	out_str(&o,"}\n");
+	out_flush(&o);
+	err = o.err || fflush(output) != 0;
+cleanup:
+	dot_attrs_destroy(&ga);
+	dot_attrs_destroy(&va);
+	dot_attrs_destroy(&ea);
+	igraph_strvector_destroy(&gnames);
+	igraph_strvector_destroy(&vnames);
+	igraph_strvector_destroy(&enames);
+	igraph_vector_destroy(&gtypes);
+	igraph_vector_destroy(&vtypes);
+	igraph_vector_destroy(&etypes);
+	igraph_strvector_destroy(&names);
+	free(o.buf);
+	return err;
+}
+
+/* a string inside the input, or inside the parser arena when it had
+ * to be unescaped */
+struct dot_slice {
+	const char *s;
+	size_t len;
+};
+
+static const struct dot_slice dot_empty = { "", 0 };
+
+/* the values of one attribute, indexed by object id. A NULL slice means
+ * the object has the default value */
+struct dot_column {
+	struct dot_slice name;
+	struct dot_slice def;
+	struct dot_slice *values;
+	unsigned long size;
+};
+
+struct dot_columns {
+	struct dot_column *cols;
+	unsigned long count;
+	unsigned long size;
+};
+
+/* unescaped strings are kept in a list of blocks */
+struct dot_chunk {
+	struct dot_chunk *next;
+	char data[];
+};
+
+enum dot_token {
+	DOT_EOF,
+	DOT_ID,
+	DOT_LBRACE,
+	DOT_RBRACE,
+	DOT_LBRACKET,
+	DOT_RBRACKET,
+	DOT_EQUAL,
+	DOT_SEMI,
+	DOT_COMMA,
+	DOT_ARROW,
+	DOT_NODE,
+	DOT_EDGE,
+	DOT_GRAPH,
+	DOT_DIGRAPH,
+	DOT_SUBGRAPH,
+	DOT_STRICT,
+	/* anything this reader does not support */
+	DOT_OTHER
+};
+
+struct dot_parser {
+	const char *start;
+	const char *cur;
+	const char *end;
+	enum dot_token tok;
+	struct dot_slice id;
+	struct dot_chunk *chunks;
+
+	struct dot_slice name;
+
+	/* vertices by order of appearance, with an open addressing table
+	 * of their ids (plus one, 0 marks an empty slot) */
+	struct dot_slice *vnames;
+	unsigned long vcount;
+	unsigned long vsize;
+	unsigned long *table;
+	unsigned long tsize;
+
+	unsigned long *edges;
+	unsigned long ecount;
+	unsigned long esize;
+
+	struct dot_columns gattrs;
+	struct dot_columns vattrs;
+	struct dot_columns eattrs;
+
+	/* streaming: objects go to the stream as they are read, only the
+	 * vertex names are kept. The attribute list and the vertices of the
+	 * edge chain being read */
+	struct ggen_stream *stream;
+	struct ggen_field *row;
+	unsigned long nrow;
+	unsigned long rowsize;
+	unsigned long *chain;
+	unsigned long nchain;
+	unsigned long chainsize;
+};
+
+/* parse errors and unsupported constructs are the same for us: the input
+ * goes to cgraph, which knows how to report errors */
+#define DOT_UNSUPPORTED (-1)
+
+static int dot_is_idstart(unsigned char c)
+{
+	return c == '_' || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 128;
+}
+
+static int dot_is_digit(unsigned char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+static enum dot_token dot_keyword(const char *s, size_t len)
+{
+	static const struct { const char *word; enum dot_token tok; } keywords[] = {
+		{ "node", DOT_NODE }, { "edge", DOT_EDGE }, { "graph", DOT_GRAPH },
+		{ "digraph", DOT_DIGRAPH }, { "subgraph", DOT_SUBGRAPH },
+		{ "strict", DOT_STRICT }, { NULL, DOT_ID } };
+	int i;
+
+	if(len < 4 || len > 8)
+		return DOT_ID;
+	for(i = 0; keywords[i].word != NULL; i++)
+		if(strlen(keywords[i].word) == len && !strncasecmp(s,keywords[i].word,len))
+			return keywords[i].tok;
+	return DOT_ID;
+}
+
+/* quoted strings: \" is a quote and a backslash before a newline is
+ * a line continuation, other escapes are kept as is, like cgraph does */
+static int dot_unescape(struct dot_parser *p, const char *s, size_t len)
+{
+	struct dot_chunk *c;
+	char *d;
+	size_t i;
+
+	c = malloc(sizeof(struct dot_chunk) + len + 1);
+	if(c == NULL)
+		return 1;
+	c->next = p->chunks;
+	p->chunks = c;
+
+	d = c->data;
+	for(i = 0; i < len; i++)
+	{
+		if(s[i] == '\\' && i + 1 < len && s[i+1] == '"')
+			*d++ = s[++i];
+		else if(s[i] == '\\' && i + 1 < len && s[i+1] == '\n')
+			i++;
+		else if(s[i] == '\\' && i + 2 < len && s[i+1] == '\r' && s[i+2] == '\n')
+			i += 2;
+		else
+			*d++ = s[i];
+	}
+	*d = '\0';
+	p->id.s = c->data;
+	p->id.len = d - c->data;
+	return 0;
+}
+
+static void dot_skip(struct dot_parser *p)
+{
+	const char *c = p->cur, *end = p->end;
+
+	while(c < end)
+	{
+		if(*c == ' ' || *c == '\t' || *c == '\n' || *c == '\r' || *c == '\f' || *c == '\v')
+			c++;
+		/* preprocessor output lines */
+		else if(*c == '#' && (c == p->start || c[-1] == '\n'))
+		{
+			while(c < end && *c != '\n')
+				c++;
+		}
+		else if(*c == '/' && c + 1 < end && c[1] == '/')
+		{
+			while(c < end && *c != '\n')
+				c++;
+		}
+		else if(*c == '/' && c + 1 < end && c[1] == '*')
+		{
+			for(c += 2; c + 1 < end && !(c[0] == '*' && c[1] == '/'); c++);
+			if(c + 1 >= end)
+			{
+				/* unterminated comment */
+				c = end;
+				p->tok = DOT_OTHER;
+				p->cur = c;
+				return;
+			}
+			c += 2;
+		}
+		else
+			break;
+	}
+	p->cur = c;
+	p->tok = DOT_EOF;
+}
+
+static int dot_next(struct dot_parser *p)
+{
+	const char *c,*end = p->end;
+	int escaped = 0;
+
+	dot_skip(p);
+	if(p->tok == DOT_OTHER || p->cur == end)
+		return 0;
+
+	c = p->cur;
+	p->tok = DOT_OTHER;
+	switch(*c)
+	{
+		case '{': p->tok = DOT_LBRACE; c++; break;
+		case '}': p->tok = DOT_RBRACE; c++; break;
+		case '[': p->tok = DOT_LBRACKET; c++; break;
+		case ']': p->tok = DOT_RBRACKET; c++; break;
+		case '=': p->tok = DOT_EQUAL; c++; break;
+		case ';': p->tok = DOT_SEMI; c++; break;
+		case ',': p->tok = DOT_COMMA; c++; break;
+		case '"':
+			for(c++; c < end && *c != '"'; c++)
+				if(*c == '\\' && c + 1 < end)
+				{
+					escaped = 1;
+					c++;
+				}
+			if(c == end)
+				break;
+			if(escaped)
+			{
+				if(dot_unescape(p,p->cur + 1,c - p->cur - 1))
+					return 1;
+			}
+			else
+			{
+				p->id.s = p->cur + 1;
+				p->id.len = c - p->cur - 1;
+			}
+			p->tok = DOT_ID;
+			c++;
+			break;
+		case '-':
+			if(c + 1 < end && c[1] == '>')
+			{
+				p->tok = DOT_ARROW;
+				c += 2;
+				break;
+			}
+			if(c + 1 < end && (dot_is_digit(c[1]) || c[1] == '.'))
+				goto numeral;
+			break;
+		default:
+			if(dot_is_idstart(*c))
+			{
+				for(c++; c < end && (dot_is_idstart(*c) || dot_is_digit(*c)); c++);
+				p->id.s = p->cur;
+				p->id.len = c - p->cur;
+				p->tok = dot_keyword(p->id.s,p->id.len);
+			}
+			else if(dot_is_digit(*c) || *c == '.')
+				goto numeral;
+			break;
+	}
+	p->cur = c;
+	return 0;
+numeral:
+	for(c++; c < end && dot_is_digit(*c); c++);
+	if(c < end && *c == '.' && memchr(p->cur,'.',c - p->cur) == NULL)
+		for(c++; c < end && dot_is_digit(*c); c++);
+	/* cgraph splits things like 1a with a warning, leave it that */
+	if(c < end && (dot_is_idstart(*c) || *c == '.'))
+		return 0;
+	p->id.s = p->cur;
+	p->id.len = c - p->cur;
+	p->tok = DOT_ID;
+	p->cur = c;
+	return 0;
+}
+
+static unsigned long dot_hash(struct dot_slice *s)
+{
+	unsigned long h = 14695981039346656037UL;
+	size_t i;
+
+	for(i = 0; i < s->len; i++)
+	{
+		h ^= (unsigned char)s->s[i];
+		h *= 1099511628211UL;
+	}
+	return h;
+}
+
+static int dot_slice_eq(const struct dot_slice *a, const struct dot_slice *b)
+{
+	return a->len == b->len && !memcmp(a->s,b->s,a->len);
+}
+
+static int dot_table_grow(struct dot_parser *p)
+{
+	unsigned long i,h,mask,size;
+	unsigned long *table;
+
+	size = p->tsize ? 2*p->tsize : 1024;
+	table = calloc(size,sizeof(unsigned long));
+	if(table == NULL)
+		return 1;
+
+	mask = size - 1;
+	for(i = 0; i < p->vcount; i++)
+	{
+		h = dot_hash(&p->vnames[i]) & mask;
+		while(table[h])
+			h = (h + 1) & mask;
+		table[h] = i + 1;
+	}
+	free(p->table);
+	p->table = table;
+	p->tsize = size;
+	return 0;
+}
+
+/* vertex id of a name, the vertex is created on first use */
+static int dot_vertex(struct dot_parser *p, struct dot_slice *name, unsigned long *id)
+{
+	unsigned long h,mask;
+	struct dot_slice *tmp;
+
+	if(2*(p->vcount + 1) > p->tsize && dot_table_grow(p))
+		return 1;
+
+	mask = p->tsize - 1;
+	h = dot_hash(name) & mask;
+	while(p->table[h])
+	{
+		if(dot_slice_eq(&p->vnames[p->table[h] - 1],name))
+		{
+			*id = p->table[h] - 1;
+			return 0;
+		}
+		h = (h + 1) & mask;
+	}
+
+	if(p->vcount == p->vsize)
+	{
+		p->vsize = p->vsize ? 2*p->vsize : 1024;
+		tmp = realloc(p->vnames,p->vsize*sizeof(struct dot_slice));
+		if(tmp == NULL)
+			return 1;
+		p->vnames = tmp;
+	}
+	p->vnames[p->vcount] = *name;
+	p->table[h] = ++p->vcount;
+	*id = p->vcount - 1;
+	return 0;
+}
+
+static int dot_edge(struct dot_parser *p, unsigned long from, unsigned long to)
+{
+	unsigned long *tmp;
+
+	if(p->ecount == p->esize)
+	{
+		p->esize = p->esize ? 2*p->esize : 1024;
+		tmp = realloc(p->edges,2*p->esize*sizeof(unsigned long));
+		if(tmp == NULL)
+			return 1;
+		p->edges = tmp;
+	}
+	p->edges[2*p->ecount] = from;
+	p->edges[2*p->ecount+1] = to;
+	p->ecount++;
+	return 0;
+}
+
+static void dot_columns_destroy(struct dot_columns *c)
+{
+	unsigned long i;
+	for(i = 0; i < c->count; i++)
+		free(c->cols[i].values);
+	free(c->cols);
+}
+
+/* column of an attribute, declared with an empty default on first use */
+static struct dot_column *dot_column(struct dot_columns *c, struct dot_slice *name)
+{
+	struct dot_column *tmp;
+	unsigned long i;
+
+	for(i = 0; i < c->count; i++)
+		if(dot_slice_eq(&c->cols[i].name,name))
+			return &c->cols[i];
+
+	if(c->count == c->size)
+	{
+		c->size = c->size ? 2*c->size : 8;
+		tmp = realloc(c->cols,c->size*sizeof(struct dot_column));
+		if(tmp == NULL)
+			return NULL;
+		c->cols = tmp;
+	}
+	tmp = &c->cols[c->count++];
+	tmp->name = *name;
+	tmp->def = dot_empty;
+	tmp->values = NULL;
+	tmp->size = 0;
+	return tmp;
+}
+
+static int dot_column_set(struct dot_column *c, unsigned long id, struct dot_slice *value)
+{
+	struct dot_slice *tmp;
+	unsigned long size;
+
+	if(id >= c->size)
+	{
+		size = c->size ? 2*c->size : 1024;
+		while(size <= id)
+			size *= 2;
+		tmp = realloc(c->values,size*sizeof(struct dot_slice));
+		if(tmp == NULL)
+			return 1;
+		memset(tmp + c->size,0,(size - c->size)*sizeof(struct dot_slice));
+		c->values = tmp;
+		c->size = size;
+	}
+	c->values[id] = *value;
+	return 0;
+}
+
+/* attribute lists: [a=b, c=d][e=f]
+ * sets the default value of each attribute if first == last, or its value
+ * on objects [first,last) otherwise. Attributes nobody asked for are only
+ * parsed */
+static int dot_attr_list(struct dot_parser *p, struct dot_columns *cols,
+		enum ggen_object kind, unsigned long first, unsigned long last)
+{
+	struct dot_column *col;
+	struct dot_slice name;
+	unsigned long i;
+
+	if(p->tok != DOT_LBRACKET)
+		return DOT_UNSUPPORTED;
+
+	while(p->tok == DOT_LBRACKET)
+	{
+		if(dot_next(p)) return 1;
+		while(p->tok == DOT_ID)
+		{
+			name = p->id;
+			if(dot_next(p)) return 1;
+			/* a lone name means name=true, rare enough */
+			if(p->tok != DOT_EQUAL)
+				return DOT_UNSUPPORTED;
+			if(dot_next(p)) return 1;
+			if(p->tok != DOT_ID)
+				return DOT_UNSUPPORTED;
+			if(!ggen_attr_wanted(kind,name.s,name.len))
+				goto next;
+
+			col = dot_column(cols,&name);
+			if(col == NULL)
+				return 1;
+			if(first == last)
+				col->def = p->id;
+			for(i = first; i < last; i++)
+				if(dot_column_set(col,i,&p->id))
+					return 1;
+next:
+			if(dot_next(p)) return 1;
+			if(p->tok == DOT_COMMA || p->tok == DOT_SEMI)
+				if(dot_next(p)) return 1;
+		}
+		if(p->tok != DOT_RBRACKET)
+			return DOT_UNSUPPORTED;
+		if(dot_next(p)) return 1;
+	}
+	return 0;
+}
+
+static void dot_field(struct ggen_field *f, const struct dot_slice *s)
+{
+	f->s = s->s;
+	f->len = s->len;
+}
+
+/* attribute lists of a streamed statement, as name/value pairs */
+static int dot_row(struct dot_parser *p)
+{
+	struct ggen_field *tmp;
+
+	p->nrow = 0;
+	while(p->tok == DOT_LBRACKET)
+	{
+		if(dot_next(p)) return 1;
+		while(p->tok == DOT_ID)
+		{
+			if(2*(p->nrow + 1) > p->rowsize)
+			{
+				p->rowsize = p->rowsize ? 2*p->rowsize : 16;
+				tmp = realloc(p->row,p->rowsize*sizeof(struct ggen_field));
+				if(tmp == NULL)
+					return 1;
+				p->row = tmp;
+			}
+			dot_field(&p->row[2*p->nrow],&p->id);
+			if(dot_next(p)) return 1;
+			if(p->tok != DOT_EQUAL)
+				return DOT_UNSUPPORTED;
+			if(dot_next(p)) return 1;
+			if(p->tok != DOT_ID)
+				return DOT_UNSUPPORTED;
+			dot_field(&p->row[2*p->nrow+1],&p->id);
+			p->nrow++;
+
+			if(dot_next(p)) return 1;
+			if(p->tok == DOT_COMMA || p->tok == DOT_SEMI)
+				if(dot_next(p)) return 1;
+		}
+		if(p->tok != DOT_RBRACKET)
+			return DOT_UNSUPPORTED;
+		if(dot_next(p)) return 1;
+	}
+	return 0;
+}
+
+static int dot_stream_defaults(struct dot_parser *p, enum ggen_object kind)
+{
+	unsigned long i;
+	int err;
+
+	if(p->tok != DOT_LBRACKET)
+		return DOT_UNSUPPORTED;
+	err = dot_row(p);
+	if(err) return err;
+	for(i = 0; i < p->nrow; i++)
+		if(p->stream->attr(p->stream,kind,&p->row[2*i],&p->row[2*i+1]))
+			return 1;
+	return 0;
+}
+
+static int dot_chain_add(struct dot_parser *p, unsigned long v)
+{
+	unsigned long *tmp;
+
+	if(p->nchain == p->chainsize)
+	{
+		p->chainsize = p->chainsize ? 2*p->chainsize : 16;
+		tmp = realloc(p->chain,p->chainsize*sizeof(unsigned long));
+		if(tmp == NULL)
+			return 1;
+		p->chain = tmp;
+	}
+	p->chain[p->nchain++] = v;
+	return 0;
+}
+
+/* same statements as dot_stmt(), given to the stream */
+static int dot_stream_stmt(struct dot_parser *p)
+{
+	struct ggen_stream *s = p->stream;
+	struct ggen_field name,value,u,v;
+	struct dot_slice vname;
+	unsigned long i,id;
+	int err;
+
+	switch(p->tok)
+	{
+		case DOT_GRAPH:
+			if(dot_next(p)) return 1;
+			err = dot_stream_defaults(p,GGEN_OBJECT_GRAPH);
+			if(err) return err;
+			break;
+		case DOT_NODE:
+			if(p->vcount)
+				return DOT_UNSUPPORTED;
+			if(dot_next(p)) return 1;
+			err = dot_stream_defaults(p,GGEN_OBJECT_VERTEX);
+			if(err) return err;
+			break;
+		case DOT_EDGE:
+			if(p->ecount)
+				return DOT_UNSUPPORTED;
+			if(dot_next(p)) return 1;
+			err = dot_stream_defaults(p,GGEN_OBJECT_EDGE);
+			if(err) return err;
+			break;
+		case DOT_ID:
+			dot_field(&name,&p->id);
+			if(dot_next(p)) return 1;
+			if(p->tok == DOT_EQUAL)
+			{
+				if(dot_next(p)) return 1;
+				if(p->tok != DOT_ID)
+					return DOT_UNSUPPORTED;
+				dot_field(&value,&p->id);
+				if(s->attr(s,GGEN_OBJECT_GRAPH,&name,&value))
+					return 1;
+				if(dot_next(p)) return 1;
+				break;
+			}
+
+			p->nchain = 0;
+			vname.s = name.s;
+			vname.len = name.len;
+			if(dot_vertex(p,&vname,&id) || dot_chain_add(p,id))
+				return 1;
+			while(p->tok == DOT_ARROW)
+			{
+				if(dot_next(p)) return 1;
+				if(p->tok != DOT_ID)
+					return DOT_UNSUPPORTED;
+				if(dot_vertex(p,&p->id,&id) || dot_chain_add(p,id))
+					return 1;
+				if(dot_next(p)) return 1;
+			}
+			err = dot_row(p);
+			if(err) return err;
+
+			if(p->nchain == 1)
+			{
+				dot_field(&u,&p->vnames[p->chain[0]]);
+				if(s->vertex(s,p->chain[0],&u,p->nrow,p->row))
+					return 1;
+			}
+			for(i = 1; i < p->nchain; i++)
+			{
+				dot_field(&u,&p->vnames[p->chain[i-1]]);
+				dot_field(&v,&p->vnames[p->chain[i]]);
+				if(s->edge(s,p->chain[i-1],&u,p->chain[i],&v,p->nrow,p->row))
+					return 1;
+				p->ecount++;
+			}
+			break;
+		default:
+			return DOT_UNSUPPORTED;
+	}
+	if(p->tok == DOT_SEMI)
+		if(dot_next(p)) return 1;
+	return 0;
+}
+
+static int dot_stmt(struct dot_parser *p)
+{
+	struct dot_column *col;
+	struct dot_slice name;
+	unsigned long u,v,first;
+	int err;
+
+	switch(p->tok)
+	{
+		case DOT_GRAPH:
+			if(dot_next(p)) return 1;
+			err = dot_attr_list(p,&p->gattrs,GGEN_OBJECT_GRAPH,0,0);
+			if(err) return err;
+			break;
+		/* defaults given after some objects exist do not apply to
+		 * them, cgraph knows how to deal with that */
+		case DOT_NODE:
+			if(p->vcount)
+				return DOT_UNSUPPORTED;
+			if(dot_next(p)) return 1;
+			err = dot_attr_list(p,&p->vattrs,GGEN_OBJECT_VERTEX,0,0);
+			if(err) return err;
+			break;
+		case DOT_EDGE:
+			if(p->ecount)
+				return DOT_UNSUPPORTED;
+			if(dot_next(p)) return 1;
+			err = dot_attr_list(p,&p->eattrs,GGEN_OBJECT_EDGE,0,0);
+			if(err) return err;
+			break;
+		case DOT_ID:
+			name = p->id;
+			if(dot_next(p)) return 1;
+			/* graph attribute */
+			if(p->tok == DOT_EQUAL)
+			{
+				if(dot_next(p)) return 1;
+				if(p->tok != DOT_ID)
+					return DOT_UNSUPPORTED;
+				if(ggen_attr_wanted(GGEN_OBJECT_GRAPH,name.s,name.len))
+				{
+					col = dot_column(&p->gattrs,&name);
+					if(col == NULL)
+						return 1;
+					col->def = p->id;
+				}
+				if(dot_next(p)) return 1;
+				break;
+			}
+
+			if(dot_vertex(p,&name,&u))
+				return 1;
+			/* edge chain */
+			if(p->tok == DOT_ARROW)
+			{
+				first = p->ecount;
+				while(p->tok == DOT_ARROW)
+				{
+					if(dot_next(p)) return 1;
+					if(p->tok != DOT_ID)
+						return DOT_UNSUPPORTED;
+					if(dot_vertex(p,&p->id,&v) || dot_edge(p,u,v))
+						return 1;
+					u = v;
+					if(dot_next(p)) return 1;
+				}
+				if(p->tok == DOT_LBRACKET)
+				{
+					err = dot_attr_list(p,&p->eattrs,GGEN_OBJECT_EDGE,first,p->ecount);
+					if(err) return err;
+				}
+			}
+			else if(p->tok == DOT_LBRACKET)
+			{
+				err = dot_attr_list(p,&p->vattrs,GGEN_OBJECT_VERTEX,u,u+1);
+				if(err) return err;
+			}
+			break;
+		default:
+			return DOT_UNSUPPORTED;
+	}
+	if(p->tok == DOT_SEMI)
+		if(dot_next(p)) return 1;
+	return 0;
+}
+
+static int dot_parse(struct dot_parser *p)
+{
+	struct ggen_field name;
+	int err;
+
+	if(dot_next(p)) return 1;
+	if(p->tok != DOT_DIGRAPH)
+		return DOT_UNSUPPORTED;
+	if(dot_next(p)) return 1;
+	/* anonymous graphs are named by cgraph */
+	if(p->tok != DOT_ID)
+		return DOT_UNSUPPORTED;
+	p->name = p->id;
+	if(dot_next(p)) return 1;
+	if(p->tok != DOT_LBRACE)
+		return DOT_UNSUPPORTED;
+	if(dot_next(p)) return 1;
+
+	if(p->stream != NULL)
+	{
+		dot_field(&name,&p->name);
+		if(p->stream->graph(p->stream,&name))
+			return 1;
+	}
+	while(p->tok != DOT_RBRACE)
+	{
+		err = p->stream ? dot_stream_stmt(p) : dot_stmt(p);
+		if(err) return err;
+	}
+	return 0;
+}
+
+/* igraph wants NUL terminated strings */
+struct dot_cstr {
+	char *buf;
+	size_t size;
+};
+
+static const char *dot_cstr(struct dot_cstr *c, const struct dot_slice *s)
+{
+	char *tmp;
+
+	if(s->len >= c->size)
+	{
+		tmp = realloc(c->buf,s->len + 1);
+		if(tmp == NULL)
+			return NULL;
+		c->buf = tmp;
+		c->size = s->len + 1;
+	}
+	memcpy(c->buf,s->s,s->len);
+	c->buf[s->len] = '\0';
+	return c->buf;
+}
+
+static const struct dot_slice *dot_value(struct dot_column *col,
+		unsigned long *order, unsigned long i)
+{
+	unsigned long id = order ? order[i] : i;
+
+	if(id < col->size && col->values[id].s != NULL)
+		return &col->values[id];
+	return &col->def;
+}
+
+/* numeric columns go to igraph as numbers, unless typed is 0 */
+static int dot_column_numbers(igraph_t *g, const char *name, struct dot_column *col,
+		int vertex, unsigned long count, unsigned long *order, struct dot_cstr *cvalue)
+{
+	igraph_vector_t numbers;
+	const char *value;
+	unsigned long i;
+	int err;
+
+	err = igraph_vector_init(&numbers,count);
+	if(err) return err;
+
+	for(i = 0; i < count; i++)
+	{
+		value = dot_cstr(cvalue,dot_value(col,order,i));
+		if(value == NULL)
+		{
+			err = 1;
+			goto cleanup;
+		}
+		VECTOR(numbers)[i] = strtod(value,NULL);
+	}
+	err = vertex ? SETVANV(g,name,&numbers) : SETEANV(g,name,&numbers);
+cleanup:
+	igraph_vector_destroy(&numbers);
+	return err;
+}
+
+/* gives one column of values to igraph, objects are taken in the given
+ * order if any. Columns holding only numbers are numeric unless typed
+ * is 0 */
+static int dot_column_build(igraph_t *g, struct dot_column *col, int vertex,
+		int typed, unsigned long count, unsigned long *order, struct dot_cstr *cname,
+		struct dot_cstr *cvalue)
+{
+	igraph_strvector_t values;
+	const struct dot_slice *s;
+	const char *name,*value;
+	unsigned long i;
+	int err;
+
+	name = dot_cstr(cname,&col->name);
+	if(name == NULL)
+		return 1;
+
+	for(i = 0; typed && i < count; i++)
+	{
+		s = dot_value(col,order,i);
+		typed = ggen_is_number(s->s,s->len);
+	}
+	if(typed && count > 0)
+		return dot_column_numbers(g,name,col,vertex,count,order,cvalue);
+
+	err = igraph_strvector_init(&values,count);
+	if(err) return err;
+
+	for(i = 0; i < count; i++)
+	{
+		s = dot_value(col,order,i);
+		/* igraph strings are empty by default */
+		if(s->len == 0)
+			continue;
+		value = dot_cstr(cvalue,s);
+		err = value == NULL || igraph_strvector_set(&values,i,value);
+		if(err) goto cleanup;
+	}
+	if(vertex)
+		err = SETVASV(g,name,&values);
+	else
+		err = SETEASV(g,name,&values);
+cleanup:
+	igraph_strvector_destroy(&values);
+	return err;
+}
+
+static int dot_build(struct dot_parser *p, igraph_t *g)
+{
+	igraph_vector_t edges;
+	struct dot_cstr cname = { NULL, 0 },cvalue = { NULL, 0 };
+	struct dot_column vnames;
+	unsigned long *order,*start;
+	unsigned long i,from;
+	const char *name,*value;
+	int err = 1;
+
+	/* edge ids follow the order of cgraph: grouped by tail in order of
+	 * appearance, a counting sort keeps that stable */
+	start = calloc(p->vcount + 1,sizeof(unsigned long));
+	order = malloc((p->ecount + 1)*sizeof(unsigned long));
+	if(start == NULL || order == NULL)
+		goto error_mem;
+
+	for(i = 0; i < p->ecount; i++)
+		start[p->edges[2*i] + 1]++;
+	for(i = 0; i < p->vcount; i++)
+		start[i+1] += start[i];
+	for(i = 0; i < p->ecount; i++)
+		order[start[p->edges[2*i]]++] = i;
+
+	err = igraph_vector_init(&edges,2*p->ecount);
+	if(err) goto error_mem;
+	for(i = 0; i < p->ecount; i++)
+	{
+		from = order[i];
+		VECTOR(edges)[2*i] = p->edges[2*from];
+		VECTOR(edges)[2*i+1] = p->edges[2*from+1];
+	}
+
+	err = igraph_empty(g,p->vcount,1);
+	if(err) goto error_e;
+	err = igraph_add_edges(g,&edges,NULL);
+	if(err) goto error;
+
+	/* graph properties, and the name of the graph */
+	for(i = 0; i < p->gattrs.count; i++)
+	{
+		name = dot_cstr(&cname,&p->gattrs.cols[i].name);
+		value = dot_cstr(&cvalue,&p->gattrs.cols[i].def);
+		err = name == NULL || value == NULL || ggen_set_graph_attr(g,name,value);
+		if(err) goto error;
+	}
+	if(ggen_attr_wanted(GGEN_OBJECT_GRAPH,GGEN_GRAPH_NAME_ATTR,strlen(GGEN_GRAPH_NAME_ATTR)))
+	{
+		value = dot_cstr(&cvalue,&p->name);
+		err = value == NULL || SETGAS(g,GGEN_GRAPH_NAME_ATTR,value);
+		if(err) goto error;
+	}
+
+	/* vertex properties, vertex names are a column without default */
+	for(i = 0; i < p->vattrs.count; i++)
+	{
+		err = dot_column_build(g,&p->vattrs.cols[i],1,1,p->vcount,NULL,&cname,&cvalue);
+		if(err) goto error;
+	}
+	vnames.name.s = GGEN_VERTEX_NAME_ATTR;
+	vnames.name.len = strlen(GGEN_VERTEX_NAME_ATTR);
+	vnames.def = dot_empty;
+	vnames.values = p->vnames;
+	vnames.size = p->vcount;
+	if(ggen_attr_wanted(GGEN_OBJECT_VERTEX,vnames.name.s,vnames.name.len))
+	{
+		err = dot_column_build(g,&vnames,1,0,p->vcount,NULL,&cname,&cvalue);
+		if(err) goto error;
+	}
+
+	for(i = 0; i < p->eattrs.count; i++)
+	{
+		err = dot_column_build(g,&p->eattrs.cols[i],0,1,p->ecount,order,&cname,&cvalue);
+		if(err) goto error;
+	}
+	goto error_e;
+error:
+	igraph_destroy(g);
+error_e:
+	igraph_vector_destroy(&edges);
+error_mem:
+	free(cname.buf);
+	free(cvalue.buf);
+	free(start);
+	free(order);
+	return err;
+}
+
+static void dot_parser_destroy(struct dot_parser *p)
+{
+	struct dot_chunk *c;
+
+	while(p->chunks != NULL)
+	{
+		c = p->chunks;
+		p->chunks = c->next;
+		free(c);
+	}
+	dot_columns_destroy(&p->gattrs);
+	dot_columns_destroy(&p->vattrs);
+	dot_columns_destroy(&p->eattrs);
+	free(p->vnames);
+	free(p->table);
+	free(p->edges);
+	free(p->row);
+	free(p->chain);
+}
+
+static int dot_read_native(igraph_t *g, const char *data, size_t len)
+{
+	struct dot_parser p;
+	int err;
+
+	memset(&p,0,sizeof(p));
+	p.start = p.cur = data;
+	p.end = data + len;
+
+	err = dot_parse(&p);
+	if(err == DOT_UNSUPPORTED)
+		debug("Native DOT reader stopped at offset %lu\n",
+				(unsigned long)(p.cur - p.start));
+	if(!err)
+		err = dot_build(&p,g);
+	dot_parser_destroy(&p);
+	return err;
+}
+
+int ggen_stream_dot(const char *data, size_t len, struct ggen_stream *s)
+{
+	struct dot_parser p;
+	int err;
+
+	memset(&p,0,sizeof(p));
+	p.start = p.cur = data;
+	p.end = data + len;
+	p.stream = s;
+
+	err = dot_parse(&p);
+	if(err == DOT_UNSUPPORTED)
+	{
+		debug("DOT input cannot be streamed from offset %lu\n",
+				(unsigned long)(p.cur - p.start));
+		err = GGEN_STREAM_UNSUPPORTED;
+	}
+	dot_parser_destroy(&p);
+	return err;
+}
+
+/* end of the first graph of a file holding several of them: only
+ * comments, strings and braces matter */
+size_t ggen_dot_graph_end(const char *data, size_t len)
+{
+	struct dot_parser p;
+	const char *c;
+	unsigned long depth = 0;
+	int seen = 0;
+
+	memset(&p,0,sizeof(p));
+	p.start = p.cur = data;
+	p.end = data + len;
+	for(;;)
+	{
+		dot_skip(&p);
+		if(p.tok == DOT_OTHER)
+			return len;
+		if(p.cur == p.end)
+			return seen ? len : 0;
+
+		seen = 1;
+		c = p.cur;
+		if(*c == '"')
+		{
+			for(c++; c < p.end && *c != '"'; c++)
+				if(*c == '\\' && c + 1 < p.end)
+					c++;
+			c++;
+		}
+		else if(*c == '<')
+		{
+			/* HTML strings nest */
+			for(depth = 0; c < p.end; c++)
+				if(*c == '<')
+					depth++;
+				else if(*c == '>' && --depth == 0)
+					break;
+			c++;
+			depth = 0;
+		}
+		else if(*c == '{')
+		{
+			depth++;
+			c++;
+		}
+		else if(*c == '}')
+		{
+			c++;
+			if(depth && --depth == 0)
+				return c - data;
+		}
+		else
+			c++;
+		p.cur = c < p.end ? c : p.end;
+	}
+}
+
+int ggen_read_graph_dot(igraph_t *g, char *data, size_t len)
+{
+	FILE *f;
+	int err;
+
+	err = dot_read_native(g,data,len);
+	if(err)
+	{
+		/* the input cannot be rewound, give cgraph our copy */
+		debug("Falling back to cgraph for DOT input\n");
+		f = fmemopen(data,len,"r");
+		if(f == NULL)
+			return 1;
+		err = ggen_read_graph_cgraph(g,f);
+		fclose(f);
+	}
+	return err;
+}
+
+/**********************************************************
+ * streaming writer
+ *********************************************************/
+
+struct dot_stream {
+	struct ggen_stream s;
+	struct dot_out o;
+	struct dot_cstr c;
+	int open;
+};
+
+static void dot_stream_id(struct dot_stream *d, const struct ggen_field *f)
+{
+	struct dot_slice s = { f->s, f->len };
+	const char *c;
+
+	c = dot_cstr(&d->c,&s);
+	if(c == NULL)
+		d->o.err = 1;
+	else
+		out_id(&d->o,c);
+}
+
+static void dot_stream_vertex_id(struct dot_stream *d, unsigned long id,
+		const struct ggen_field *name)
+{
+	if(name != NULL)
+		dot_stream_id(d,name);
+	else
+		out_ulong(&d->o,id);
+}
+
+static void dot_stream_attrs(struct dot_stream *d, unsigned long nattrs,
+		const struct ggen_field *attrs)
+{
+	unsigned long i;
+
+	for(i = 0; i < nattrs; i++)
+	{
+		out_str(&d->o,i ? ", " : "\t[");
+		dot_stream_id(d,&attrs[2*i]);
+		out_mem(&d->o,"=",1);
+		dot_stream_id(d,&attrs[2*i+1]);
+	}
+	if(nattrs)
+		out_mem(&d->o,"]",1);
+}
+
+static void dot_stream_open(struct dot_stream *d, const struct ggen_field *name)
+{
+	if(d->open)
+		return;
+	out_str(&d->o,"digraph ");
+	if(name != NULL)
+		dot_stream_id(d,name);
+	else
+		out_str(&d->o,GGEN_DEFAULT_GRAPH_NAME);
+	out_str(&d->o," {\n");
+	d->open = 1;
+}
+
+static int dot_stream_graph(struct ggen_stream *s, const struct ggen_field *name)
+{
+	struct dot_stream *d = (struct dot_stream *)s;
+
+	dot_stream_open(d,name);
+	return d->o.err;
+}
+
+static int dot_stream_attr(struct ggen_stream *s, enum ggen_object kind,
+		const struct ggen_field *name, const struct ggen_field *value)
+{
+	static const char *kinds[] = { "\tgraph [", "\tnode [", "\tedge [" };
+	struct dot_stream *d = (struct dot_stream *)s;
+
+	dot_stream_open(d,NULL);
+	out_str(&d->o,kinds[kind]);
+	dot_stream_id(d,name);
+	out_mem(&d->o,"=",1);
+	dot_stream_id(d,value);
+	out_str(&d->o,"];\n");
+	return d->o.err;
+}
+
+static int dot_stream_vertex(struct ggen_stream *s, unsigned long id,
+		const struct ggen_field *name, unsigned long nattrs,
+		const struct ggen_field *attrs)
+{
+	struct dot_stream *d = (struct dot_stream *)s;
+
+	dot_stream_open(d,NULL);
+	out_mem(&d->o,"\t",1);
+	dot_stream_vertex_id(d,id,name);
+	dot_stream_attrs(d,nattrs,attrs);
+	out_str(&d->o,";\n");
+	return d->o.err;
+}
+
+static int dot_stream_edge(struct ggen_stream *s, unsigned long from,
+		const struct ggen_field *fname, unsigned long to,
+		const struct ggen_field *tname, unsigned long nattrs,
+		const struct ggen_field *attrs)
+{
+	struct dot_stream *d = (struct dot_stream *)s;
+
+	dot_stream_open(d,NULL);
+	out_mem(&d->o,"\t",1);
+	dot_stream_vertex_id(d,from,fname);
+	out_str(&d->o," -> ");
+	dot_stream_vertex_id(d,to,tname);
+	dot_stream_attrs(d,nattrs,attrs);
+	out_str(&d->o,";\n");
+	return d->o.err;
+}
+
+static int dot_stream_close(struct ggen_stream *s)
+{
+	struct dot_stream *d = (struct dot_stream *)s;
+	int err;
+
+	dot_stream_open(d,NULL);
+	out_str(&d->o,"}\n");
+	out_flush(&d->o);
+	err = d->o.err || fflush(d->o.f) != 0;
+	free(d->o.buf);
+	free(d->c.buf);
+	free(d);
+	return err;
+}
+
+/* objects are written as they come, in a single pass */
+struct ggen_stream *ggen_stream_dot_writer(FILE *output)
+{
+	struct dot_stream *d;
+
+	d = calloc(1,sizeof(struct dot_stream));
+	if(d == NULL)
+		return NULL;
+	d->o.f = output;
+	d->o.buf = malloc(DOT_BUFFER_SIZE);
+	if(d->o.buf == NULL)
+	{
+		free(d);
+		return NULL;
+	}
+	d->s.graph = dot_stream_graph;
+	d->s.attr = dot_stream_attr;
+	d->s.vertex = dot_stream_vertex;
+	d->s.edge = dot_stream_edge;
+	d->s.passes = 1;
+	d->s.close = dot_stream_close;
+	return &d->s;
+}
@@ -0,0 +1,400 @@
+/* Copyright Swann Perarnau 2009
+ *
+ *   contributor(s) :
+ *
+ *   contact : Swann.Perarnau@imag.fr
+ *
+ * This software is a computer program whose purpose is to help the
+ * random generation of graph structures and adding various properties
+ * on those structures.
+ *
+ * This software is governed by the CeCILL  license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+/* GGen is a random graph generator :
+ * it provides means to generate a graph following a
+ * collection of methods found in the litterature.
+ *
+ * This is a research project founded by the MOAIS Team,
+ * INRIA, Grenoble Universities.
+ */
+
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ggen.h"
+
+/* Edge sinks provided by the library.
+ * The igraph sink accumulates edges in a vector and builds the graph at
+ * the end, the others write the edges as soon as they receive them.
+ */
+
+/**********************************************************
+ * igraph sink
+ *********************************************************/
+
+struct igraph_sink {
+	igraph_t *g;
+	igraph_vector_t edges;
+	int init;		// edges has been initialized
+};
+
+static int igraph_sink_begin(struct ggen_edge_sink *s, unsigned long n, unsigned long m)
+{
+	struct igraph_sink *d = s->data;
+	int err;
+
+	err = igraph_vector_init(&d->edges,0);
+	if(err) return err;
+	d->init = 1;
+
+	return igraph_vector_reserve(&d->edges,2*(long)m);
+}
+
+static int igraph_sink_edges(struct ggen_edge_sink *s, const unsigned long *edges,
+		unsigned long count)
+{
+	struct igraph_sink *d = s->data;
+	unsigned long i;
+	int err;
+
+	for(i = 0; i < 2*count; i++)
+	{
+		err = igraph_vector_push_back(&d->edges,edges[i]);
+		if(err) return err;
+	}
+	return 0;
+}
+
+static int igraph_sink_end(struct ggen_edge_sink *s, unsigned long n)
+{
+	struct igraph_sink *d = s->data;
+	return igraph_create(d->g,&d->edges,n,1);
+}
+
+static void igraph_sink_destroy(struct ggen_edge_sink *s)
+{
+	struct igraph_sink *d = s->data;
+	if(d->init)
+		igraph_vector_destroy(&d->edges);
+	free(d);
+}
+
+struct ggen_edge_sink *ggen_edge_sink_igraph(igraph_t *g)
+{
+	struct ggen_edge_sink *s;
+	struct igraph_sink *d;
+
+	if(g == NULL)
+		return NULL;
+
+	s = malloc(sizeof(struct ggen_edge_sink));
+	d = malloc(sizeof(struct igraph_sink));
+	if(s == NULL || d == NULL)
+	{
+		free(s);
+		free(d);
+		return NULL;
+	}
+	d->g = g;
+	d->init = 0;
+
+	s->begin = igraph_sink_begin;
+	s->edges = igraph_sink_edges;
+	s->end = igraph_sink_end;
+	s->destroy = igraph_sink_destroy;
+	s->data = d;
+	return s;
+}
+
+/**********************************************************
+ * dot sink
+ *********************************************************/
+
+/* The output mimics the one of agwrite on the graphs built by
+ * ggen_write_graph: every vertex is declared, by index, before the
+ * edges, so that isolated vertices are kept.
+ */
+struct dot_sink {
+	FILE *out;
+	char *name;
+	unsigned long n;	// vertices declared so far
+};
+
+static int dot_sink_vertices(struct dot_sink *d, unsigned long n)
+{
+	for(; d->n < n; d->n++)
+		if(fprintf(d->out,"\t%lu;\n",d->n) < 0)
+			return 1;
+	return 0;
+}
+
+static int dot_sink_begin(struct ggen_edge_sink *s, unsigned long n, unsigned long m)
+{
+	struct dot_sink *d = s->data;
+
+	if(fprintf(d->out,"digraph %s {\n",d->name) < 0)
+		return 1;
+	return dot_sink_vertices(d,n);
+}
+
+static int dot_sink_edges(struct ggen_edge_sink *s, const unsigned long *edges,
+		unsigned long count)
+{
+	struct dot_sink *d = s->data;
+	unsigned long i;
+
+	for(i = 0; i < count; i++)
+		if(fprintf(d->out,"\t%lu -> %lu;\n",edges[2*i],edges[2*i+1]) < 0)
+			return 1;
+	return 0;
+}
+
+static int dot_sink_end(struct ggen_edge_sink *s, unsigned long n)
+{
+	struct dot_sink *d = s->data;
+
+	// vertices created after begin are declared at the end
+	if(dot_sink_vertices(d,n))
+		return 1;
+	if(fprintf(d->out,"}\n") < 0)
+		return 1;
+	return fflush(d->out) != 0;
+}
+
+static void dot_sink_destroy(struct ggen_edge_sink *s)
+{
+	struct dot_sink *d = s->data;
+	free(d->name);
+	free(d);
+}
+
+struct ggen_edge_sink *ggen_edge_sink_dot(FILE *output, const char *name)
+{
+	struct ggen_edge_sink *s;
+	struct dot_sink *d;
+
+	if(output == NULL || name == NULL)
+		return NULL;
+
+	s = malloc(sizeof(struct ggen_edge_sink));
+	d = malloc(sizeof(struct dot_sink));
+	if(s == NULL || d == NULL)
+		goto error;
+
+	d->name = strdup(name);
+	if(d->name == NULL)
+		goto error;
+	d->out = output;
+	d->n = 0;
+
+	s->begin = dot_sink_begin;
+	s->edges = dot_sink_edges;
+	s->end = dot_sink_end;
+	s->destroy = dot_sink_destroy;
+	s->data = d;
+	return s;
+error:
+	free(s);
+	free(d);
+	return NULL;
+}
+
+/**********************************************************
+ * binary sink
+ *********************************************************/
+
+/* Format (all integers little endian):
+ *  8 bytes  magic "GGENEDGE"
+ *  4 bytes  version (1)
+ *  4 bytes  width of a vertex id in bytes (4 or 8)
+ *  8 bytes  number of vertices
+ *  8 bytes  number of edges
+ * followed by the edges as (from,to) pairs of ids.
+ * The counts are only known at the end: they are patched if the output
+ * is seekable, and left to all ones otherwise.
+ */
+#define BINARY_SINK_MAGIC "GGENEDGE"
+#define BINARY_SINK_VERSION 1
+#define BINARY_SINK_COUNTS 16
+
+struct binary_sink {
+	FILE *out;
+	long start;		// position of the header, -1 if not seekable
+	unsigned int width;
+	unsigned long m;	// edges written
+};
+
+static int write_le(FILE *out, uint64_t v, unsigned int width)
+{
+	unsigned char buf[8];
+	unsigned int i;
+
+	for(i = 0; i < width; i++)
+		buf[i] = (v >> (8*i)) & 0xff;
+	return fwrite(buf,1,width,out) != width;
+}
+
+static int binary_sink_begin(struct ggen_edge_sink *s, unsigned long n, unsigned long m)
+{
+	struct binary_sink *d = s->data;
+	int err;
+
+	// the final number of vertices can exceed n: keep some margin
+	d->width = (n <= UINT32_MAX/2) ? 4 : 8;
+	d->start = ftell(d->out);
+
+	if(fwrite(BINARY_SINK_MAGIC,1,8,d->out) != 8)
+		return 1;
+	err = write_le(d->out,BINARY_SINK_VERSION,4);
+	err = err || write_le(d->out,d->width,4);
+	err = err || write_le(d->out,UINT64_MAX,8);
+	err = err || write_le(d->out,UINT64_MAX,8);
+	return err;
+}
+
+static int binary_sink_edges(struct ggen_edge_sink *s, const unsigned long *edges,
+		unsigned long count)
+{
+	struct binary_sink *d = s->data;
+	unsigned long i;
+
+	for(i = 0; i < 2*count; i++)
+		if(write_le(d->out,edges[i],d->width))
+			return 1;
+	d->m += count;
+	return 0;
+}
+
+static int binary_sink_end(struct ggen_edge_sink *s, unsigned long n)
+{
+	struct binary_sink *d = s->data;
+	long end;
+	int err;
+
+	if(d->start >= 0 && (end = ftell(d->out)) >= 0 &&
+			fseek(d->out,d->start + BINARY_SINK_COUNTS,SEEK_SET) == 0)
+	{
+		err = write_le(d->out,n,8);
+		err = err || write_le(d->out,d->m,8);
+		err = err || fseek(d->out,end,SEEK_SET);
+		if(err) return 1;
+	}
+	return fflush(d->out) != 0;
+}
+
+static void binary_sink_destroy(struct ggen_edge_sink *s)
+{
+	free(s->data);
+}
+
+struct ggen_edge_sink *ggen_edge_sink_binary(FILE *output)
+{
+	struct ggen_edge_sink *s;
+	struct binary_sink *d;
+
+	if(output == NULL)
+		return NULL;
+
+	s = malloc(sizeof(struct ggen_edge_sink));
+	d = malloc(sizeof(struct binary_sink));
+	if(s == NULL || d == NULL)
+	{
+		free(s);
+		free(d);
+		return NULL;
+	}
+	d->out = output;
+	d->m = 0;
+
+	s->begin = binary_sink_begin;
+	s->edges = binary_sink_edges;
+	s->end = binary_sink_end;
+	s->destroy = binary_sink_destroy;
+	s->data = d;
+	return s;
+}
+
+/**********************************************************
+ * edge list sink
+ *********************************************************/
+
+/* one "from to" line per edge, isolated vertices are lost */
+static int edgelist_sink_begin(struct ggen_edge_sink *s, unsigned long n, unsigned long m)
+{
+	return 0;
+}
+
+static int edgelist_sink_edges(struct ggen_edge_sink *s, const unsigned long *edges,
+		unsigned long count)
+{
+	FILE *out = s->data;
+	unsigned long i;
+
+	for(i = 0; i < count; i++)
+		if(fprintf(out,"%lu %lu\n",edges[2*i],edges[2*i+1]) < 0)
+			return 1;
+	return 0;
+}
+
+static int edgelist_sink_end(struct ggen_edge_sink *s, unsigned long n)
+{
+	return fflush((FILE *)s->data) != 0;
+}
+
+static void edgelist_sink_destroy(struct ggen_edge_sink *s)
+{
+}
+
+struct ggen_edge_sink *ggen_edge_sink_edgelist(FILE *output)
+{
+	struct ggen_edge_sink *s;
+
+	if(output == NULL)
+		return NULL;
+
+	s = malloc(sizeof(struct ggen_edge_sink));
+	if(s == NULL)
+		return NULL;
+
+	s->begin = edgelist_sink_begin;
+	s->edges = edgelist_sink_edges;
+	s->end = edgelist_sink_end;
+	s->destroy = edgelist_sink_destroy;
+	s->data = output;
+	return s;
+}
+
+void ggen_edge_sink_free(struct ggen_edge_sink *s)
+{
+	if(s == NULL)
+		return;
+	s->destroy(s);
+	free(s);
+}
@@ -0,0 +1,90 @@
+/* Copyright Swann Perarnau 2009
+ *
+ *   contributor(s) :
+ *
+ *   contact : Swann.Perarnau@imag.fr
+ *
+ * This software is a computer program whose purpose is to help the
+ * random generation of graph structures and adding various properties
+ * on those structures.
+ *
+ * This software is governed by the CeCILL  license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+/* GGen is a random graph generator :
+ * it provides means to generate a graph following a
+ * collection of methods found in the litterature.
+ *
+ * This is a research project founded by the MOAIS Team,
+ * INRIA, Grenoble Universities.
+ */
+
+
+
+#ifndef EDGE_SINK_H
+#define EDGE_SINK_H 1
+
+#include "ggen.h"
+
+/* Generators accumulate edges in a small buffer on their stack and
+ * hand them to the sink once it is full, so that the cost of the
+ * callback is paid once per batch instead of once per edge.
+ * This is private to the library.
+ */
+#define EDGE_BATCH_SIZE 1024
+
+struct edge_batch {
+	struct ggen_edge_sink *sink;
+	unsigned long count;	// number of edges in the buffer
+	unsigned long edges[2*EDGE_BATCH_SIZE];
+};
+
+static inline void edge_batch_init(struct edge_batch *b, struct ggen_edge_sink *s)
+{
+	b->sink = s;
+	b->count = 0;
+}
+
+static inline int edge_batch_flush(struct edge_batch *b)
+{
+	int err = 0;
+
+	if(b->count)
+		err = b->sink->edges(b->sink,b->edges,b->count);
+	b->count = 0;
+	return err;
+}
+
+static inline int edge_batch_push(struct edge_batch *b, unsigned long from, unsigned long to)
+{
+	b->edges[2*b->count] = from;
+	b->edges[2*b->count+1] = to;
+	if(++b->count == EDGE_BATCH_SIZE)
+		return edge_batch_flush(b);
+	return 0;
+}
+
+#endif // EDGE_SINK_H
@@ -0,0 +1,1365 @@
+/* Copyright Swann Perarnau 2009
+*
+*   contact : Swann.Perarnau@imag.fr
+*
+* This software is a computer program whose purpose is to help the
+* random generation of graph structures and adding various properties
+* on those structures.
+*
+* This software is governed by the CeCILL  license under French law and
+* abiding by the rules of distribution of free software.  You can  use,
+* modify and/ or redistribute the software under the terms of the CeCILL
+* license as circulated by CEA, CNRS and INRIA at the following URL
+* "http://www.cecill.info".
+*
+* As a counterpart to the access to the source code and  rights to copy,
+* modify and redistribute granted by the license, users are provided only
+* with a limited warranty  and the software's author,  the holder of the
+* economic rights,  and the successive licensors  have only  limited
+* liability.
+*
+* In this respect, the user's attention is drawn to the risks associated
+* with loading,  using,  modifying and/or developing or reproducing the
+* software by the user in light of its specific status of free software,
+* that may mean  that it is complicated to manipulate,  and  that  also
+* therefore means  that it is reserved for developers  and  experienced
+* professionals having in-depth computer knowledge. Users are therefore
+* encouraged to load and test the software's suitability as regards their
+* requirements in conditions enabling the security of their systems and/or
+* data to be ensured and,  more generally, to use and operate it in the
+* same conditions as regards security.
+*
+* The fact that you are presently reading this means that you have had
+* knowledge of the CeCILL license and that you accept its terms.
+*/
+
+/* Edge lists:
+ * one edge per line, "from to [values...]", fields being separated by
+ * blanks or commas (so that CSV files can be read too) and quoted when
+ * they contain one of those. Lines starting with '#' are comments, except
+ * a first line naming as many columns as the first edge has. Extra columns
+ * become edge attributes, named after the header or weight, weight2...
+ *
+ * Vertices are either all numbers, used as ids, or names given ids by
+ * order of appearance and kept in the vertex name attribute. Numbers far
+ * bigger than the number of edges are read as names too, so that a single
+ * huge id does not create billions of isolated vertices.
+ *
+ * The input is cut into chunks at line boundaries, each parsed by one of
+ * ggen_io_threads threads. Chunks are then merged in order, numbers and edges being
+ * converted in parallel again.
+ */
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "log.h"
+
+/* a chunk is at least that big, so that small inputs use one thread */
+#define EL_MIN_CHUNK (1 << 20)
+#define EL_DEFAULT_COLUMN "weight"
+/* isolated vertices numbers can create before being read as names */
+#define EL_MAX_ISOLATED (1 << 20)
+
+struct el_field {
+	const char *s;
+	size_t len;
+};
+
+/* quoted fields with escaped quotes are copied in a list of blocks */
+struct el_copy {
+	struct el_copy *next;
+	char data[];
+};
+
+enum el_error {
+	EL_OK,
+	EL_NOMEM,
+	EL_SYNTAX,
+	/* a vertex is not a number, names are needed */
+	EL_NAMED
+};
+
+struct el_chunk {
+	const char *start;
+	const char *end;
+	int named;
+
+	unsigned long lines;
+	unsigned long size;
+	/* two per edge, as numbers or names */
+	unsigned long *ids;
+	struct el_field *names;
+	unsigned long max;
+
+	/* extra columns, NULL fields are missing values */
+	unsigned long ncols;
+	struct el_field **cols;
+	unsigned long *counts;
+	int *numeric;
+	struct el_copy *copies;
+
+	enum el_error err;
+	const char *where;
+
+	/* merge */
+	unsigned long offset;
+	igraph_vector_t *edges;
+	igraph_vector_t *numbers;
+	unsigned long col;
+};
+
+static int el_is_blank(char c)
+{
+	return c == ' ' || c == '\t' || c == ',' || c == '\r';
+}
+
+/* next field of the line, returns 0 at the end of the line */
+static int el_field(struct el_chunk *c, const char **cur, const char *end,
+		struct el_field *f)
+{
+	const char *p = *cur,*q;
+	struct el_copy *copy;
+	int escaped = 0;
+	char *d;
+
+	while(p < end && el_is_blank(*p))
+		p++;
+	if(p == end || *p == '\n')
+	{
+		*cur = p;
+		return 0;
+	}
+
+	if(*p != '"')
+	{
+		f->s = p;
+		while(p < end && *p != '\n' && !el_is_blank(*p))
+			p++;
+		f->len = p - f->s;
+		*cur = p;
+		return 1;
+	}
+
+	/* quoted, "" is a quote */
+	for(q = ++p; q < end && *q != '\n'; q++)
+	{
+		if(*q != '"')
+			continue;
+		if(q + 1 < end && q[1] == '"')
+		{
+			escaped = 1;
+			q++;
+		}
+		else
+			break;
+	}
+	if(q == end || *q != '"')
+	{
+		c->err = EL_SYNTAX;
+		c->where = p;
+		return 0;
+	}
+	*cur = q + 1;
+	if(!escaped)
+	{
+		f->s = p;
+		f->len = q - p;
+		return 1;
+	}
+
+	copy = malloc(sizeof(struct el_copy) + (q - p));
+	if(copy == NULL)
+	{
+		c->err = EL_NOMEM;
+		return 0;
+	}
+	copy->next = c->copies;
+	c->copies = copy;
+	for(d = copy->data; p < q; p++)
+	{
+		*d++ = *p;
+		if(*p == '"')
+			p++;
+	}
+	f->s = copy->data;
+	f->len = d - copy->data;
+	return 1;
+}
+
+static int el_number(const struct el_field *f, unsigned long *v)
+{
+	unsigned long r = 0;
+	size_t i;
+
+	if(f->len == 0 || f->len > 19)
+		return 0;
+	for(i = 0; i < f->len; i++)
+	{
+		if(f->s[i] < '0' || f->s[i] > '9')
+			return 0;
+		r = 10*r + (f->s[i] - '0');
+	}
+	*v = r;
+	return 1;
+}
+
+/* n vertices for m edges: at least n - 2m of them are isolated */
+static int el_sparse(unsigned long n, unsigned long m)
+{
+	return n > 2*m && n - 2*m > EL_MAX_ISOLATED;
+}
+
+static int el_grow(struct el_chunk *c)
+{
+	unsigned long size,i;
+	void *tmp;
+
+	size = c->size ? 2*c->size : 4096;
+	if(c->named)
+		tmp = realloc(c->names,2*size*sizeof(struct el_field));
+	else
+		tmp = realloc(c->ids,2*size*sizeof(unsigned long));
+	if(tmp == NULL)
+		return 1;
+	if(c->named)
+		c->names = tmp;
+	else
+		c->ids = tmp;
+
+	for(i = 0; i < c->ncols; i++)
+	{
+		tmp = realloc(c->cols[i],size*sizeof(struct el_field));
+		if(tmp == NULL)
+			return 1;
+		c->cols[i] = tmp;
+		memset(c->cols[i] + c->size,0,(size - c->size)*sizeof(struct el_field));
+	}
+	c->size = size;
+	return 0;
+}
+
+static int el_add_column(struct el_chunk *c)
+{
+	void *tmp;
+	unsigned long i = c->ncols;
+
+	tmp = realloc(c->cols,(i + 1)*sizeof(struct el_field *));
+	if(tmp == NULL)
+		return 1;
+	c->cols = tmp;
+	tmp = realloc(c->counts,(i + 1)*sizeof(unsigned long));
+	if(tmp == NULL)
+		return 1;
+	c->counts = tmp;
+	tmp = realloc(c->numeric,(i + 1)*sizeof(int));
+	if(tmp == NULL)
+		return 1;
+	c->numeric = tmp;
+
+	c->cols[i] = calloc(c->size ? c->size : 1,sizeof(struct el_field));
+	if(c->cols[i] == NULL)
+		return 1;
+	c->counts[i] = 0;
+	c->numeric[i] = 1;
+	c->ncols++;
+	return 0;
+}
+
+static void el_chunk_parse(struct el_chunk *c)
+{
+	const char *cur = c->start,*line;
+	struct el_field f[2],v;
+	unsigned long i,k,id;
+
+	while(cur < c->end && c->err == EL_OK)
+	{
+		line = cur;
+		while(cur < c->end && el_is_blank(*cur))
+			cur++;
+		/* comments and empty lines */
+		if(cur == c->end || *cur == '\n' || *cur == '#')
+			goto next;
+
+		if(!el_field(c,&cur,c->end,&f[0]) || !el_field(c,&cur,c->end,&f[1]))
+		{
+			if(c->err == EL_OK)
+				c->err = EL_SYNTAX;
+			c->where = line;
+			return;
+		}
+
+		if(c->lines == c->size && el_grow(c))
+			goto nomem;
+
+		k = c->lines;
+		for(i = 0; i < 2; i++)
+		{
+			if(c->named)
+				c->names[2*k+i] = f[i];
+			else if(el_number(&f[i],&id))
+			{
+				c->ids[2*k+i] = id;
+				if(id >= c->max)
+					c->max = id + 1;
+			}
+			else
+			{
+				c->err = EL_NAMED;
+				return;
+			}
+		}
+
+		for(i = 0; el_field(c,&cur,c->end,&v); i++)
+		{
+			if(i == c->ncols && el_add_column(c))
+				goto nomem;
+			c->cols[i][k] = v;
+			c->counts[i]++;
+			if(c->numeric[i])
+				c->numeric[i] = ggen_is_number(v.s,v.len);
+		}
+		if(c->err != EL_OK)
+			return;
+		c->lines++;
+next:
+		while(cur < c->end && *cur != '\n')
+			cur++;
+		if(cur < c->end)
+			cur++;
+	}
+	return;
+nomem:
+	c->err = EL_NOMEM;
+}
+
+static void *el_parse_worker(void *arg)
+{
+	el_chunk_parse(arg);
+	return NULL;
+}
+
+/* merge: edges and numeric columns are written in place by each chunk */
+static void *el_edges_worker(void *arg)
+{
+	struct el_chunk *c = arg;
+	unsigned long i;
+
+	for(i = 0; i < 2*c->lines; i++)
+		VECTOR(*c->edges)[2*c->offset + i] = c->ids[i];
+	return NULL;
+}
+
+static void *el_numbers_worker(void *arg)
+{
+	struct el_chunk *c = arg;
+	struct el_field *f;
+	char tmp[128],*s;
+	unsigned long i;
+
+	for(i = 0; i < c->lines; i++)
+	{
+		f = &c->cols[c->col][i];
+		/* numbers are usually short, long ones (zero padded) go to the heap */
+		s = f->len < sizeof(tmp) ? tmp : malloc(f->len + 1);
+		if(s == NULL)
+		{
+			c->err = EL_NOMEM;
+			return NULL;
+		}
+		memcpy(s,f->s,f->len);
+		s[f->len] = '\0';
+		VECTOR(*c->numbers)[c->offset + i] = strtod(s,NULL);
+		if(s != tmp)
+			free(s);
+	}
+	return NULL;
+}
+
+/* runs fn on every chunk, one thread each */
+static int el_run(struct el_chunk *chunks, unsigned long count, void *(*fn)(void *))
+{
+	pthread_t *tids;
+	unsigned long i,started;
+
+	if(count == 1)
+	{
+		fn(chunks);
+		return 0;
+	}
+	tids = malloc(count*sizeof(pthread_t));
+	if(tids == NULL)
+		return 1;
+	for(started = 0; started < count; started++)
+		if(pthread_create(&tids[started],NULL,fn,&chunks[started]))
+			break;
+	/* whatever could not be started is done here */
+	for(i = started; i < count; i++)
+		fn(&chunks[i]);
+	for(i = 0; i < started; i++)
+		pthread_join(tids[i],NULL);
+	free(tids);
+	return 0;
+}
+
+static void el_chunk_reset(struct el_chunk *c)
+{
+	struct el_copy *copy;
+	unsigned long i;
+
+	while(c->copies != NULL)
+	{
+		copy = c->copies;
+		c->copies = copy->next;
+		free(copy);
+	}
+	for(i = 0; i < c->ncols; i++)
+		free(c->cols[i]);
+	free(c->cols);
+	free(c->counts);
+	free(c->numeric);
+	free(c->ids);
+	free(c->names);
+	c->cols = NULL;
+	c->counts = NULL;
+	c->numeric = NULL;
+	c->ids = NULL;
+	c->names = NULL;
+	c->ncols = c->lines = c->size = c->max = 0;
+	c->err = EL_OK;
+}
+
+/* the header names the extra columns, c keeps the names that had to be
+ * unescaped. A first comment is only a header if it has as many fields as
+ * the first edge, other comments are left alone */
+static unsigned long el_header(struct el_chunk *c, const char *data, size_t len,
+		struct el_field **names, const char **body)
+{
+	const char *cur = data,*end,*last = data + len;
+	struct el_field f,*tmp;
+	unsigned long count = 0,fields = 0;
+	int err;
+
+	*names = NULL;
+	*body = data;
+	if(len == 0 || data[0] != '#')
+		return 0;
+	end = memchr(data,'\n',len);
+	if(end == NULL)
+		end = data + len;
+	*body = end;
+
+	cur++;
+	while(el_field(c,&cur,end,&f))
+	{
+		tmp = realloc(*names,(count + 1)*sizeof(struct el_field));
+		if(tmp == NULL)
+			break;
+		*names = tmp;
+		(*names)[count++] = f;
+	}
+
+	/* fields of the first edge */
+	err = c->err;
+	for(cur = end; cur < last; )
+	{
+		while(cur < last && el_is_blank(*cur))
+			cur++;
+		if(cur < last && *cur != '\n' && *cur != '#')
+		{
+			while(el_field(c,&cur,last,&f))
+				fields++;
+			break;
+		}
+		while(cur < last && *cur != '\n')
+			cur++;
+		if(cur < last)
+			cur++;
+	}
+	c->err = err;
+
+	if(count < 2 || count != fields)
+	{
+		free(*names);
+		*names = NULL;
+		return 0;
+	}
+	/* the first two are the vertices */
+	return count;
+}
+
+/* ids of named vertices, by order of appearance */
+struct el_names {
+	struct el_field *names;
+	unsigned long count;
+	unsigned long *table;
+	unsigned long mask;
+};
+
+static unsigned long el_hash(const struct el_field *f)
+{
+	unsigned long h = 14695981039346656037UL;
+	size_t i;
+
+	for(i = 0; i < f->len; i++)
+	{
+		h ^= (unsigned char)f->s[i];
+		h *= 1099511628211UL;
+	}
+	return h;
+}
+
+static unsigned long el_name_id(struct el_names *n, const struct el_field *f)
+{
+	unsigned long h = el_hash(f) & n->mask;
+	struct el_field *o;
+
+	while(n->table[h])
+	{
+		o = &n->names[n->table[h] - 1];
+		if(o->len == f->len && !memcmp(o->s,f->s,f->len))
+			return n->table[h] - 1;
+		h = (h + 1) & n->mask;
+	}
+	n->names[n->count] = *f;
+	n->table[h] = ++n->count;
+	return n->count - 1;
+}
+
+static int el_set_strings(igraph_t *g, const char *name, struct el_chunk *chunks,
+		unsigned long nchunks, unsigned long col, unsigned long count, int vertex,
+		struct el_field *names)
+{
+	igraph_strvector_t values;
+	struct el_field *f;
+	char *tmp = NULL,*t;
+	size_t size = 0;
+	unsigned long i,k,id = 0;
+	int err;
+
+	err = igraph_strvector_init(&values,count);
+	if(err) return err;
+
+	for(k = 0; k < (vertex ? 1 : nchunks); k++)
+		for(i = 0; i < (vertex ? count : chunks[k].lines); i++, id++)
+		{
+			if(vertex)
+				f = &names[i];
+			else if(col < chunks[k].ncols)
+				f = &chunks[k].cols[col][i];
+			else
+				continue;
+			/* missing and empty values are the default */
+			if(f->s == NULL || f->len == 0)
+				continue;
+			if(f->len >= size)
+			{
+				t = realloc(tmp,f->len + 1);
+				if(t == NULL)
+				{
+					err = 1;
+					goto cleanup;
+				}
+				tmp = t;
+				size = f->len + 1;
+			}
+			memcpy(tmp,f->s,f->len);
+			tmp[f->len] = '\0';
+			err = igraph_strvector_set(&values,id,tmp);
+			if(err) goto cleanup;
+		}
+	err = vertex ? SETVASV(g,name,&values) : SETEASV(g,name,&values);
+cleanup:
+	free(tmp);
+	igraph_strvector_destroy(&values);
+	return err;
+}
+
+static int el_build(igraph_t *g, struct el_chunk *chunks, unsigned long nchunks,
+		struct el_field *header, unsigned long nheader)
+{
+	igraph_vector_t edges,numbers;
+	struct el_names names = { NULL, 0, NULL, 0 };
+	unsigned long i,k,m,n,ncols,size;
+	char cname[GGEN_DEFAULT_NAME_SIZE];
+	int err = 1,named = chunks[0].named,numeric;
+
+	m = n = ncols = 0;
+	for(k = 0; k < nchunks; k++)
+	{
+		chunks[k].offset = m;
+		m += chunks[k].lines;
+		if(chunks[k].max > n)
+			n = chunks[k].max;
+		if(chunks[k].ncols > ncols)
+			ncols = chunks[k].ncols;
+	}
+
+	err = igraph_vector_init(&edges,2*m);
+	if(err) return err;
+
+	if(named)
+	{
+		for(size = 16; size < 4*m; size *= 2);
+		names.names = malloc((2*m + 1)*sizeof(struct el_field));
+		names.table = calloc(size,sizeof(unsigned long));
+		names.mask = size - 1;
+		if(names.names == NULL || names.table == NULL)
+			goto cleanup;
+		for(k = 0; k < nchunks; k++)
+			for(i = 0; i < 2*chunks[k].lines; i++)
+				VECTOR(edges)[2*chunks[k].offset + i] =
+					el_name_id(&names,&chunks[k].names[i]);
+		n = names.count;
+	}
+	else
+	{
+		for(k = 0; k < nchunks; k++)
+			chunks[k].edges = &edges;
+		if(el_run(chunks,nchunks,el_edges_worker))
+			goto cleanup;
+	}
+
+	err = igraph_empty(g,n,1);
+	if(err) goto cleanup;
+	err = igraph_add_edges(g,&edges,NULL);
+	if(err) goto error;
+
+	if(named && ggen_attr_wanted(GGEN_OBJECT_VERTEX,GGEN_VERTEX_NAME_ATTR,
+				strlen(GGEN_VERTEX_NAME_ATTR)))
+	{
+		err = el_set_strings(g,GGEN_VERTEX_NAME_ATTR,NULL,0,0,n,1,names.names);
+		if(err) goto error;
+	}
+
+	for(i = 0; i < ncols; i++)
+	{
+		if(i + 2 < nheader)
+		{
+			size = header[i+2].len < GGEN_DEFAULT_NAME_SIZE ?
+				header[i+2].len : GGEN_DEFAULT_NAME_SIZE - 1;
+			memcpy(cname,header[i+2].s,size);
+			cname[size] = '\0';
+		}
+		else if(i == 0)
+			strcpy(cname,EL_DEFAULT_COLUMN);
+		else
+			snprintf(cname,GGEN_DEFAULT_NAME_SIZE,EL_DEFAULT_COLUMN "%lu",i + 1);
+		if(!ggen_attr_wanted(GGEN_OBJECT_EDGE,cname,strlen(cname)))
+			continue;
+
+		/* numeric if every edge has a number */
+		numeric = m > 0;
+		for(k = 0; k < nchunks && numeric; k++)
+			numeric = chunks[k].lines == 0 || (i < chunks[k].ncols &&
+					chunks[k].numeric[i] && chunks[k].counts[i] == chunks[k].lines);
+
+		if(!numeric)
+		{
+			err = el_set_strings(g,cname,chunks,nchunks,i,m,0,NULL);
+			if(err) goto error;
+			continue;
+		}
+
+		err = igraph_vector_init(&numbers,m);
+		if(err) goto error;
+		for(k = 0; k < nchunks; k++)
+		{
+			chunks[k].numbers = &numbers;
+			chunks[k].col = i;
+		}
+		err = el_run(chunks,nchunks,el_numbers_worker);
+		for(k = 0; k < nchunks && !err; k++)
+			err = chunks[k].err != EL_OK;
+		err = err || SETEANV(g,cname,&numbers);
+		igraph_vector_destroy(&numbers);
+		if(err) goto error;
+	}
+	goto cleanup;
+error:
+	igraph_destroy(g);
+cleanup:
+	free(names.names);
+	free(names.table);
+	igraph_vector_destroy(&edges);
+	return err;
+}
+
+int ggen_read_graph_edgelist(igraph_t *g, const char *data, size_t len)
+{
+	struct el_chunk *chunks,hc;
+	struct el_field *header;
+	const char *body,*end = data + len,*cut;
+	unsigned long nheader,nchunks,k,m,n;
+	int err = 1,named = 0;
+
+	memset(&hc,0,sizeof(hc));
+	nheader = el_header(&hc,data,len,&header,&body);
+
+	/* cut the input at line boundaries */
+	nchunks = (end - body)/EL_MIN_CHUNK + 1;
+	if(nchunks > ggen_io_threads)
+		nchunks = ggen_io_threads ? ggen_io_threads : 1;
+	chunks = calloc(nchunks,sizeof(struct el_chunk));
+	if(chunks == NULL)
+		goto cleanup;
+
+	for(k = 0; k < nchunks; k++)
+	{
+		cut = body + (end - body)/nchunks*(k + 1);
+		if(k == nchunks - 1)
+			cut = end;
+		else
+		{
+			cut = memchr(cut,'\n',end - cut);
+			cut = cut == NULL ? end : cut + 1;
+		}
+		chunks[k].start = k ? chunks[k-1].end : body;
+		chunks[k].end = cut > chunks[k].start ? cut : chunks[k].start;
+	}
+	info("Parsing edge list with %lu threads\n",nchunks);
+
+	/* vertices are numbers, until proved otherwise */
+	for(;;)
+	{
+		for(k = 0; k < nchunks; k++)
+		{
+			el_chunk_reset(&chunks[k]);
+			chunks[k].named = named;
+		}
+		if(el_run(chunks,nchunks,el_parse_worker))
+			goto cleanup;
+		for(k = 0, m = n = 0; k < nchunks; k++)
+		{
+			if(chunks[k].err == EL_NAMED)
+				break;
+			m += chunks[k].lines;
+			if(chunks[k].max > n)
+				n = chunks[k].max;
+		}
+		if(named || (k == nchunks && !el_sparse(n,m)))
+			break;
+		if(k == nchunks)
+			info("Vertex ids of the edge list are sparse, read as names\n");
+		else
+			info("Vertices of the edge list are named\n");
+		named = 1;
+	}
+
+	for(k = 0; k < nchunks; k++)
+	{
+		if(chunks[k].err == EL_SYNTAX)
+		{
+			error("Invalid edge list at byte %lu\n",
+					(unsigned long)(chunks[k].where - data));
+			goto cleanup;
+		}
+		if(chunks[k].err != EL_OK)
+			goto cleanup;
+	}
+
+	err = el_build(g,chunks,nchunks,header,nheader);
+cleanup:
+	if(chunks != NULL)
+		for(k = 0; k < nchunks; k++)
+			el_chunk_reset(&chunks[k]);
+	free(chunks);
+	free(header);
+	el_chunk_reset(&hc);
+	return err;
+}
+
+/* fields are quoted when they would not be read back as one */
+static void el_write_mem(FILE *out, const char *s, size_t len)
+{
+	size_t i;
+
+	for(i = 0; i < len; i++)
+		if(strchr(" \t\r\n,\"#",s[i]) != NULL)
+			break;
+	if(len > 0 && i == len)
+	{
+		fwrite(s,1,len,out);
+		return;
+	}
+	putc('"',out);
+	for(i = 0; i < len; i++)
+	{
+		if(s[i] == '"')
+			putc('"',out);
+		putc(s[i],out);
+	}
+	putc('"',out);
+}
+
+static void el_write_field(FILE *out, const char *s)
+{
+	el_write_mem(out,s,strlen(s));
+}
+
+static void el_write_vertex(FILE *out, igraph_t *g, int named, unsigned long id)
+{
+	const char *s;
+
+	if(named)
+	{
+		s = VAS(g,GGEN_VERTEX_NAME_ATTR,id);
+		if(s != NULL)
+		{
+			el_write_field(out,s);
+			return;
+		}
+	}
+	fprintf(out,"%lu",id);
+}
+
+int ggen_write_graph_edgelist(igraph_t *g, FILE *output)
+{
+	igraph_strvector_t gnames,vnames,enames;
+	igraph_vector_t gtypes,vtypes,etypes;
+	igraph_integer_t from,to;
+	unsigned long i,ecount,vcount,lost,max = 0;
+	char tmp[GGEN_DEFAULT_NAME_SIZE],*touched;
+	int named = 0,sparse,err = 1;
+	long j;
+
+	ecount = igraph_ecount(g);
+	vcount = igraph_vcount(g);
+	touched = calloc(vcount + 1,1);
+	if(touched == NULL)
+		return 1;
+
+	igraph_strvector_init(&gnames,0);
+	igraph_strvector_init(&vnames,0);
+	igraph_strvector_init(&enames,0);
+	igraph_vector_init(&gtypes,0);
+	igraph_vector_init(&vtypes,0);
+	igraph_vector_init(&etypes,0);
+
+	if(igraph_cattribute_list(g,&gnames,&gtypes,&vnames,&vtypes,&enames,&etypes))
+		goto cleanup;
+
+	for(j = 0; j < igraph_strvector_size(&vnames); j++)
+		if(!strcmp(STR(vnames,j),GGEN_VERTEX_NAME_ATTR) &&
+				VECTOR(vtypes)[j] == IGRAPH_ATTRIBUTE_STRING)
+			named = 1;
+
+	/* only edges and their attributes can be written */
+	if(igraph_strvector_size(&vnames) > named || igraph_strvector_size(&gnames) > 1)
+		info("Edge lists only keep edge attributes\n");
+
+	/* isolated vertices are lost, unless ids below the biggest one
+	 * keep them */
+	for(i = 0; i < ecount; i++)
+	{
+		igraph_edge(g,i,&from,&to);
+		touched[(unsigned long)from] = touched[(unsigned long)to] = 1;
+		if((unsigned long)from >= max)
+			max = from + 1;
+		if((unsigned long)to >= max)
+			max = to + 1;
+	}
+	sparse = el_sparse(max,ecount);
+	for(i = 0, lost = 0; i < vcount; i++)
+		lost += !touched[i] && (named || sparse || i >= max);
+	if(lost > 0)
+		warning("%lu isolated vertices are lost in the edge list\n",lost);
+
+	if(igraph_strvector_size(&enames) > 0)
+	{
+		fputs("# source target",output);
+		for(j = 0; j < igraph_strvector_size(&enames); j++)
+		{
+			putc(' ',output);
+			el_write_field(output,STR(enames,j));
+		}
+		putc('\n',output);
+	}
+
+	for(i = 0; i < ecount; i++)
+	{
+		igraph_edge(g,i,&from,&to);
+		el_write_vertex(output,g,named,(unsigned long)from);
+		putc(' ',output);
+		el_write_vertex(output,g,named,(unsigned long)to);
+		for(j = 0; j < igraph_strvector_size(&enames); j++)
+		{
+			putc(' ',output);
+			if(VECTOR(etypes)[j] == IGRAPH_ATTRIBUTE_NUMERIC)
+			{
+				d2s(EAN(g,STR(enames,j),i),tmp,GGEN_DEFAULT_NAME_SIZE);
+				fputs(tmp,output);
+			}
+			else
+				el_write_field(output,EAS(g,STR(enames,j),i));
+		}
+		if(putc('\n',output) == EOF)
+			goto cleanup;
+	}
+	err = fflush(output) != 0;
+cleanup:
+	free(touched);
+	igraph_strvector_destroy(&gnames);
+	igraph_strvector_destroy(&vnames);
+	igraph_strvector_destroy(&enames);
+	igraph_vector_destroy(&gtypes);
+	igraph_vector_destroy(&vtypes);
+	igraph_vector_destroy(&etypes);
+	return err;
+}
+
+/**********************************************************
+ * streaming
+ *********************************************************/
+
+/* names of the vertices met so far, growing as needed */
+struct el_map {
+	struct el_field *names;
+	unsigned long count;
+	unsigned long *table;
+	unsigned long size;
+};
+
+static int el_map_id(struct el_map *m, const struct el_field *f, unsigned long *id)
+{
+	unsigned long h,i,size,*table;
+	struct el_field *o;
+
+	if(2*(m->count + 1) > m->size)
+	{
+		size = m->size ? 2*m->size : 1024;
+		table = calloc(size,sizeof(unsigned long));
+		o = realloc(m->names,size/2*sizeof(struct el_field));
+		if(table == NULL || o == NULL)
+		{
+			free(table);
+			if(o != NULL)
+				m->names = o;
+			return 1;
+		}
+		m->names = o;
+		for(i = 0; i < m->count; i++)
+		{
+			h = el_hash(&m->names[i]) & (size - 1);
+			while(table[h])
+				h = (h + 1) & (size - 1);
+			table[h] = i + 1;
+		}
+		free(m->table);
+		m->table = table;
+		m->size = size;
+	}
+
+	h = el_hash(f) & (m->size - 1);
+	while(m->table[h])
+	{
+		o = &m->names[m->table[h] - 1];
+		if(o->len == f->len && !memcmp(o->s,f->s,f->len))
+		{
+			*id = m->table[h] - 1;
+			return 0;
+		}
+		h = (h + 1) & (m->size - 1);
+	}
+	m->names[m->count] = *f;
+	m->table[h] = ++m->count;
+	*id = m->count - 1;
+	return 0;
+}
+
+/* are all vertices numbers, not too sparse to be ids */
+static int el_numbered(struct el_chunk *c, const char *cur, const char *end)
+{
+	struct el_field f[2];
+	unsigned long id[2],m = 0,n = 0;
+
+	while(cur < end && c->err == EL_OK)
+	{
+		while(cur < end && el_is_blank(*cur))
+			cur++;
+		if(cur < end && *cur != '\n' && *cur != '#'
+				&& el_field(c,&cur,end,&f[0]) && el_field(c,&cur,end,&f[1]))
+		{
+			if(!el_number(&f[0],&id[0]) || !el_number(&f[1],&id[1]))
+				return 0;
+			m++;
+			if(id[0] >= n)
+				n = id[0] + 1;
+			if(id[1] >= n)
+				n = id[1] + 1;
+		}
+		while(cur < end && *cur != '\n')
+			cur++;
+		if(cur < end)
+			cur++;
+	}
+	return !el_sparse(n,m);
+}
+
+/* lines go to the stream one by one, in a single thread */
+int ggen_stream_edgelist(const char *data, size_t len, struct ggen_stream *s)
+{
+	struct el_chunk c;
+	struct el_field *header,f[2];
+	struct ggen_field *cols = NULL,*fields = NULL,names[2];
+	struct el_map map = { NULL, 0, NULL, 0 };
+	const char *body,*cur,*end = data + len,*line;
+	unsigned long nheader,ncols = 0,nrow,size = 0,id[2],i;
+	char cname[GGEN_DEFAULT_NAME_SIZE],*copy;
+	void *tmp;
+	int named,err = 1;
+
+	memset(&c,0,sizeof(c));
+	nheader = el_header(&c,data,len,&header,&body);
+	named = !el_numbered(&c,body,end);
+	c.err = EL_OK;
+
+	if(s->graph(s,NULL))
+		goto cleanup;
+	for(cur = body; cur < end; )
+	{
+		line = cur;
+		while(cur < end && el_is_blank(*cur))
+			cur++;
+		if(cur == end || *cur == '\n' || *cur == '#')
+			goto next;
+
+		if(!el_field(&c,&cur,end,&f[0]) || !el_field(&c,&cur,end,&f[1]))
+			goto syntax;
+		for(i = 0; i < 2; i++)
+		{
+			names[i].s = f[i].s;
+			names[i].len = f[i].len;
+			if(named ? el_map_id(&map,&f[i],&id[i]) : !el_number(&f[i],&id[i]))
+				goto cleanup;
+		}
+
+		for(nrow = 0; el_field(&c,&cur,end,&f[0]); nrow++)
+		{
+			/* columns are named after the header, or weight, weight2... */
+			if(nrow == ncols)
+			{
+				tmp = realloc(cols,(ncols + 1)*sizeof(struct ggen_field));
+				if(tmp == NULL)
+					goto cleanup;
+				cols = tmp;
+				if(nrow + 2 < nheader)
+				{
+					cols[ncols].s = header[nrow+2].s;
+					cols[ncols].len = header[nrow+2].len;
+				}
+				else
+				{
+					if(nrow == 0)
+						strcpy(cname,EL_DEFAULT_COLUMN);
+					else
+						snprintf(cname,GGEN_DEFAULT_NAME_SIZE,EL_DEFAULT_COLUMN "%lu",nrow + 1);
+					copy = strdup(cname);
+					if(copy == NULL)
+						goto cleanup;
+					cols[ncols].s = copy;
+					cols[ncols].len = strlen(copy);
+				}
+				ncols++;
+			}
+			if(2*(nrow + 1) > size)
+			{
+				size = size ? 2*size : 16;
+				tmp = realloc(fields,size*sizeof(struct ggen_field));
+				if(tmp == NULL)
+					goto cleanup;
+				fields = tmp;
+			}
+			fields[2*nrow] = cols[nrow];
+			fields[2*nrow+1].s = f[0].s;
+			fields[2*nrow+1].len = f[0].len;
+		}
+		if(c.err != EL_OK)
+			goto syntax;
+		if(s->edge(s,id[0],named ? &names[0] : NULL,id[1],named ? &names[1] : NULL,nrow,fields))
+			goto cleanup;
+next:
+		while(cur < end && *cur != '\n')
+			cur++;
+		if(cur < end)
+			cur++;
+	}
+	err = 0;
+	goto cleanup;
+syntax:
+	if(c.err != EL_NOMEM)
+		error("Invalid edge list at byte %lu\n",(unsigned long)(line - data));
+cleanup:
+	for(i = 0; i < ncols; i++)
+		if(i + 2 >= nheader)
+			free((char *)cols[i].s);
+	free(cols);
+	free(fields);
+	free(map.names);
+	free(map.table);
+	free(header);
+	el_chunk_reset(&c);
+	return err;
+}
+
+/* the first pass finds the edge attributes, which the header names */
+struct el_stream {
+	struct ggen_stream s;
+	FILE *out;
+	unsigned int pass;
+	/* edge attributes and their default values, copied */
+	struct ggen_field *cols;
+	struct ggen_field *defs;
+	unsigned long ncols;
+	/* values of the edge being written */
+	const struct ggen_field **values;
+	/* vertices met on the first pass, to find the isolated ones */
+	unsigned char *seen;
+	unsigned long nseen;
+	unsigned long max;
+	unsigned long edges;
+	int named;
+	int dropped;
+	int err;
+};
+
+#define EL_SEEN_VERTEX 1
+#define EL_SEEN_EDGE 2
+
+static void el_stream_seen(struct el_stream *e, unsigned long id, unsigned char how)
+{
+	unsigned long size;
+	void *tmp;
+
+	if(id >= e->nseen)
+	{
+		for(size = e->nseen ? e->nseen : 1024; size <= id; size *= 2);
+		tmp = realloc(e->seen,size);
+		if(tmp == NULL)
+		{
+			e->err = 1;
+			return;
+		}
+		e->seen = tmp;
+		memset(e->seen + e->nseen,0,size - e->nseen);
+		e->nseen = size;
+	}
+	e->seen[id] |= how;
+}
+
+static int el_field_eq(const struct ggen_field *a, const struct ggen_field *b)
+{
+	return a->len == b->len && !memcmp(a->s,b->s,a->len);
+}
+
+static int el_field_copy(struct ggen_field *to, const struct ggen_field *from)
+{
+	char *s;
+
+	s = malloc(from->len + 1);
+	if(s == NULL)
+		return 1;
+	memcpy(s,from->s,from->len);
+	s[from->len] = '\0';
+	to->s = s;
+	to->len = from->len;
+	return 0;
+}
+
+static long el_stream_column(struct el_stream *e, const struct ggen_field *name)
+{
+	unsigned long i;
+	void *tmp;
+
+	for(i = 0; i < e->ncols; i++)
+		if(el_field_eq(&e->cols[i],name))
+			return i;
+	if(e->pass > 0)
+		return -1;
+
+	tmp = realloc(e->cols,(e->ncols + 1)*sizeof(struct ggen_field));
+	if(tmp == NULL)
+		return -1;
+	e->cols = tmp;
+	tmp = realloc(e->defs,(e->ncols + 1)*sizeof(struct ggen_field));
+	if(tmp == NULL)
+		return -1;
+	e->defs = tmp;
+	if(el_field_copy(&e->cols[e->ncols],name))
+		return -1;
+	e->defs[e->ncols].s = NULL;
+	return e->ncols++;
+}
+
+static int el_stream_graph(struct ggen_stream *s, const struct ggen_field *name)
+{
+	return 0;
+}
+
+static int el_stream_attr(struct ggen_stream *s, enum ggen_object kind,
+		const struct ggen_field *name, const struct ggen_field *value)
+{
+	struct el_stream *e = (struct el_stream *)s;
+	long i;
+
+	if(kind != GGEN_OBJECT_EDGE)
+	{
+		e->dropped = 1;
+		return 0;
+	}
+	if(e->pass > 0)
+		return 0;
+	i = el_stream_column(e,name);
+	if(i < 0)
+		return 1;
+	free((char *)e->defs[i].s);
+	return el_field_copy(&e->defs[i],value);
+}
+
+static int el_stream_vertex(struct ggen_stream *s, unsigned long id,
+		const struct ggen_field *name, unsigned long nattrs,
+		const struct ggen_field *attrs)
+{
+	struct el_stream *e = (struct el_stream *)s;
+
+	e->dropped = e->dropped || nattrs > 0;
+	if(e->pass == 0)
+	{
+		e->named = e->named || name != NULL;
+		el_stream_seen(e,id,EL_SEEN_VERTEX);
+	}
+	return 0;
+}
+
+static void el_stream_vertex_id(FILE *out, unsigned long id, const struct ggen_field *name)
+{
+	if(name != NULL)
+		el_write_mem(out,name->s,name->len);
+	else
+		fprintf(out,"%lu",id);
+}
+
+static int el_stream_edge(struct ggen_stream *s, unsigned long from,
+		const struct ggen_field *fname, unsigned long to,
+		const struct ggen_field *tname, unsigned long nattrs,
+		const struct ggen_field *attrs)
+{
+	struct el_stream *e = (struct el_stream *)s;
+	unsigned long i;
+	long k;
+
+	if(e->pass == 0)
+	{
+		for(i = 0; i < nattrs; i++)
+			if(el_stream_column(e,&attrs[2*i]) < 0)
+				return 1;
+		e->named = e->named || fname != NULL || tname != NULL;
+		el_stream_seen(e,from,EL_SEEN_EDGE);
+		el_stream_seen(e,to,EL_SEEN_EDGE);
+		if(from >= e->max)
+			e->max = from + 1;
+		if(to >= e->max)
+			e->max = to + 1;
+		e->edges++;
+		return 0;
+	}
+	if(e->err)
+		return e->err;
+
+	for(i = 0; i < e->ncols; i++)
+		e->values[i] = &e->defs[i];
+	for(i = 0; i < nattrs; i++)
+	{
+		k = el_stream_column(e,&attrs[2*i]);
+		if(k >= 0)
+			e->values[k] = &attrs[2*i+1];
+	}
+
+	el_stream_vertex_id(e->out,from,fname);
+	putc(' ',e->out);
+	el_stream_vertex_id(e->out,to,tname);
+	for(i = 0; i < e->ncols; i++)
+	{
+		putc(' ',e->out);
+		if(e->values[i]->s != NULL)
+			el_write_mem(e->out,e->values[i]->s,e->values[i]->len);
+		else
+			el_write_mem(e->out,"",0);
+	}
+	return putc('\n',e->out) == EOF;
+}
+
+/* header of the output, once the attributes are known */
+static void el_stream_pass(struct ggen_stream *s, unsigned int pass)
+{
+	struct el_stream *e = (struct el_stream *)s;
+	unsigned long i,lost = 0;
+	int sparse;
+
+	e->pass = pass;
+	if(pass == 0)
+		return;
+	/* like ggen_write_graph_edgelist */
+	sparse = el_sparse(e->max,e->edges);
+	for(i = 0; i < e->nseen; i++)
+		lost += e->seen[i] == EL_SEEN_VERTEX && (e->named || sparse || i >= e->max);
+	if(lost > 0)
+		warning("%lu isolated vertices are lost in the edge list\n",lost);
+	if(e->ncols == 0)
+		return;
+	e->values = malloc(e->ncols*sizeof(struct ggen_field *));
+	if(e->values == NULL)
+	{
+		e->err = 1;
+		return;
+	}
+	fputs("# source target",e->out);
+	for(i = 0; i < e->ncols; i++)
+	{
+		putc(' ',e->out);
+		el_write_mem(e->out,e->cols[i].s,e->cols[i].len);
+	}
+	putc('\n',e->out);
+}
+
+static int el_stream_close(struct ggen_stream *s)
+{
+	struct el_stream *e = (struct el_stream *)s;
+	unsigned long i;
+	int err;
+
+	if(e->dropped)
+		info("Edge lists only keep edge attributes\n");
+	err = e->err || fflush(e->out) != 0;
+	for(i = 0; i < e->ncols; i++)
+	{
+		free((char *)e->cols[i].s);
+		free((char *)e->defs[i].s);
+	}
+	free(e->cols);
+	free(e->defs);
+	free(e->values);
+	free(e->seen);
+	free(e);
+	return err;
+}
+
+struct ggen_stream *ggen_stream_edgelist_writer(FILE *output)
+{
+	struct el_stream *e;
+
+	e = calloc(1,sizeof(struct el_stream));
+	if(e == NULL)
+		return NULL;
+	e->out = output;
+	e->s.graph = el_stream_graph;
+	e->s.attr = el_stream_attr;
+	e->s.vertex = el_stream_vertex;
+	e->s.edge = el_stream_edge;
+	e->s.passes = 2;
+	e->s.pass = el_stream_pass;
+	e->s.close = el_stream_close;
+	return &e->s;
+}
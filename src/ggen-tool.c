@@ -49,6 +49,7 @@
 #include <fcntl.h>
 #include <string.h>
 #include <getopt.h>
+#include <sys/wait.h>
 
 #include "builtin.h"
 #include "ggen.h"
@@ -71,6 +72,17 @@ static const char * general_help[] = {
 	"--edge                  : manipulate an edge property\n",
 	"--vertex                : manipulate a vertex property \n",
 	"--name       <string>   : use string as name\n",
+	"--threads    <int>      : split the work between int threads\n",
+	"--count      <int>      : generate int graphs in a single run\n",
+	"--writer     <name>     : dot writer to use, native (default) or cgraph\n",
+	"--input-format <fmt>    : read graphs as dot, binary or edgelist,\n",
+	"                          dot or binary is guessed by default\n",
+	"--output-format <fmt>   : write graphs as dot (default), binary or edgelist\n",
+	"--output-pattern <fmt>  : with --count, write graph i to the file named\n",
+	"                          by the printf format fmt, e.g. out-%05d.dot\n",
+	"--vertex-cost <name>    : vertex property giving the cost of each vertex\n",
+	"--edge-cost  <name>     : edge property giving the cost of each edge\n",
+	"--earliest-start        : also print the earliest start of each vertex\n",
 	"NOTE: most of these options are only available on some commands\n",
 	"\nEnvironment Variables:\n",
 	"GSL_RNG_SEED             : use this environment variable to change the RNG seed\n",
@@ -82,15 +94,17 @@ static const char * general_help[] = {
 	"transform-graph         : use the graph transformation tools\n",
 	"add-property            : use the property adding tools\n",
 	"analyse-property        : extract a property from the graph\n",
+	"convert                 : convert a graph to another format\n",
 	NULL
 };
 
 static struct first_lvl_cmd cmd_table[] = {
-	{ "generate-graph" , cmds_generate, NEED_OUTPUT | IS_GRAPH_P | NEED_RNG, help_generate },
-	{ "analyse-graph", cmds_analyse, NEED_INPUT, help_analyse },
-	{ "transform-graph", cmds_transform, NEED_INPUT | NEED_OUTPUT, help_transform },
-	{ "add-property", cmds_add_prop, NEED_INPUT | NEED_OUTPUT | NEED_RNG | NEED_NAME | NEED_TYPE, help_add_prop },
-	{ "analyse-property", cmds_analyse_prop, NEED_INPUT | NEED_NAME | NEED_TYPE, help_analyse_prop },
+	{ "generate-graph" , cmds_generate, NEED_RNG | NEED_THREADS | NEED_BATCH | NEED_SINK, help_generate },
+	{ "analyse-graph", cmds_analyse, NEED_INPUT | NEED_THREADS | NEED_CORPUS | NEED_COSTS, help_analyse },
+	{ "transform-graph", cmds_transform, NEED_INPUT | NEED_OUTPUT | NEED_THREADS | NEED_CORPUS, help_transform },
+	{ "add-property", cmds_add_prop, NEED_INPUT | NEED_OUTPUT | NEED_RNG | NEED_NAME | NEED_TYPE | NEED_THREADS, help_add_prop },
+	{ "analyse-property", cmds_analyse_prop, NEED_INPUT | NEED_NAME | NEED_TYPE | NEED_THREADS | NEED_CORPUS, help_analyse_prop },
+	{ "convert", cmds_convert, NEED_INPUT | NEED_STREAM | NEED_THREADS, help_convert },
 };
 
 static const char *ggen_version_string = PACKAGE_STRING;
@@ -101,6 +115,11 @@ static int ask_version = 0;
 static char* rngfname = NULL;
 static char* infname = NULL;
 static char* outfname = NULL;
+static char* threadsval = NULL;
+static char* countval = NULL;
+static char* writerval = NULL;
+static char* informatval = NULL;
+static char* outformatval = NULL;
 
 /* logging variables */
 static char* logfname = NULL;
@@ -130,12 +149,17 @@ static char* logval = NULL;
 
 /* global variables */
 igraph_t g;
-igraph_t *g_p = NULL;
 gsl_rng *rng = NULL;
 FILE *infile = NULL;
 FILE *outfile = NULL;
 char *name = NULL;
 int ptype = -1;
+unsigned long nthreads = 0;
+unsigned long ngraphs = 0;
+char *outpattern = NULL;
+char *vcostname = NULL;
+char *ecostname = NULL;
+int ask_start = 0;
 
 /* all command line arguments */
 static struct option long_options[] = {
@@ -153,10 +177,23 @@ static struct option long_options[] = {
 	{ "name", required_argument, NULL, 'n' },
 	{ "edge", no_argument, &ptype, EDGE_PROPERTY },
 	{ "vertex", no_argument, &ptype, VERTEX_PROPERTY },
+	/* parallelism */
+	{ "threads", required_argument, NULL, 't' },
+	{ "writer", required_argument, NULL, 'w' },
+	/* graph formats */
+	{ "input-format", required_argument, NULL, 'I' },
+	{ "output-format", required_argument, NULL, 'O' },
+	/* scheduling analyses */
+	{ "vertex-cost", required_argument, NULL, 'C' },
+	{ "edge-cost", required_argument, NULL, 'E' },
+	{ "earliest-start", no_argument, &ask_start, 1 },
+	/* batch mode */
+	{ "count", required_argument, NULL, 'c' },
+	{ "output-pattern", required_argument, NULL, 'p' },
 	{ 0, 0, 0, 0},
 };
 
-static const char* short_opts = "hVi:o:r:n:f:l:";
+static const char* short_opts = "hVi:o:r:n:f:l:t:c:p:w:C:E:";
 
 void print_help(const char **message) {
 	for(int i=0; message[i] != NULL; i++)
@@ -171,13 +208,21 @@ void print_first_lvl_help(struct first_lvl_cmd *fl)
 	fprintf(stdout,"\n%s:\n\n",fl->name);
 	fprintf(stdout,"Valid Options: output");
 	if(fl->flags & NEED_INPUT)
-		fprintf(stdout,", input");
+		fprintf(stdout,", input, input-format");
+	if(fl->flags & (NEED_OUTPUT | NEED_SINK))
+		fprintf(stdout,", output-format");
 	if(fl->flags & NEED_RNG)
 		fprintf(stdout,", rng");
 	if(fl->flags & NEED_TYPE)
 		fprintf(stdout,", edge, vertex");
 	if(fl->flags & NEED_NAME)
 		fprintf(stdout,", name");
+	if(fl->flags & NEED_THREADS)
+		fprintf(stdout,", threads");
+	if(fl->flags & NEED_BATCH)
+		fprintf(stdout,", count, output-pattern");
+	if(fl->flags & NEED_COSTS)
+		fprintf(stdout,", vertex-cost, edge-cost, earliest-start");
 	fprintf(stdout,"\n");
 	print_help(fl->help);
 	for(int i = 0; fl->cmds[i].name != NULL; i++)
@@ -199,8 +244,248 @@ void print_version()
 	fprintf(stdout,"ggen: version %s\n",ggen_version_string);
 }
 
+/* corpus mode: every graph of the input goes through the command.
+ * igraph is not thread safe, so graphs are split between worker
+ * processes: worker k handles graphs k, k+w, k+2w... writing the output
+ * of each one to a pipe. We read the pipes in turn, which puts results
+ * back in input order, and pipes being bounded, workers cannot get much
+ * ahead of the output.
+ */
+struct corpus_result {
+	int status;
+	size_t len;
+};
+
+/* run the command on a graph, its output goes in a buffer */
+static int corpus_run(int argc, char **argv, struct first_lvl_cmd *fl,
+		struct second_lvl_cmd *sl, struct ggen_corpus *c, char *data,
+		size_t len, char **res, size_t *rlen)
+{
+	FILE *out;
+	int status;
+
+	*res = NULL;
+	*rlen = 0;
+	out = open_memstream(res,rlen);
+	if(out == NULL)
+		return 1;
+
+	outfile = out;
+	status = ggen_read_graph_data(&g,c->format,data,len);
+	if(!status)
+	{
+		status = sl->fn(argc,argv);
+		if(!status && (fl->flags & NEED_OUTPUT))
+			status = ggen_write_graph(&g,out);
+		igraph_destroy(&g);
+	}
+	if(fclose(out))
+		status = 1;
+	return status;
+}
+
+static int corpus_write(FILE *out, struct ggen_container *ct, const char *data, size_t len)
+{
+	if(ct != NULL)
+		return ggen_container_add(ct,data,len);
+	return fwrite(data,1,len,out) != len;
+}
+
+static int full_write(int fd, const void *buf, size_t len)
+{
+	const char *p = buf;
+	ssize_t n;
+
+	while(len > 0)
+	{
+		n = write(fd,p,len);
+		if(n < 0)
+			return 1;
+		p += n;
+		len -= n;
+	}
+	return 0;
+}
+
+static int full_read(int fd, void *buf, size_t len)
+{
+	char *p = buf;
+	ssize_t n;
+
+	while(len > 0)
+	{
+		n = read(fd,p,len);
+		if(n <= 0)
+			return 1;
+		p += n;
+		len -= n;
+	}
+	return 0;
+}
+
+static void corpus_worker(int argc, char **argv, struct first_lvl_cmd *fl,
+		struct second_lvl_cmd *sl, struct ggen_corpus *c, unsigned long k,
+		unsigned long w, int fd)
+{
+	struct corpus_result r;
+	char *data,*res;
+	size_t len;
+	unsigned long i;
+	int status = 0;
+
+	// the workers already use every thread asked for
+	ggen_io_threads = 1;
+	for(i = 0; !status && ggen_corpus_next(c,&data,&len) == 1; i++)
+	{
+		if(i % w != k)
+			continue;
+		r.status = corpus_run(argc,argv,fl,sl,c,data,len,&res,&r.len);
+		if(r.status)
+			r.len = 0;
+		status = full_write(fd,&r,sizeof(r)) || full_write(fd,res,r.len);
+		free(res);
+	}
+	close(fd);
+	fflush(NULL);
+	_exit(status);
+}
+
+/* the corpus is already in memory, shared by the workers forked from us:
+ * each of them walks every graph boundary, which is cheap next to parsing,
+ * and runs the command on one graph out of w */
+static int handle_corpus(int argc, char **argv, struct first_lvl_cmd *fl,
+		struct second_lvl_cmd *sl, struct ggen_corpus *c)
+{
+	struct ggen_container container,*ct = NULL;
+	struct corpus_result r;
+	FILE *out = outfile;
+	char *data,*res = NULL;
+	size_t len,size = 0;
+	unsigned long i,k,w,failed = 0;
+	pid_t *pids;
+	int *fds,p[2],wstatus,status = 0;
+
+	w = ggen_io_threads;
+	info("Using %lu workers\n",w);
+
+	/* a binary corpus is always written as a container */
+	if((fl->flags & NEED_OUTPUT) && ggen_output_format == GGEN_FORMAT_BINARY)
+	{
+		if(ggen_container_open(&container,out))
+			return 1;
+		ct = &container;
+	}
+
+	if(w == 1)
+	{
+		for(i = 0; !status && ggen_corpus_next(c,&data,&len) == 1; i++)
+		{
+			if(corpus_run(argc,argv,fl,sl,c,data,len,&res,&size))
+			{
+				error("Command failed on graph %lu\n",i);
+				failed++;
+			}
+			else
+				status = corpus_write(out,ct,res,size);
+			free(res);
+		}
+		res = NULL;
+		goto done;
+	}
+
+	pids = calloc(w,sizeof(pid_t));
+	fds = malloc(w*sizeof(int));
+	if(pids == NULL || fds == NULL)
+	{
+		free(pids);
+		free(fds);
+		status = 1;
+		goto done;
+	}
+
+	/* nothing buffered must be written twice */
+	fflush(NULL);
+	for(k = 0; k < w; k++)
+	{
+		if(pipe(p))
+			break;
+		pids[k] = fork();
+		if(pids[k] == 0)
+		{
+			for(i = 0; i < k; i++)
+				close(fds[i]);
+			close(p[0]);
+			corpus_worker(argc,argv,fl,sl,c,k,w,p[1]);
+		}
+		close(p[1]);
+		if(pids[k] < 0)
+		{
+			close(p[0]);
+			break;
+		}
+		fds[k] = p[0];
+	}
+	if(k < w)
+	{
+		error("Failed to start %lu workers\n",w);
+		w = k;
+		status = 1;
+	}
+
+	/* a worker closing its pipe has no graph left, and nor do the
+	 * following ones */
+	for(i = 0; !status && w > 0 && !full_read(fds[i % w],&r,sizeof(r)); i++)
+	{
+		if(r.status)
+		{
+			error("Command failed on graph %lu\n",i);
+			failed++;
+			continue;
+		}
+		if(r.len > size)
+		{
+			free(res);
+			size = r.len;
+			res = malloc(size);
+			if(res == NULL)
+			{
+				status = 1;
+				break;
+			}
+		}
+		status = full_read(fds[i % w],res,r.len) || corpus_write(out,ct,res,r.len);
+	}
+
+	for(k = 0; k < w; k++)
+		close(fds[k]);
+	for(k = 0; k < w; k++)
+		if(waitpid(pids[k],&wstatus,0) < 0 || !WIFEXITED(wstatus) || WEXITSTATUS(wstatus))
+		{
+			if(!status)
+				error("Worker %lu failed\n",k);
+			status = 1;
+		}
+	free(pids);
+	free(fds);
+done:
+	free(res);
+	if(ct != NULL && ggen_container_close(ct))
+		status = 1;
+	if(failed)
+		error("Command failed on %lu graphs\n",failed);
+	else if(!status)
+		normal("Processed %lu graphs\n",i);
+	outfile = out;
+	return status || failed;
+}
+
 int handle_second_lvl(int argc,char **argv,struct first_lvl_cmd *fl, struct second_lvl_cmd *sl)
 {
+	struct ggen_corpus corpus;
+	FILE *raw;
+	char *data;
+	size_t len;
+	int many = 0;
 	int status = 0;
 	// check for help
 	if(ask_help || (argc == 0 && sl->nargs != 0))
@@ -218,6 +503,32 @@ int handle_second_lvl(int argc,char **argv,struct first_lvl_cmd *fl, struct seco
 		error("Wrong number of arguments\n");
 		return 1;
 	}
+	// set name
+	if((fl->flags & NEED_NAME) && name == NULL)
+	{
+		name = "newproperty";
+		info("Property name needed, using %s as default\n",name);
+	}
+	// set type
+	if((fl->flags & NEED_TYPE) && ptype == -1)
+	{
+		ptype = VERTEX_PROPERTY;
+		info("Property type needed, using VERTEX as default\n");
+	}
+	// only the attributes the command uses are read
+	ggen_read_attrs = GGEN_ATTRS_ALL & ~sl->unused;
+	ggen_read_property(GGEN_OBJECT_VERTEX,vcostname);
+	ggen_read_property(GGEN_OBJECT_EDGE,ecostname);
+	if(fl->flags & NEED_NAME)
+	{
+		ggen_read_name = name;
+		if(ptype == EDGE_PROPERTY)
+			ggen_read_kind = GGEN_OBJECT_EDGE;
+		else if(ptype == VERTEX_PROPERTY)
+			ggen_read_kind = GGEN_OBJECT_VERTEX;
+		else
+			ggen_read_kind = GGEN_OBJECT_GRAPH;
+	}
 	// open input
 	if(fl->flags & NEED_INPUT)
 	{
@@ -236,16 +547,60 @@ int handle_second_lvl(int argc,char **argv,struct first_lvl_cmd *fl, struct seco
 		else
 			infile = stdin;
 
-		status = ggen_read_graph(&g,infile);
-		if(infname)
+		// compressed input goes through a decompressing stream
+		raw = infile;
+		infile = ggen_open_input(raw);
+		if(infile == NULL)
+		{
+			error("Failed to open graph input\n");
+			if(raw != stdin)
+				fclose(raw);
+			return 1;
+		}
+		// the command reads the input itself
+		if(fl->flags & NEED_STREAM)
+		{
+			normal("Input configured\n");
+			goto input_done;
+		}
+		status = ggen_corpus_open(&corpus,infile);
+		if(infile != stdin)
 			fclose(infile);
 		if(status)
 		{
 			error("Failed to read graph\n");
-			goto free_ing;
+			return status;
+		}
+		// several graphs: each of them goes through the command later
+		if(fl->flags & NEED_CORPUS)
+		{
+			struct ggen_corpus peek = corpus;
+			unsigned long n = 0;
+			while(n < 2 && ggen_corpus_next(&peek,&data,&len) == 1)
+				n++;
+			many = n > 1;
+		}
+		if(many)
+			normal("Input configured, it holds several graphs\n");
+		else
+		{
+			if(ggen_corpus_next(&corpus,&data,&len) == 1)
+				status = ggen_read_graph_data(&g,corpus.format,data,len);
+			else
+			{
+				error("Empty graph input\n");
+				status = 1;
+			}
+			ggen_corpus_close(&corpus);
+			if(status)
+			{
+				error("Failed to read graph\n");
+				return status;
+			}
+			normal("Input configured and graph read\n");
 		}
-		normal("Input configured and graph read\n");
 	}
+input_done:
 	// load rng
 	if(fl->flags & NEED_RNG)
 	{
@@ -272,18 +627,6 @@ int handle_second_lvl(int argc,char **argv,struct first_lvl_cmd *fl, struct seco
 		}
 		normal("RNG configured\n");
 	}
-	// set name
-	if((fl->flags & NEED_NAME) && name == NULL)
-	{
-		name = "newproperty";
-		info("Property name needed, using %s as default\n",name);
-	}
-	// set type
-	if((fl->flags & NEED_TYPE) && ptype == -1)
-	{
-		ptype = VERTEX_PROPERTY;
-		info("Property type needed, using VERTEX as default\n");
-	}
 
 	// output is a bit different from input:
 	// a command can have its output redirected even
@@ -294,7 +637,7 @@ int handle_second_lvl(int argc,char **argv,struct first_lvl_cmd *fl, struct seco
 	if(outfname)
 	{
 		info("Opening %s for writing\n",outfname);
-		outfile = fopen(outfname,"w");
+		outfile = ggen_fopen_output(outfname);
 		if(!outfile)
 		{
 			warning("Failed to open file %s for output, using stdout instead\n",outfname);
@@ -307,6 +650,13 @@ int handle_second_lvl(int argc,char **argv,struct first_lvl_cmd *fl, struct seco
 	normal("Ouput configured\n");
 
 	// launch cmd
+	if(many)
+	{
+		status = handle_corpus(argc,argv,fl,sl,&corpus);
+		if(status)
+			error("Command Failed\n");
+		goto free_outg;
+	}
 	status = sl->fn(argc,argv);
 	if(status)
 	{
@@ -317,10 +667,7 @@ int handle_second_lvl(int argc,char **argv,struct first_lvl_cmd *fl, struct seco
 	if(fl->flags & NEED_OUTPUT)
 	{
 		normal("Printing graph\n");
-		if(fl->flags & IS_GRAPH_P)
-			status = ggen_write_graph(g_p,outfile);
-		else
-			status = ggen_write_graph(&g,outfile);
+		status = ggen_write_graph(&g,outfile);
 
 		if(status)
 		{
@@ -345,17 +692,16 @@ free_outg:
 	if(outfname)
 		fclose(outfile);
 
-	if(fl->flags & IS_GRAPH_P)
-	{
-		igraph_destroy(g_p);
-		free(g_p);
-	}
 err:
 free_rng:
 	if(fl->flags & NEED_RNG)
 		gsl_rng_free(rng);
 free_ing:
-	if(fl->flags & NEED_INPUT)
+	if(many)
+		ggen_corpus_close(&corpus);
+	else if((fl->flags & NEED_STREAM) && infile != stdin)
+		fclose(infile);
+	else if((fl->flags & NEED_INPUT) && !(fl->flags & NEED_STREAM))
 		igraph_destroy(&g);
 	return status;
 }
@@ -390,6 +736,46 @@ int handle_first_lvl(int argc, char **argv, struct first_lvl_cmd *c)
 		error("RNG state file not needed\n");
 		return 1;
 	}
+	if(nthreads != 0 && !(c->flags & NEED_THREADS))
+	{
+		error("Threads not supported by this command\n");
+		return 1;
+	}
+	if((ngraphs != 0 || outpattern != NULL) && !(c->flags & NEED_BATCH))
+	{
+		error("Batch mode not supported by this command\n");
+		return 1;
+	}
+	if(writerval != NULL && !(c->flags & NEED_OUTPUT))
+	{
+		error("Graph writer not needed\n");
+		return 1;
+	}
+	if(informatval != NULL && !(c->flags & NEED_INPUT))
+	{
+		error("Input format not needed\n");
+		return 1;
+	}
+	if(outformatval != NULL && !(c->flags & (NEED_OUTPUT | NEED_SINK)))
+	{
+		error("Output format not needed\n");
+		return 1;
+	}
+	if((vcostname != NULL || ecostname != NULL || ask_start) && !(c->flags & NEED_COSTS))
+	{
+		error("Costs not needed\n");
+		return 1;
+	}
+	if(outpattern != NULL && ngraphs == 0)
+	{
+		error("Output pattern needs a count of graphs\n");
+		return 1;
+	}
+	if(outpattern != NULL && outfname != NULL)
+	{
+		error("Output file and output pattern are exclusive\n");
+		return 1;
+	}
 	// find second lvl command
 	info("Searching subcommand %s\n",argv[0]);
 	for(int j = 0; c->cmds[j].name != NULL; j++)
@@ -416,6 +802,7 @@ int main(int argc,char** argv)
 	int c;
 	int option_index = 0;
 	int status = 0;
+	long cpus;
 	// parse options
 	while(1)
 	{
@@ -451,6 +838,30 @@ int main(int argc,char** argv)
 			case 'l':
 				logval = optarg;
 				break;
+			case 't':
+				threadsval = optarg;
+				break;
+			case 'c':
+				countval = optarg;
+				break;
+			case 'w':
+				writerval = optarg;
+				break;
+			case 'p':
+				outpattern = optarg;
+				break;
+			case 'I':
+				informatval = optarg;
+				break;
+			case 'O':
+				outformatval = optarg;
+				break;
+			case 'C':
+				vcostname = optarg;
+				break;
+			case 'E':
+				ecostname = optarg;
+				break;
 			default:
 				fprintf(stderr,"ggen bug: someone forgot how to write a switch\n");
 				exit(EXIT_FAILURE);
@@ -518,6 +929,74 @@ int main(int argc,char** argv)
 	log_filter_above((enum log_level)l);
 	normal("Logging facility initialized\n");
 
+	if(threadsval != NULL)
+	{
+		status = s2ul(threadsval,&nthreads);
+		if(status || nthreads == 0)
+		{
+			error("Incorrect number of threads, must be a positive integer\n");
+			exit(EXIT_FAILURE);
+		}
+		info("Using %lu threads\n",nthreads);
+	}
+	// readers and compressed outputs share the same threads
+	if(nthreads != 0)
+		ggen_io_threads = nthreads;
+	else
+	{
+		cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		ggen_io_threads = cpus > 0 ? cpus : 1;
+	}
+	if(writerval != NULL)
+	{
+		if(!strcmp(writerval,"native"))
+			ggen_dot_writer = GGEN_WRITER_NATIVE;
+		else if(!strcmp(writerval,"cgraph"))
+			ggen_dot_writer = GGEN_WRITER_CGRAPH;
+		else
+		{
+			error("Unknown graph writer %s, must be native or cgraph\n",writerval);
+			exit(EXIT_FAILURE);
+		}
+	}
+	if(informatval != NULL)
+	{
+		if(!strcmp(informatval,"dot"))
+			ggen_input_format = GGEN_FORMAT_DOT;
+		else if(!strcmp(informatval,"binary"))
+			ggen_input_format = GGEN_FORMAT_BINARY;
+		else if(!strcmp(informatval,"edgelist"))
+			ggen_input_format = GGEN_FORMAT_EDGELIST;
+		else
+		{
+			error("Unknown input format %s, must be dot, binary or edgelist\n",informatval);
+			exit(EXIT_FAILURE);
+		}
+	}
+	if(outformatval != NULL)
+	{
+		if(!strcmp(outformatval,"dot"))
+			ggen_output_format = GGEN_FORMAT_DOT;
+		else if(!strcmp(outformatval,"binary"))
+			ggen_output_format = GGEN_FORMAT_BINARY;
+		else if(!strcmp(outformatval,"edgelist"))
+			ggen_output_format = GGEN_FORMAT_EDGELIST;
+		else
+		{
+			error("Unknown output format %s, must be dot, binary or edgelist\n",outformatval);
+			exit(EXIT_FAILURE);
+		}
+	}
+	if(countval != NULL)
+	{
+		status = s2ul(countval,&ngraphs);
+		if(status || ngraphs == 0)
+		{
+			error("Incorrect number of graphs, must be a positive integer\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+
 	// initialize igraph attributes for all commands
 	igraph_i_set_attribute_table(&igraph_cattribute_table);
 
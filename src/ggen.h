@@ -44,21 +44,144 @@
 #ifndef GGEN_H
 #define GGEN_H 1
 
+#include<stdio.h>
+#include<stdint.h>
+
 /* igraph is used for graph manipulation */
 #include<igraph/igraph.h>
 /* GNU Scientific Library provides random number generators */
 #include<gsl/gsl_rng.h>
 #include<gsl/gsl_randist.h>
 
+/**********************************************************
+ * Dag views
+ *********************************************************/
+
+/* Immutable view of a graph, built once in O(n+m) and shared by the
+ * analyses. The out edges of v are out[out_off[v]] to out[out_off[v+1]-1],
+ * out_eid giving their igraph ids, and likewise for the in edges.
+ * If is_dag, order is a topological order and level[v] the number of
+ * edges of the longest path ending on v, they are undefined otherwise.
+ * Graphs of 2^32-1 vertices or edges and more are refused.
+ */
+struct ggen_dag {
+	uint32_t n,m;
+	uint32_t *out_off,*out,*out_eid;
+	uint32_t *in_off,*in,*in_eid;
+	uint32_t *order;
+	uint32_t *level;
+	int is_dag;
+};
+
+#define GGEN_DAG_OUTDEG(d,v) ((d)->out_off[(v)+1] - (d)->out_off[(v)])
+#define GGEN_DAG_INDEG(d,v) ((d)->in_off[(v)+1] - (d)->in_off[(v)])
+
+/* returns 0 on success, the view must then be destroyed */
+int ggen_dag_init(struct ggen_dag *d, const igraph_t *g);
+
+void ggen_dag_destroy(struct ggen_dag *d);
+
 /**********************************************************
  * Analysis methods
  *********************************************************/
 
 igraph_vector_t * ggen_analyze_longest_path(igraph_t *g);
 
+/* heaviest (critical) path of a dag, the weight of a path being the sum
+ * of the costs of its vertices and edges: vcost and ecost hold one cost
+ * per vertex and per edge, NULL meaning zero. If not NULL, path receives
+ * the vertices of a critical path, start the earliest start of each
+ * vertex (weight of the heaviest path ending on it, without its own cost)
+ * and length the weight of the critical path.
+ * Returns 0 on success, 1 on error or if g is not a dag.
+ */
+int ggen_analyze_critical_path(igraph_t *g, const igraph_vector_t *vcost,
+		const igraph_vector_t *ecost, igraph_vector_t *path,
+		igraph_vector_t *start, double *length);
+
+/* width of a dag: size of a maximum antichain, equal to the number of
+ * chains of a minimum chain cover (Dilworth). If not NULL, antichain
+ * receives the vertices of a maximum antichain and chain the index, in
+ * [0,width), of the chain of each vertex. Chains are ordered by their
+ * first vertex in topological order; two vertices of a chain are always
+ * comparable but not necessarily adjacent.
+ * Returns 0 on success, 1 on error or if g is not a dag.
+ */
+int ggen_analyze_width(igraph_t *g, igraph_vector_t *antichain,
+		igraph_vector_t *chain, unsigned long *width);
+
+/* the same on a view, for analyses sharing one */
+igraph_vector_t * ggen_dag_longest_path(const struct ggen_dag *d);
+
+int ggen_dag_critical_path(const struct ggen_dag *d, const igraph_vector_t *vcost,
+		const igraph_vector_t *ecost, igraph_vector_t *path,
+		igraph_vector_t *start, double *length);
+
+int ggen_dag_width(const struct ggen_dag *d, igraph_vector_t *antichain,
+		igraph_vector_t *chain, unsigned long *width);
+
+/* maximal paths of a dag, from a source to a sink: their number grows
+ * exponentially, count_paths gives the natural logarithm of the number of
+ * them going through each vertex (through) and of the total, count_paths_exact
+ * the same in decimal, total being allocated with malloc.
+ * Return 0 on success, 1 on error or if d is not a dag.
+ */
+int ggen_dag_count_paths(const struct ggen_dag *d, igraph_vector_t *through,
+		double *total);
+
+int ggen_dag_count_paths_exact(const struct ggen_dag *d, igraph_strvector_t *through,
+		char **total);
+
+/* calls fn on the maximal paths of a dag one after the other, at most
+ * limit of them (0 for all), stopping early if fn returns non zero. Only
+ * the current path is kept, count receives the number of paths found.
+ * Returns 0 on success, 1 on error or if d is not a dag.
+ */
+int ggen_dag_maximal_paths(const struct ggen_dag *d, unsigned long limit,
+		int (*fn)(const uint32_t *path, uint32_t len, void *data), void *data,
+		unsigned long *count);
+
+/**********************************************************
+ * Edge sinks
+ *********************************************************/
+
+/* A sink receives the edges of a graph as they are generated, in
+ * batches of (from,to) pairs, instead of building an igraph_t.
+ * begin is called once with the number of vertices and a hint of the
+ * number of edges (0 if unknown), end once with the final number of
+ * vertices (some generators create more vertices than asked for).
+ * Each callback returns 0 on success.
+ */
+struct ggen_edge_sink {
+	int (*begin)(struct ggen_edge_sink *s, unsigned long n, unsigned long m);
+	int (*edges)(struct ggen_edge_sink *s, const unsigned long *edges, unsigned long count);
+	int (*end)(struct ggen_edge_sink *s, unsigned long n);
+	void (*destroy)(struct ggen_edge_sink *s);
+	void *data;
+};
+
+/* builds the graph into g, which must not be initialized */
+struct ggen_edge_sink *ggen_edge_sink_igraph(igraph_t *g);
+
+/* writes the graph in the dot format, as name */
+struct ggen_edge_sink *ggen_edge_sink_dot(FILE *output, const char *name);
+
+/* writes the graph as a binary edge list, see ggen(3) */
+struct ggen_edge_sink *ggen_edge_sink_binary(FILE *output);
+
+/* writes the graph as a text edge list, one "from to" line per edge */
+struct ggen_edge_sink *ggen_edge_sink_edgelist(FILE *output);
+
+void ggen_edge_sink_free(struct ggen_edge_sink *s);
+
 /**********************************************************
  * Generation methods
  *********************************************************/
+
+/* derives the seed of the index-th independent substream of seed,
+ * suitable for gsl_rng_set */
+unsigned long ggen_rng_derive_seed(unsigned long seed, unsigned long index);
+
 igraph_t *ggen_generate_erdos_gnm(gsl_rng *r, unsigned long n, unsigned long m);
 
 igraph_t *ggen_generate_erdos_gnp(gsl_rng *r, unsigned long n, double p);
@@ -69,6 +192,35 @@ igraph_t *ggen_generate_fifo(gsl_rng *r, unsigned long n, unsigned long od, unsi
 
 igraph_t *ggen_generate_random_orders(gsl_rng *r, unsigned long n, unsigned int orders);
 
+igraph_t *ggen_generate_random_orders_hasse(gsl_rng *r, unsigned long n, unsigned int orders);
+
+/* streaming versions of the generators: edges are pushed to s.
+ * They return 0 on success */
+int ggen_stream_erdos_gnm(gsl_rng *r, unsigned long n, unsigned long m, struct ggen_edge_sink *s);
+
+int ggen_stream_erdos_gnp(gsl_rng *r, unsigned long n, double p, struct ggen_edge_sink *s);
+
+int ggen_stream_erdos_lbl(gsl_rng *r, unsigned long n, double p, unsigned long nbl,
+		struct ggen_edge_sink *s);
+
+/* multi-threaded versions of gnp and lbl. The graph only depends on r,
+ * not on the number of threads, but differs from the one generated by
+ * the sequential versions */
+int ggen_stream_erdos_gnp_parallel(gsl_rng *r, unsigned long n, double p, unsigned int threads,
+		struct ggen_edge_sink *s);
+
+int ggen_stream_erdos_lbl_parallel(gsl_rng *r, unsigned long n, double p, unsigned long nbl,
+		unsigned int threads, struct ggen_edge_sink *s);
+
+int ggen_stream_fifo(gsl_rng *r, unsigned long n, unsigned long od, unsigned long id,
+		struct ggen_edge_sink *s);
+
+int ggen_stream_random_orders(gsl_rng *r, unsigned long n, unsigned int orders,
+		struct ggen_edge_sink *s);
+
+int ggen_stream_random_orders_hasse(gsl_rng *r, unsigned long n, unsigned int orders,
+		struct ggen_edge_sink *s);
+
 /**********************************************************
  * Transformation methods
  *********************************************************/
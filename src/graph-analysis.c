@@ -43,102 +43,786 @@
  */
 
 #include "ggen.h"
+#include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
-igraph_vector_t * ggen_analyze_longest_path(igraph_t *g)
+/* the vertices of the path ending on v, following pred */
+static int path_to(igraph_vector_t *path, const long *pred, long v)
+{
+	unsigned long count;
+	long u;
+
+	count = 0;
+	for(u = v; u != -1; u = pred[u])
+		count++;
+	if(igraph_vector_resize(path,count))
+		return 1;
+	for(u = v; u != -1; u = pred[u])
+		VECTOR(*path)[--count] = u;
+	return 0;
+}
+
+igraph_vector_t * ggen_dag_longest_path(const struct ggen_dag *d)
 {
-	igraph_vector_t topology;
-	igraph_vector_t lengths;
-	igraph_vector_t preds;
-	igraph_vs_t vs;
-	igraph_vit_t vit;
 	igraph_vector_t *res = NULL;
-	int err;
-	unsigned long v,i,f,t;
-	long maxv;
-	if(g == NULL)
+	uint32_t v,k,maxv,l;
+
+	if(d == NULL || !d->is_dag)
 		return NULL;
 
-	v = igraph_vcount(g);
-	err = igraph_vector_init(&topology,v);
-	if(err)	return NULL;
+	res = malloc(sizeof(igraph_vector_t));
+	if(res == NULL)
+		return NULL;
+	if(igraph_vector_init(res,0))
+		goto error_r;
 
-	err = igraph_vector_init(&lengths,v);
-	if(err) goto error_il;
+	// levels are the lengths of the longest paths, a graph without
+	// edges has an empty longest path
+	maxv = 0;
+	for(v = 0; v < d->n; v++)
+		if(d->level[v] > d->level[maxv])
+			maxv = v;
+	if(d->n == 0 || d->level[maxv] == 0)
+		return res;
 
-	err = igraph_vector_init(&preds,v);
-	if(err) goto error_ip;
+	// walk back through predecessors one level up
+	l = d->level[maxv];
+	if(igraph_vector_resize(res,l + 1))
+		goto error;
+	VECTOR(*res)[l] = maxv;
+	for(v = maxv; l > 0; l--)
+	{
+		for(k = d->in_off[v]; d->level[d->in[k]] != l - 1; k++)
+			;
+		v = d->in[k];
+		VECTOR(*res)[l-1] = v;
+	}
+	return res;
+error:
+	igraph_vector_destroy(res);
+error_r:
+	free(res);
+	return NULL;
+}
 
-	res = malloc(sizeof(igraph_t));
-	if(res == NULL) goto cleanup;
+igraph_vector_t * ggen_analyze_longest_path(igraph_t *g)
+{
+	struct ggen_dag d;
+	igraph_vector_t *res;
 
-	err = igraph_vector_init(res,v);
-	if(err) goto error_ir;
+	if(ggen_dag_init(&d,g))
+		return NULL;
+	res = ggen_dag_longest_path(&d);
+	ggen_dag_destroy(&d);
+	return res;
+}
 
-	// sort topologically the vertices
-	err = igraph_topological_sorting(g,&topology,IGRAPH_OUT);
-	if(err) goto error;
-	// igraph is stupid, it returns 0 even if the graph isn't a dag
-	if(igraph_vector_size(&topology) != v)
-		goto error;
+int ggen_dag_critical_path(const struct ggen_dag *d, const igraph_vector_t *vcost,
+		const igraph_vector_t *ecost, igraph_vector_t *path,
+		igraph_vector_t *start, double *length)
+{
+	double *est = NULL;
+	long *pred = NULL;
+	long end;
+	uint32_t i,k,u,v;
+	double w,best;
+	int err = 1;
 
-	// find the best path incomming from every node
-	igraph_vector_null(&lengths);
-	igraph_vector_fill(&preds,-1);
-	maxv = -1;
-	for(i = 0; i < v; i++)
-	{
-		f = VECTOR(topology)[i];
-		err = igraph_vs_adj(&vs,f,IGRAPH_OUT);
-		if(err) goto error;
-		err = igraph_vit_create(g,vs,&vit);
-		if(err)
+	if(d == NULL || !d->is_dag)
+		return 1;
+	if(vcost != NULL && igraph_vector_size(vcost) != d->n)
+		return 1;
+	if(ecost != NULL && igraph_vector_size(ecost) != d->m)
+		return 1;
+
+	est = malloc((d->n + 1)*sizeof(double));
+	pred = malloc((d->n + 1)*sizeof(long));
+	if(est == NULL || pred == NULL)
+		goto cleanup;
+
+	// earliest start of v: heaviest path ending on it, without its cost,
+	// its predecessors are done before it in topological order
+	end = -1;
+	best = 0;
+	for(i = 0; i < d->n; i++)
+	{
+		v = d->order[i];
+		est[v] = 0;
+		pred[v] = -1;
+		for(k = d->in_off[v]; k < d->in_off[v+1]; k++)
 		{
-			igraph_vs_destroy(&vs);
-			goto error;
+			u = d->in[k];
+			w = est[u] + (vcost ? VECTOR(*vcost)[u] : 0)
+				+ (ecost ? VECTOR(*ecost)[d->in_eid[k]] : 0);
+			if(pred[v] == -1 || w > est[v])
+			{
+				est[v] = w;
+				pred[v] = u;
+			}
 		}
+		// the path ends where the heaviest path, with its last vertex, does
+		w = est[v] + (vcost ? VECTOR(*vcost)[v] : 0);
+		if(end == -1 || w > best || (w == best && (long)v < end))
+		{
+			end = v;
+			best = w;
+		}
+	}
+
+	if(path != NULL)
+	{
+		if(end == -1)
+			err = igraph_vector_resize(path,0);
+		else
+			err = path_to(path,pred,end);
+		if(err) goto cleanup;
+	}
+	if(start != NULL)
+	{
+		err = igraph_vector_resize(start,d->n);
+		if(err) goto cleanup;
+		for(v = 0; v < d->n; v++)
+			VECTOR(*start)[v] = est[v];
+	}
+	if(length != NULL)
+		*length = best;
+	err = 0;
+cleanup:
+	free(est);
+	free(pred);
+	return err;
+}
+
+int ggen_analyze_critical_path(igraph_t *g, const igraph_vector_t *vcost,
+		const igraph_vector_t *ecost, igraph_vector_t *path,
+		igraph_vector_t *start, double *length)
+{
+	struct ggen_dag d;
+	int err;
+
+	if(ggen_dag_init(&d,g))
+		return 1;
+	err = ggen_dag_critical_path(&d,vcost,ecost,path,start,length);
+	ggen_dag_destroy(&d);
+	return err;
+}
+
+/* Width of a dag by Dilworth's theorem: the size of a maximum antichain
+ * equals the number of chains of a minimum chain cover, n minus a maximum
+ * matching between the vertices and their descendants. The transitive
+ * closure is not built: the matching is a maximum flow in the network
+ *	s -> out(u)		capacity 1, u matched to a descendant
+ *	out(u) -> in(v)		for each edge u -> v, uncapacitated
+ *	in(v) -> out(v)		uncapacitated, paths go through v to its
+ *				descendants
+ *	in(v) -> t		capacity 1, v matched to an ancestor
+ * solved by Dinic's algorithm. Only the source and sink arcs have unit
+ * capacities, inner arcs are uncapacitated (n + 1), so this is not the
+ * unit network of Hopcroft-Karp and its bound does not apply.
+ */
+struct flow {
+	uint32_t nodes,count;
+	uint32_t *first;	// first arc of each node, arcs of a node are contiguous
+	uint32_t *head;
+	uint32_t *cap;		// residual capacity
+	uint32_t *rev;		// the opposite arc
+	int32_t *level;
+	uint32_t *iter;
+};
 
-		for(vit; !IGRAPH_VIT_END(vit); IGRAPH_VIT_NEXT(vit))
+#define FLOW_IN(v) (2*(v))
+#define FLOW_OUT(v) (2*(v)+1)
+
+static void flow_destroy(struct flow *f)
+{
+	free(f->first);
+	free(f->head);
+	free(f->cap);
+	free(f->rev);
+	free(f->level);
+	free(f->iter);
+}
+
+/* arcs are grouped by node: out(v) starts with the opposites of the s
+ * arc and of the pass-through, in(v) with the pass-through and the sink
+ * arc, the dag edges follow */
+static int flow_build(struct flow *f, const struct ggen_dag *d)
+{
+	uint32_t n = d->n,s = 2*d->n,t = 2*d->n+1;
+	uint32_t v,k,a,b,inf = d->n + 1;
+	uint32_t *pos = NULL;
+	uint64_t arcs = 2*(uint64_t)d->m + 6*(uint64_t)d->n;
+
+	memset(f,0,sizeof(*f));
+	if(arcs >= UINT32_MAX)
+		return 1;
+	f->nodes = 2*n + 2;
+	f->count = arcs;
+	f->first = malloc((f->nodes + 1)*sizeof(uint32_t));
+	f->head = malloc((arcs + 1)*sizeof(uint32_t));
+	f->cap = malloc((arcs + 1)*sizeof(uint32_t));
+	f->rev = malloc((arcs + 1)*sizeof(uint32_t));
+	f->level = malloc(f->nodes*sizeof(int32_t));
+	f->iter = malloc(f->nodes*sizeof(uint32_t));
+	pos = malloc(f->nodes*sizeof(uint32_t));
+	if(f->first == NULL || f->head == NULL || f->cap == NULL || f->rev == NULL
+			|| f->level == NULL || f->iter == NULL || pos == NULL)
+	{
+		free(pos);
+		flow_destroy(f);
+		return 1;
+	}
+
+	/* the degree of each node first */
+	f->first[0] = 0;
+	for(v = 0; v < n; v++)
+	{
+		f->first[FLOW_IN(v)+1] = f->first[FLOW_IN(v)] + GGEN_DAG_INDEG(d,v) + 2;
+		f->first[FLOW_OUT(v)+1] = f->first[FLOW_OUT(v)] + GGEN_DAG_OUTDEG(d,v) + 2;
+	}
+	f->first[s+1] = f->first[s] + n;
+	f->first[t+1] = f->first[t] + n;
+	for(v = 0; v < f->nodes; v++)
+		pos[v] = f->first[v];
+
+#define FLOW_ARC(x,y,c) do { a = pos[x]++; b = pos[y]++;		\
+		f->head[a] = (y); f->cap[a] = (c); f->rev[a] = b;	\
+		f->head[b] = (x); f->cap[b] = 0; f->rev[b] = a; } while(0)
+	for(v = 0; v < n; v++)
+	{
+		FLOW_ARC(s,FLOW_OUT(v),1);
+		FLOW_ARC(FLOW_IN(v),FLOW_OUT(v),inf);
+		FLOW_ARC(FLOW_IN(v),t,1);
+	}
+	for(v = 0; v < n; v++)
+		for(k = d->out_off[v]; k < d->out_off[v+1]; k++)
+			FLOW_ARC(FLOW_OUT(v),FLOW_IN(d->out[k]),inf);
+#undef FLOW_ARC
+	free(pos);
+	return 0;
+}
+
+/* levels from s in the residual network, returns whether t is reached */
+static int flow_bfs(struct flow *f, uint32_t s, uint32_t t, uint32_t *queue)
+{
+	uint32_t first,last,u,a;
+	for(u = 0; u < f->nodes; u++)
+		f->level[u] = -1;
+	f->level[s] = 0;
+	queue[0] = s;
+	for(first = 0, last = 1; first < last; first++)
+	{
+		u = queue[first];
+		for(a = f->first[u]; a < f->first[u+1]; a++)
+			if(f->cap[a] > 0 && f->level[f->head[a]] < 0)
+			{
+				f->level[f->head[a]] = f->level[u] + 1;
+				queue[last++] = f->head[a];
+			}
+	}
+	return f->level[t] >= 0;
+}
+
+/* blocking flow of unit paths along the levels, the search is kept on an
+ * explicit stack of arcs: paths are as long as the dag is deep */
+static uint32_t flow_block(struct flow *f, uint32_t s, uint32_t t, uint32_t *stack)
+{
+	uint32_t u,a,i,depth = 0,total = 0;
+
+	for(u = 0; u < f->nodes; u++)
+		f->iter[u] = f->first[u];
+	u = s;
+	while(1)
+	{
+		if(u == t)
 		{
-			t = IGRAPH_VIT_GET(vit);
-			if(VECTOR(lengths)[t] < VECTOR(lengths)[f] + 1)
+			/* every path starts with a unit arc from s */
+			for(i = 0; i < depth; i++)
 			{
-				VECTOR(lengths)[t] = VECTOR(lengths)[f] +1;
-				VECTOR(preds)[t] = f;
+				f->cap[stack[i]]--;
+				f->cap[f->rev[stack[i]]]++;
 			}
-			if(maxv == -1 || VECTOR(lengths)[t] > VECTOR(lengths)[maxv])
-				maxv = t;
+			total++;
+			depth = 0;
+			u = s;
+			continue;
 		}
-		igraph_vs_destroy(&vs);
-		igraph_vit_destroy(&vit);
+		for(a = f->iter[u]; a < f->first[u+1]; a++)
+			if(f->cap[a] > 0 && f->level[f->head[a]] == f->level[u] + 1)
+				break;
+		f->iter[u] = a;
+		if(a < f->first[u+1])
+		{
+			stack[depth++] = a;
+			u = f->head[a];
+			continue;
+		}
+		/* dead end: forget u and retreat */
+		if(u == s)
+			break;
+		f->level[u] = -1;
+		a = stack[--depth];
+		u = f->head[f->rev[a]];
+		f->iter[u]++;
+	}
+	return total;
+}
+
+int ggen_dag_width(const struct ggen_dag *d, igraph_vector_t *antichain,
+		igraph_vector_t *chain, unsigned long *width)
+{
+	struct flow f;
+	uint32_t *buf = NULL,*next = NULL;
+	uint32_t s,t,u,v,a,i,c,matched;
+	int err = 1;
+
+	if(d == NULL || !d->is_dag)
+		return 1;
+	if(flow_build(&f,d))
+		return 1;
+	s = 2*d->n;
+	t = 2*d->n + 1;
+
+	buf = malloc((f.nodes + 1)*sizeof(uint32_t));
+	next = malloc((d->n + 1)*sizeof(uint32_t));
+	if(buf == NULL || next == NULL)
+		goto cleanup;
 
+	matched = 0;
+	while(flow_bfs(&f,s,t,buf))
+		matched += flow_block(&f,s,t,buf);
+
+	/* the last search did not reach t: its levels are the s side of a
+	 * minimum cut. A vertex whose out(v) is on the s side and in(v) is
+	 * not belongs to neither side of the cover, all together they are
+	 * a maximum antichain */
+	if(antichain != NULL)
+	{
+		if(igraph_vector_resize(antichain,d->n - matched))
+			goto cleanup;
+		for(v = 0, i = 0; v < d->n; v++)
+			if(f.level[FLOW_OUT(v)] >= 0 && f.level[FLOW_IN(v)] < 0)
+				VECTOR(*antichain)[i++] = v;
 	}
-	// build the path, using preds and maxv
-	f = 0;
-	while(maxv != -1)
+
+	if(chain != NULL)
 	{
-		VECTOR(*res)[f++] = maxv;
-		maxv = VECTOR(preds)[maxv];
+		/* each unit of flow from out(u) ends on in(v) for a descendant v
+		 * of u, the next vertex on the chain of u. The flow left on an
+		 * arc is the capacity of its opposite, it is consumed along the
+		 * way and iter keeps the first dag arc that may still carry some */
+		for(v = 0; v < d->n; v++)
+			f.iter[FLOW_OUT(v)] = f.first[FLOW_OUT(v)] + 2;
+		for(v = 0; v < d->n; v++)
+			next[v] = UINT32_MAX;
+		for(u = 0; u < d->n; u++)
+		{
+			/* the arc from s is the first of out(u), reversed */
+			if(f.cap[f.first[FLOW_OUT(u)]] == 0)
+				continue;
+			v = FLOW_OUT(u);
+			while(1)
+			{
+				if(v % 2)
+				{
+					for(a = f.iter[v]; a < f.first[v+1]; a++)
+						if(f.cap[f.rev[a]] > 0)
+							break;
+				}
+				else
+				{
+					/* in(v): the sink arc first, then the pass-through */
+					a = f.first[v] + 1;
+					if(f.cap[f.rev[a]] == 0)
+						a = f.first[v];
+				}
+				f.iter[v] = a;
+				f.cap[f.rev[a]]--;
+				if(f.head[a] == t)
+					break;
+				v = f.head[a];
+			}
+			next[u] = v/2;
+		}
+		if(igraph_vector_resize(chain,d->n))
+			goto cleanup;
+		/* matched vertices are not chain heads */
+		for(v = 0; v < d->n; v++)
+			buf[v] = 0;
+		for(v = 0; v < d->n; v++)
+			if(next[v] != UINT32_MAX)
+				buf[next[v]] = 1;
+		c = 0;
+		for(i = 0; i < d->n; i++)
+		{
+			v = d->order[i];
+			if(buf[v])
+				continue;
+			for(u = v; u != UINT32_MAX; u = next[u])
+				VECTOR(*chain)[u] = c;
+			c++;
+		}
 	}
+	if(width != NULL)
+		*width = d->n - matched;
+	err = 0;
+cleanup:
+	free(buf);
+	free(next);
+	flow_destroy(&f);
+	return err;
+}
 
-	// finish the path correctly, resizing and reversing the array
-	err = igraph_vector_resize(res,f);
-	if(err) goto error;
+int ggen_analyze_width(igraph_t *g, igraph_vector_t *antichain,
+		igraph_vector_t *chain, unsigned long *width)
+{
+	struct ggen_dag d;
+	int err;
 
-	err = igraph_vector_reverse(res);
-	if(err) goto error;
+	if(ggen_dag_init(&d,g))
+		return 1;
+	err = ggen_dag_width(&d,antichain,chain,width);
+	ggen_dag_destroy(&d);
+	return err;
+}
 
-	goto cleanup;
-error:
-	igraph_vector_destroy(res);
-error_ir:
-	free(res);
-	res = NULL;
+/* Maximal paths go from a source to a sink. The number of them through
+ * v is up[v]*down[v], up[v] counting the paths from a source to v (one
+ * for a source) and down[v] the paths from v to a sink, both obtained in
+ * one pass over the topological order. Counts grow exponentially with the
+ * depth of the dag: they are kept in log space or as big numbers.
+ */
+
+/* log(exp(a)+exp(b)) without overflow */
+static double log_add(double a, double b)
+{
+	if(a == -INFINITY)
+		return b;
+	if(a < b)
+		return b + log1p(exp(a - b));
+	return a + log1p(exp(b - a));
+}
+
+int ggen_dag_count_paths(const struct ggen_dag *d, igraph_vector_t *through,
+		double *total)
+{
+	double *up = NULL,*down = NULL,t;
+	uint32_t i,k,v;
+	int err = 1;
+
+	if(d == NULL || !d->is_dag)
+		return 1;
+	up = malloc((d->n + 1)*sizeof(double));
+	down = malloc((d->n + 1)*sizeof(double));
+	if(up == NULL || down == NULL)
+		goto cleanup;
+
+	for(i = 0; i < d->n; i++)
+	{
+		v = d->order[i];
+		up[v] = GGEN_DAG_INDEG(d,v) ? -INFINITY : 0;
+		for(k = d->in_off[v]; k < d->in_off[v+1]; k++)
+			up[v] = log_add(up[v],up[d->in[k]]);
+	}
+	t = -INFINITY;
+	for(i = d->n; i > 0; i--)
+	{
+		v = d->order[i-1];
+		down[v] = GGEN_DAG_OUTDEG(d,v) ? -INFINITY : 0;
+		for(k = d->out_off[v]; k < d->out_off[v+1]; k++)
+			down[v] = log_add(down[v],down[d->out[k]]);
+		if(GGEN_DAG_INDEG(d,v) == 0)
+			t = log_add(t,down[v]);
+	}
+
+	if(through != NULL)
+	{
+		if(igraph_vector_resize(through,d->n))
+			goto cleanup;
+		for(v = 0; v < d->n; v++)
+			VECTOR(*through)[v] = up[v] + down[v];
+	}
+	if(total != NULL)
+		*total = t;
+	err = 0;
 cleanup:
-	igraph_vector_destroy(&preds);
-error_ip:
-	igraph_vector_destroy(&lengths);
-error_il:
-	igraph_vector_destroy(&topology);
-	return res;
+	free(up);
+	free(down);
+	return err;
+}
+
+/* big numbers are little endian arrays of 32 bit limbs, those of all the
+ * vertices are stored one after the other in a growing arena */
+struct big_arena {
+	uint32_t *limb;
+	size_t size,cap;
+	size_t *off;
+	uint32_t *len;
+};
+
+static int big_reserve(struct big_arena *a, size_t count)
+{
+	uint32_t *l;
+	size_t cap;
+	if(a->size + count <= a->cap)
+		return 0;
+	cap = 2*a->cap + count;
+	l = realloc(a->limb,cap*sizeof(uint32_t));
+	if(l == NULL)
+		return 1;
+	a->limb = l;
+	a->cap = cap;
+	return 0;
+}
+
+/* dst += src, dst having room for the carry */
+static void big_add(uint32_t *dst, const uint32_t *src, size_t len)
+{
+	uint64_t c = 0;
+	size_t i;
+	for(i = 0; i < len; i++)
+	{
+		c += (uint64_t)dst[i] + src[i];
+		dst[i] = c;
+		c >>= 32;
+	}
+	for(; c; i++)
+	{
+		c += dst[i];
+		dst[i] = c;
+		c >>= 32;
+	}
+}
+
+/* dst = a*b, dst has room for al+bl limbs */
+static size_t big_mul(uint32_t *dst, const uint32_t *a, size_t al,
+		const uint32_t *b, size_t bl)
+{
+	uint64_t c;
+	size_t i,j,len;
+	memset(dst,0,(al+bl)*sizeof(uint32_t));
+	for(i = 0; i < al; i++)
+	{
+		c = 0;
+		for(j = 0; j < bl; j++)
+		{
+			c += (uint64_t)a[i]*b[j] + dst[i+j];
+			dst[i+j] = c;
+			c >>= 32;
+		}
+		dst[i+bl] = c;
+	}
+	for(len = al+bl; len > 1 && dst[len-1] == 0; len--)
+		;
+	return len;
+}
+
+/* decimal writing of a, destroyed on the way, into s: base 10^9 digits
+ * go to chunks, room for 2*len+1 of them and 10*len+2 chars is enough */
+static void big_str(uint32_t *a, size_t len, uint32_t *chunks, char *s)
+{
+	size_t i,n = 0;
+	uint64_t r;
+
+	while(len > 0 && a[len-1] == 0)
+		len--;
+	while(len > 0)
+	{
+		r = 0;
+		for(i = len; i > 0; i--)
+		{
+			r = (r << 32) | a[i-1];
+			a[i-1] = r / 1000000000;
+			r %= 1000000000;
+		}
+		chunks[n++] = r;
+		while(len > 0 && a[len-1] == 0)
+			len--;
+	}
+	if(n == 0)
+	{
+		strcpy(s,"0");
+		return;
+	}
+	s += sprintf(s,"%u",chunks[n-1]);
+	for(i = n-1; i > 0; i--)
+		s += sprintf(s,"%09u",chunks[i-1]);
+}
+
+/* up (or down if !up) counts of all the vertices into a */
+static int big_counts(const struct ggen_dag *d, struct big_arena *a, int up)
+{
+	uint32_t i,k,u,v,first,last,*adj;
+	size_t len,o;
+
+	a->limb = NULL;
+	a->size = a->cap = 0;
+	a->off = malloc((d->n + 1)*sizeof(size_t));
+	a->len = malloc((d->n + 1)*sizeof(uint32_t));
+	if(a->off == NULL || a->len == NULL)
+		return 1;
+	for(i = 0; i < d->n; i++)
+	{
+		v = up ? d->order[i] : d->order[d->n - i - 1];
+		first = up ? d->in_off[v] : d->out_off[v];
+		last = up ? d->in_off[v+1] : d->out_off[v+1];
+		adj = up ? d->in : d->out;
+
+		/* room for the largest term and the carries of the sum, in
+		 * limbs */
+		len = 0;
+		for(k = first; k < last; k++)
+			if(a->len[adj[k]] > len)
+				len = a->len[adj[k]];
+		len += (32 - __builtin_clz(last - first + 1) + 31)/32;
+		if(big_reserve(a,len))
+			return 1;
+		o = a->size;
+		memset(a->limb + o,0,len*sizeof(uint32_t));
+		if(first == last)
+			a->limb[o] = 1;
+		for(k = first; k < last; k++)
+		{
+			u = adj[k];
+			big_add(a->limb + o,a->limb + a->off[u],a->len[u]);
+		}
+		while(len > 1 && a->limb[o+len-1] == 0)
+			len--;
+		a->off[v] = o;
+		a->len[v] = len;
+		a->size += len;
+	}
+	return 0;
+}
+
+static void big_destroy(struct big_arena *a)
+{
+	free(a->limb);
+	free(a->off);
+	free(a->len);
+}
+
+int ggen_dag_count_paths_exact(const struct ggen_dag *d, igraph_strvector_t *through,
+		char **total)
+{
+	struct big_arena up,down;
+	uint32_t *prod = NULL,*chunks = NULL;
+	char *s = NULL;
+	size_t maxlen,len;
+	uint32_t v;
+	int err = 1;
+
+	if(d == NULL || !d->is_dag)
+		return 1;
+	memset(&up,0,sizeof(up));
+	memset(&down,0,sizeof(down));
+	if(big_counts(d,&up,1) || big_counts(d,&down,0))
+		goto cleanup;
+
+	/* scratch space for the largest product, or the total */
+	maxlen = 1;
+	for(v = 0; v < d->n; v++)
+		if(up.len[v] + down.len[v] > maxlen)
+			maxlen = up.len[v] + down.len[v];
+	len = 0;
+	for(v = 0; v < d->n; v++)
+		if(GGEN_DAG_INDEG(d,v) == 0 && down.len[v] > len)
+			len = down.len[v];
+	len += (32 - __builtin_clz(d->n + 1) + 31)/32;
+	if(len > maxlen)
+		maxlen = len;
+	prod = malloc(maxlen*sizeof(uint32_t));
+	chunks = malloc((2*maxlen + 1)*sizeof(uint32_t));
+	s = malloc(10*maxlen + 2);
+	if(prod == NULL || chunks == NULL || s == NULL)
+		goto cleanup;
+
+	if(through != NULL)
+	{
+		if(igraph_strvector_resize(through,d->n))
+			goto cleanup;
+		for(v = 0; v < d->n; v++)
+		{
+			len = big_mul(prod,up.limb + up.off[v],up.len[v],
+					down.limb + down.off[v],down.len[v]);
+			big_str(prod,len,chunks,s);
+			if(igraph_strvector_set(through,v,s))
+				goto cleanup;
+		}
+	}
+	if(total != NULL)
+	{
+		/* all paths start on a source */
+		memset(prod,0,maxlen*sizeof(uint32_t));
+		for(v = 0; v < d->n; v++)
+			if(GGEN_DAG_INDEG(d,v) == 0)
+				big_add(prod,down.limb + down.off[v],down.len[v]);
+		big_str(prod,maxlen,chunks,s);
+		*total = s;
+		s = NULL;
+	}
+	err = 0;
+cleanup:
+	big_destroy(&up);
+	big_destroy(&down);
+	free(prod);
+	free(chunks);
+	free(s);
+	return err;
+}
+
+int ggen_dag_maximal_paths(const struct ggen_dag *d, unsigned long limit,
+		int (*fn)(const uint32_t *path, uint32_t len, void *data), void *data,
+		unsigned long *count)
+{
+	uint32_t *path = NULL,*next = NULL;
+	uint32_t depth,s,u;
+	unsigned long found = 0;
+	int err = 1;
+
+	if(d == NULL || fn == NULL || !d->is_dag)
+		return 1;
+	/* the current path and, for each of its vertices, the next out
+	 * edge to follow: nothing else is kept between two paths */
+	path = malloc((d->n + 1)*sizeof(uint32_t));
+	next = malloc((d->n + 1)*sizeof(uint32_t));
+	if(path == NULL || next == NULL)
+		goto cleanup;
+
+	for(s = 0; s < d->n && (limit == 0 || found < limit); s++)
+	{
+		if(GGEN_DAG_INDEG(d,s))
+			continue;
+		path[0] = s;
+		next[0] = d->out_off[s];
+		depth = 1;
+		while(depth > 0 && (limit == 0 || found < limit))
+		{
+			u = path[depth-1];
+			if(GGEN_DAG_OUTDEG(d,u) == 0)
+			{
+				found++;
+				if(fn(path,depth,data))
+					goto done;
+				depth--;
+			}
+			else if(next[depth-1] < d->out_off[u+1])
+			{
+				path[depth] = d->out[next[depth-1]++];
+				next[depth] = d->out_off[path[depth]];
+				depth++;
+			}
+			else
+				depth--;
+		}
+	}
+done:
+	if(count != NULL)
+		*count = found;
+	err = 0;
+cleanup:
+	free(path);
+	free(next);
+	return err;
 }
@@ -44,448 +44,1147 @@
 * INRIA, Grenoble Universities.
 */
 
-#include "ggen.h"
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
-/* Erdos-Renyi : G(n,M)
-*/
-igraph_t *ggen_generate_erdos_gnm(gsl_rng *r, unsigned long n, unsigned long m)
+#include "ggen.h"
+#include "bit-matrix.h"
+#include "edge-sink.h"
+
+/* Draws an integer uniformly in [0,t), even when t is bigger than
+ * the range of the generator. Big numbers are built from chunks of 24
+ * bits, or less if the generator does not provide them (gsl draws in
+ * [0,n) only for n <= max - min), and rejected when they fall in the
+ * biased tail.
+ */
+static unsigned long uniform_index(gsl_rng *r, unsigned long t)
 {
-	igraph_matrix_t adj;
-	igraph_t *g = NULL;
-	int err;
-	unsigned long i,j;
-	unsigned long added_edges = 0;
+	unsigned long x,limit,range;
+	unsigned int bits,got,c;
 
-	if(r == NULL)
-		return NULL;
+	range = gsl_rng_max(r) - gsl_rng_min(r);
+	if(t <= range)
+		return gsl_rng_uniform_int(r,t);
 
-	if(m > (n*(n-1)/2))
-		return NULL;
+	for(bits = 24; bits > 1 && (1UL << bits) > range; bits--)
+		;
+	limit = ULONG_MAX - ULONG_MAX % t;
+	do {
+		x = 0;
+		for(got = 0; got < sizeof(unsigned long)*8; got += c)
+		{
+			c = sizeof(unsigned long)*8 - got;
+			c = (c < bits) ? c : bits;
+			x = (x << c) | gsl_rng_uniform_int(r,1UL << c);
+		}
+	} while(x >= limit);
+	return x % t;
+}
 
-	g = malloc(sizeof(igraph_t));
-	if(g == NULL)
+static int cmp_ulong(const void *a, const void *b)
+{
+	unsigned long x = *(const unsigned long *)a;
+	unsigned long y = *(const unsigned long *)b;
+	return (x > y) - (x < y);
+}
+
+/* Selects k distinct indices uniformly in [0,t) and returns them
+ * sorted in increasing order. Duplicates are removed after sorting and
+ * drawn again, which converges quickly as long as k <= t/2.
+ */
+static unsigned long *sample_indices(gsl_rng *r, unsigned long t, unsigned long k)
+{
+	unsigned long *s;
+	unsigned long i,j,count = 0;
+
+	s = malloc((k == 0 ? 1 : k)*sizeof(unsigned long));
+	if(s == NULL)
 		return NULL;
 
-	if(m == 0 || n <= 1)
+	while(count < k)
 	{
-		err = igraph_empty(g,n,1);
-		if(err) goto error;
-		else return g;
-	}
-	if(m == (n*(n-1))/2)
-	{
-		err = igraph_full_citation(g,n,1);
-		if(err) goto error;
-		else return g;
+		for(i = count; i < k; i++)
+			s[i] = uniform_index(r,t);
+
+		qsort(s,k,sizeof(unsigned long),cmp_ulong);
 
+		// remove duplicates, they will be drawn again
+		for(i = 1, j = 1; i < k; i++)
+			if(s[i] != s[j-1])
+				s[j++] = s[i];
+		count = j;
 	}
+	return s;
+}
 
-	err = igraph_matrix_init(&adj,n,n);
-	if(err)	goto error;
+/* Translates the index k of a cell of the upper triangle, numbered
+ * row by row (row v holds the v cells (w,v), w < v), to its coordinates.
+ */
+static void triangle_cell(unsigned long k, unsigned long *w, unsigned long *v)
+{
+	unsigned long r = (unsigned long)((1 + sqrt(1 + 8.0*k))/2);
+
+	// fix rounding errors of the square root
+	while(r*(r-1)/2 > k)
+		r--;
+	while(r*(r+1)/2 <= k)
+		r++;
+	*v = r;
+	*w = k - r*(r-1)/2;
+}
 
-	igraph_matrix_null(&adj);
+/* Geometric skip over a sequence of Bernoulli trials:
+ * returns the number of failed trials before the next success,
+ * lq being log(1-p). Sparse generators use it to jump directly
+ * from one edge to the next instead of flipping a coin per edge.
+ */
+static double geometric_skip(gsl_rng *r, double lq)
+{
+	return floor(log(gsl_rng_uniform_pos(r))/lq);
+}
 
-	while(added_edges < m) {
-		i = gsl_rng_uniform_int(r,n);
-		j = gsl_rng_uniform_int(r,n);
+/* Selects each cell of rows [first,last) of a triangular set of
+ * candidate edges with probability p, jumping from one selected cell to
+ * the next with geometric skips. Row k holds the cells (w,k), w < len[k]
+ * (or w < k if len is NULL).
+ * Selected cells are either pushed to b, vertices being translated
+ * by labels if not NULL, or cleared from bm if it is not NULL.
+ */
+static int skip_walk(gsl_rng *r, double p, unsigned long first, unsigned long last,
+		const unsigned long *len, const unsigned long *labels, struct edge_batch *b, struct bit_matrix *bm)
+{
+	unsigned long k,w;
+	double cells,lq,s;
+	int err;
 
-                if(i < j && igraph_matrix_e(&adj,i,j) == 0)
-                {
-			igraph_matrix_set(&adj,i,j,1);
-			added_edges++;
-                }
+	if(p == 0.0)
+		return 0;
 
-        }
+	cells = 0;
+	for(k = first; k < last; k++)
+		cells += len ? len[k] : k;
 
-	err = igraph_adjacency(g,&adj,IGRAPH_ADJ_DIRECTED);
-	igraph_matrix_destroy(&adj);
-	if(err) goto error;
+	lq = log1p(-p);
+	k = first;
+	w = 0;
+	while(k < last)
+	{
+		// skip the cells that failed their coin flip
+		s = geometric_skip(r,lq);
+		if(s >= cells)
+			break;
 
-	goto ret;
-error:
-	free(g);
-	g = NULL;
-ret:
-	return g;
+		w += (unsigned long)s;
+		while(k < last && w >= (len ? len[k] : k))
+		{
+			w -= len ? len[k] : k;
+			k++;
+		}
+		if(k < last)
+		{
+			if(bm != NULL)
+				bit_matrix_clear(bm,w,k);
+			else
+			{
+				err = edge_batch_push(b,labels ? labels[w] : w,
+						labels ? labels[k] : k);
+				if(err) return err;
+			}
+			w++;
+		}
+	}
+	return 0;
 }
 
-/* Erdos-Renyi : G(n,p)
-*/
-igraph_t *ggen_generate_erdos_gnp(gsl_rng *r, unsigned long n, double p)
+/* Pushes all the edges of the full DAG on n vertices */
+static int full_dag(struct edge_batch *b, unsigned long n)
 {
-	igraph_matrix_t m;
-	igraph_t *g = NULL;
+	unsigned long u,v;
 	int err;
-	unsigned long i,j;
 
-	if(r == NULL)
-		return NULL;
+	for(v = 1; v < n; v++)
+		for(u = 0; u < v; u++)
+		{
+			err = edge_batch_push(b,u,v);
+			if(err) return err;
+		}
+	return 0;
+}
 
-	if(p < 0.0 || p > 1.0)
+/* The igraph_t versions of the generators only run the streaming
+ * version into an igraph sink.
+ */
+static igraph_t *igraph_sink_open(struct ggen_edge_sink **s)
+{
+	igraph_t *g = malloc(sizeof(igraph_t));
+	if(g == NULL)
 		return NULL;
 
-	g = malloc(sizeof(igraph_t));
-	if(g == NULL)
+	*s = ggen_edge_sink_igraph(g);
+	if(*s == NULL)
+	{
+		free(g);
 		return NULL;
+	}
+	return g;
+}
 
-	if(p == 0.0)
+static igraph_t *igraph_sink_close(igraph_t *g, struct ggen_edge_sink *s, int err)
+{
+	ggen_edge_sink_free(s);
+	if(err)
 	{
-		err = igraph_empty(g,n,1);
-		if(err) goto error;
-		else return g;
+		free(g);
+		return NULL;
 	}
-	if(p == 1.0)
+	return g;
+}
+
+/* Erdos-Renyi : G(n,M)
+ * Edges are indexed row by row in the upper triangle of the adjacency
+ * matrix: row v holds the v edges (w,v), w < v.
+ * For sparse graphs, we pick m distinct indices and translate them to
+ * an edge list in a single walk.
+ * As soon as a bit matrix is smaller than the list of indices, we
+ * rather set random cells of the matrix until m of them are set, or
+ * clear cells of the full DAG if more than half of them are wanted.
+*/
+int ggen_stream_erdos_gnm(gsl_rng *r, unsigned long n, unsigned long m, struct ggen_edge_sink *s)
+{
+	struct edge_batch b;
+	struct bit_matrix bm;
+	int err,full;
+	unsigned long *idx;
+	unsigned long cells,count,row,i,v,w;
+
+	if(r == NULL || s == NULL)
+		return 1;
+
+	cells = n*(n-1)/2;
+	if(m > cells)
+		return 1;
+
+	err = s->begin(s,n,m);
+	if(err) return err;
+
+	edge_batch_init(&b,s);
+	if(m == 0)
+		err = 0;
+	else if(m == cells)
+		err = full_dag(&b,n);
+	else if(m < cells/64)
 	{
-		err = igraph_full_citation(g,n,1);
-		if(err) goto error;
-		else return g;
+		idx = sample_indices(r,cells,m);
+		if(idx == NULL)
+			return 1;
+
+		v = 1;
+		row = 0;
+		for(i = 0; i < m && !err; i++)
+		{
+			while(idx[i] >= row + v)
+				row += v++;
+			err = edge_batch_push(&b,idx[i] - row,v);
+		}
+		free(idx);
 	}
+	else
+	{
+		err = bit_matrix_init(&bm,n);
+		if(err) return err;
 
-	err = igraph_matrix_init(&m,n,n);
-	if(err) goto error;
+		full = m > cells/2;
+		if(full)
+			for(v = 0; v < n; v++)
+				bit_matrix_set_prefix(&bm,v,v);
 
-	for(i = 0; i < n; i++)
-		for(j = 0; j < n; j++)
-			if(i < j)
-				// coin flipping to determine if we add an edge or not
-				igraph_matrix_set(&m,i,j,gsl_ran_bernoulli(r,p));
+		// at most half of the draws hit an already changed cell
+		count = full ? cells : 0;
+		while(count != m)
+		{
+			triangle_cell(uniform_index(r,cells),&w,&v);
+			if(bit_matrix_test(&bm,w,v) != full)
+				continue;
+
+			if(full)
+			{
+				bit_matrix_clear(&bm,w,v);
+				count--;
+			}
 			else
-				igraph_matrix_set(&m,i,j,0);
+			{
+				bit_matrix_set(&bm,w,v);
+				count++;
+			}
+		}
+		err = bit_matrix_stream(&bm,&b,NULL,0,n);
+		bit_matrix_destroy(&bm);
+	}
+	if(err) return err;
 
-	err = igraph_adjacency(g,&m,IGRAPH_ADJ_DIRECTED);
-	igraph_matrix_destroy(&m);
-	if(err) goto error;
+	err = edge_batch_flush(&b);
+	if(err) return err;
 
-	goto ret;
+	return s->end(s,n);
+}
 
-error:
-	free(g);
-	g = NULL;
-ret:
-	return g;
+igraph_t *ggen_generate_erdos_gnm(gsl_rng *r, unsigned long n, unsigned long m)
+{
+	struct ggen_edge_sink *s;
+	igraph_t *g = igraph_sink_open(&s);
+	if(g == NULL)
+		return NULL;
+
+	return igraph_sink_close(g,s,ggen_stream_erdos_gnm(r,n,m,s));
 }
 
-igraph_t *ggen_generate_erdos_lbl(gsl_rng *r, unsigned long n, double p, unsigned long nbl)
+/* Parallel walks:
+ * the rows of the triangle are cut into blocks of about PAR_BLOCK_EDGES
+ * expected edges. Block boundaries only depend on the parameters of the
+ * generator, and each block draws from its own generator, seeded from a
+ * single number taken from r and the index of the block. Blocks can thus
+ * be generated in any order, by any thread, and are pushed to the sink
+ * in order: the graph does not depend on the number of threads.
+ * Blocks are generated by rounds of PAR_ROUND blocks per thread, which
+ * bounds the memory used to buffer their edges.
+ */
+#define PAR_BLOCK_EDGES 16384
+#define PAR_MIN_CELLS 65536
+#define PAR_ROUND 4
+
+struct par_block {
+	unsigned long index;
+	unsigned long first,last;	// rows of the block
+	unsigned long *edges;
+	unsigned long count,size;	// edges in the buffer, and its capacity
+	struct ggen_edge_sink sink;	// appends to the buffer
+	int err;
+};
+
+struct par_walk {
+	const gsl_rng_type *type;
+	unsigned long seed;
+	double p;
+	const unsigned long *len;
+	const unsigned long *labels;
+	struct bit_matrix *bm;		// dense walks clear cells from it
+	struct par_block *blocks;
+	unsigned long count;		// blocks in this round
+	unsigned long next;		// next block to generate
+	pthread_mutex_t lock;
+};
+
+static int par_block_edges(struct ggen_edge_sink *s, const unsigned long *edges,
+		unsigned long count)
+{
+	struct par_block *b = s->data;
+	unsigned long *t;
+
+	if(b->count + count > b->size)
+	{
+		b->size = 2*(b->count + count);
+		t = realloc(b->edges,2*b->size*sizeof(unsigned long));
+		if(t == NULL)
+			return 1;
+		b->edges = t;
+	}
+	memcpy(b->edges + 2*b->count,edges,2*count*sizeof(unsigned long));
+	b->count += count;
+	return 0;
+}
+
+/* splitmix64 finalizer: consecutive indices get unrelated seeds */
+unsigned long ggen_rng_derive_seed(unsigned long seed, unsigned long index)
+{
+	uint64_t z = seed + (index + 1)*UINT64_C(0x9E3779B97F4A7C15);
+	z = (z ^ (z >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+	z = (z ^ (z >> 27)) * UINT64_C(0x94D049BB133111EB);
+	z ^= z >> 31;
+	// some generators use a default seed instead of 0
+	return z ? (unsigned long)z : 1;
+}
+
+static void par_block_generate(struct par_walk *w, gsl_rng *r, struct par_block *b)
 {
-	igraph_t *g = NULL;
-	igraph_matrix_t m;
-	igraph_vector_t layers;
-	unsigned long i,j;
+	struct edge_batch e;
+	unsigned long k;
 	int err;
 
-	if(r == NULL)
-		return NULL;
+	gsl_rng_set(r,ggen_rng_derive_seed(w->seed,b->index));
+	edge_batch_init(&e,&b->sink);
+	if(w->bm == NULL)
+		err = skip_walk(r,w->p,b->first,b->last,w->len,w->labels,&e,NULL);
+	else
+	{
+		// columns are word aligned: blocks never share a word
+		for(k = b->first; k < b->last; k++)
+			bit_matrix_set_prefix(w->bm,k,w->len ? w->len[k] : k);
 
-	if(p < 0.0 || p > 1.0)
-		return NULL;
+		err = skip_walk(r,1.0 - w->p,b->first,b->last,w->len,NULL,NULL,w->bm);
+		if(!err)
+			err = bit_matrix_stream(w->bm,&e,w->labels,b->first,b->last);
+	}
+	if(!err)
+		err = edge_batch_flush(&e);
+	b->err = err;
+}
 
-	if(nbl > n || nbl == 0)
-		return NULL;
+static void *par_worker(void *arg)
+{
+	struct par_walk *w = arg;
+	unsigned long i;
+	gsl_rng *r;
 
-	g = malloc(sizeof(igraph_t));
-	if(g == NULL)
+	// blocks left unprocessed keep their error
+	r = gsl_rng_alloc(w->type);
+	if(r == NULL)
 		return NULL;
 
-	if(p == 0.0)
+	for(;;)
 	{
-		err = igraph_empty(g,n,1);
-		if(err) goto error;
-		else return g;
+		pthread_mutex_lock(&w->lock);
+		i = w->next++;
+		pthread_mutex_unlock(&w->lock);
+		if(i >= w->count)
+			break;
+		par_block_generate(w,r,w->blocks + i);
 	}
-	if(p == 1.0 && nbl == n)
+	gsl_rng_free(r);
+	return NULL;
+}
+
+/* Same as skip_walk on all the rows, selected cells being pushed to s,
+ * using threads threads. p > 0.5 uses a bit matrix like the sequential
+ * generators do.
+ */
+static int par_skip_walk(gsl_rng *r, double p, unsigned long n, const unsigned long *len,
+		const unsigned long *labels, unsigned int threads, struct ggen_edge_sink *s)
+{
+	struct par_walk w;
+	struct bit_matrix bm;
+	pthread_t *tids = NULL;
+	unsigned long i,k,index,nblocks,started;
+	double cells;
+	int err = 1;
+
+	nblocks = (unsigned long)threads*PAR_ROUND;
+	w.type = r->type;
+	w.seed = gsl_rng_get(r);
+	w.p = p;
+	w.len = len;
+	w.labels = labels;
+	w.bm = NULL;
+	w.blocks = calloc(nblocks,sizeof(struct par_block));
+	tids = malloc(threads*sizeof(pthread_t));
+	if(w.blocks == NULL || tids == NULL)
+		goto free_b;
+
+	if(p > 0.5)
 	{
-		err = igraph_full_citation(g,n,1);
-		if(err) goto error;
-		else return g;
+		if(bit_matrix_init(&bm,n))
+			goto free_b;
+		w.bm = &bm;
 	}
+	if(pthread_mutex_init(&w.lock,NULL))
+		goto free_bm;
 
-	err = igraph_matrix_init(&m,n,n);
-	if(err) goto error;
-
-	err = igraph_vector_init(&layers,n);
-	if(err)
-		goto d_m;
+	for(i = 0; i < nblocks; i++)
+	{
+		w.blocks[i].sink.edges = par_block_edges;
+		w.blocks[i].sink.data = w.blocks + i;
+	}
 
-	// asign to each vertex a layer
-	for(i = 0; i < n; i++)
+	err = 0;
+	k = 0;
+	index = 0;
+	while(k < n && !err)
 	{
-		j = gsl_rng_uniform_int(r,nbl);
-		VECTOR(layers)[i] = j;
+		// cut the blocks of this round
+		for(w.count = 0; w.count < nblocks && k < n; w.count++)
+		{
+			struct par_block *b = w.blocks + w.count;
+			b->index = index++;
+			b->first = k;
+			b->count = 0;
+			b->err = 1;
+			cells = 0;
+			while(k < n && (cells < PAR_MIN_CELLS || p*cells < PAR_BLOCK_EDGES))
+				cells += len ? len[k++] : k++;
+			b->last = k;
+		}
+
+		// the current thread works too
+		w.next = 0;
+		for(started = 0; started < threads - 1; started++)
+			if(pthread_create(tids + started,NULL,par_worker,&w))
+				break;
+		par_worker(&w);
+		for(i = 0; i < started; i++)
+			pthread_join(tids[i],NULL);
+
+		for(i = 0; i < w.count && !err; i++)
+		{
+			err = w.blocks[i].err;
+			if(!err && w.blocks[i].count)
+				err = s->edges(s,w.blocks[i].edges,w.blocks[i].count);
+		}
 	}
 
-	// create edges
-	for(i = 0; i < n; i++)
-		for(j = 0; j < n; j++)
-			// if the layer allocation allows the edge, we test for it
-			if(VECTOR(layers)[i]<VECTOR(layers)[j])
-				igraph_matrix_set(&m,i,j,gsl_ran_bernoulli(r,p));
-			else
-				igraph_matrix_set(&m,i,j,0);
-
-	//translate the matrix to a graph
-	err = igraph_adjacency(g,&m,IGRAPH_ADJ_DIRECTED);
-	igraph_vector_destroy(&layers);
-d_m:
-	igraph_matrix_destroy(&m);
-	if(err) goto error;
-
-	goto ret;
-error:
-	free(g);
-	g = NULL;
-ret:
-	return g;
+	pthread_mutex_destroy(&w.lock);
+free_bm:
+	if(w.bm != NULL)
+		bit_matrix_destroy(&bm);
+free_b:
+	if(w.blocks != NULL)
+		for(i = 0; i < nblocks; i++)
+			free(w.blocks[i].edges);
+	free(w.blocks);
+	free(tids);
+	return err;
 }
 
-/* Fan-in/ Fan-out method
+/* Erdos-Renyi : G(n,p)
+ * Instead of testing each cell of the upper triangle of the adjacency
+ * matrix, we walk it row by row (row v holds the edges (w,v), w < v)
+ * and use geometric skips to find the next edge. The resulting
+ * distribution is the same but the cost is O(n+m).
+ * Dense graphs are better built the other way around: starting from a
+ * bit matrix of the full DAG, we skip to the next missing edge.
 */
-igraph_t *ggen_generate_fifo(gsl_rng *r, unsigned long n, unsigned long od, unsigned long id)
+static int erdos_gnp(gsl_rng *r, unsigned long n, double p, unsigned int threads,
+		struct ggen_edge_sink *s)
 {
-	igraph_t *g = NULL;
-	igraph_vector_t available_od;
-	igraph_vector_t out_degrees;
-	igraph_vector_t vertices;
-	igraph_vector_t choice;
-	igraph_vector_t edges;
-	unsigned long max;
-	unsigned long i,j,k;
-	unsigned long vcount = 1;
+	struct edge_batch b;
+	struct bit_matrix bm;
+	unsigned long v;
 	int err;
 
-	if(r == NULL)
-		return NULL;
+	if(r == NULL || s == NULL)
+		return 1;
 
-	if(id == 0 || od == 0 || od > n || id > n)
-		return NULL;
+	if(p < 0.0 || p > 1.0)
+		return 1;
+
+	err = s->begin(s,n,(unsigned long)(p*((double)n*(n-1)/2)));
+	if(err) return err;
+
+	edge_batch_init(&b,s);
+	if(p == 1.0)
+		err = full_dag(&b,n);
+	else if(threads > 0)
+		err = par_skip_walk(r,p,n,NULL,NULL,threads,s);
+	else if(p <= 0.5)
+		err = skip_walk(r,p,0,n,NULL,NULL,&b,NULL);
+	else
+	{
+		err = bit_matrix_init(&bm,n);
+		if(err) return err;
+
+		for(v = 0; v < n; v++)
+			bit_matrix_set_prefix(&bm,v,v);
+
+		err = skip_walk(r,1.0 - p,0,n,NULL,NULL,NULL,&bm);
+		if(!err)
+			err = bit_matrix_stream(&bm,&b,NULL,0,n);
+		bit_matrix_destroy(&bm);
+	}
+	if(err) return err;
+
+	err = edge_batch_flush(&b);
+	if(err) return err;
+
+	return s->end(s,n);
+}
+
+int ggen_stream_erdos_gnp(gsl_rng *r, unsigned long n, double p, struct ggen_edge_sink *s)
+{
+	return erdos_gnp(r,n,p,0,s);
+}
+
+int ggen_stream_erdos_gnp_parallel(gsl_rng *r, unsigned long n, double p, unsigned int threads,
+		struct ggen_edge_sink *s)
+{
+	if(threads == 0)
+		return 1;
+	return erdos_gnp(r,n,p,threads,s);
+}
 
-	g = malloc(sizeof(igraph_t));
+igraph_t *ggen_generate_erdos_gnp(gsl_rng *r, unsigned long n, double p)
+{
+	struct ggen_edge_sink *s;
+	igraph_t *g = igraph_sink_open(&s);
 	if(g == NULL)
 		return NULL;
 
-	err = igraph_empty(g,1,1);
-	if(err)
+	return igraph_sink_close(g,s,ggen_stream_erdos_gnp(r,n,p,s));
+}
+
+/* Layer by Layer :
+ * vertices are bucketed by layer, so that the possible sources of a
+ * vertex (all vertices of lower layers) form a prefix of the bucket
+ * order. Like in gnp, each vertex is a row of candidate edges and we
+ * walk those rows with geometric skips, in O(n+nbl+m).
+ * Rows are a subset of the upper triangle in bucket order, so dense
+ * graphs can also use a bit matrix, translated back with the order.
+ */
+static int erdos_lbl(gsl_rng *r, unsigned long n, double p, unsigned long nbl,
+		unsigned int threads, struct ggen_edge_sink *s)
+{
+	struct edge_batch b;
+	struct bit_matrix bm;
+	unsigned long *layers = NULL;
+	unsigned long *order = NULL;
+	unsigned long *first = NULL;
+	unsigned long *len = NULL;
+	unsigned long i,k,l;
+	double cells;
+	int err;
+
+	if(r == NULL || s == NULL)
+		return 1;
+
+	if(p < 0.0 || p > 1.0)
+		return 1;
+
+	if(nbl > n || nbl == 0)
+		return 1;
+
+	if(p == 0.0 || (p == 1.0 && nbl == n))
 	{
-		free(g);
-		return NULL;
+		err = s->begin(s,n,(p == 0.0) ? 0 : n*(n-1)/2);
+		if(err) return err;
+
+		edge_batch_init(&b,s);
+		if(p == 1.0)
+		{
+			err = full_dag(&b,n);
+			if(err) return err;
+		}
+		err = edge_batch_flush(&b);
+		if(err) return err;
+
+		return s->end(s,n);
 	}
 
-	while(vcount < n)
+	err = 1;
+	layers = malloc(n*sizeof(unsigned long));
+	order = malloc(n*sizeof(unsigned long));
+	first = calloc(nbl+1,sizeof(unsigned long));
+	len = malloc(n*sizeof(unsigned long));
+	if(!layers || !order || !first || !len)
+		goto cleanup;
+
+	// asign to each vertex a layer
+	for(i = 0; i < n; i++)
+	{
+		layers[i] = gsl_rng_uniform_int(r,nbl);
+		first[layers[i]+1]++;
+	}
+
+	// bucket vertices by layer: first[l] is the number of vertices
+	// in layers lower than l, and the position of layer l in order.
+	// len is used as a cursor in each bucket for now.
+	for(l = 0; l < nbl; l++)
+	{
+		first[l+1] += first[l];
+		len[l] = first[l];
+	}
+	for(i = 0; i < n; i++)
+		order[len[layers[i]]++] = i;
+
+	// row k contains the edges from the vertices of lower layers
+	// to the k-th vertex in order
+	cells = 0;
+	for(k = 0; k < n; k++)
+	{
+		len[k] = first[layers[order[k]]];
+		cells += len[k];
+	}
+
+	err = s->begin(s,n,(unsigned long)(p*cells));
+	if(err) goto cleanup;
+
+	edge_batch_init(&b,s);
+	if(threads > 0)
+		err = par_skip_walk(r,p,n,len,order,threads,s);
+	else if(p <= 0.5)
+		err = skip_walk(r,p,0,n,len,order,&b,NULL);
+	else
 	{
-		// some structs can be initialised together
-		err = igraph_vector_init(&available_od,vcount);
-		if(err) goto error;
+		err = bit_matrix_init(&bm,n);
+		if(err) goto cleanup;
 
-		err = igraph_vector_init(&out_degrees,vcount);
-		if(err)	goto error_io;
+		for(k = 0; k < n; k++)
+			bit_matrix_set_prefix(&bm,k,len[k]);
 
-		err = igraph_vector_init(&vertices,vcount);
-		if(err) goto error_iv;
+		err = skip_walk(r,1.0 - p,0,n,len,NULL,NULL,&bm);
+		if(!err)
+			err = bit_matrix_stream(&bm,&b,order,0,n);
+		bit_matrix_destroy(&bm);
+	}
+	if(err) goto cleanup;
+
+	err = edge_batch_flush(&b);
+	if(err) goto cleanup;
+
+	err = s->end(s,n);
+cleanup:
+	free(len);
+	free(first);
+	free(order);
+	free(layers);
+	return err;
+}
+
+int ggen_stream_erdos_lbl(gsl_rng *r, unsigned long n, double p, unsigned long nbl,
+		struct ggen_edge_sink *s)
+{
+	return erdos_lbl(r,n,p,nbl,0,s);
+}
+
+int ggen_stream_erdos_lbl_parallel(gsl_rng *r, unsigned long n, double p, unsigned long nbl,
+		unsigned int threads, struct ggen_edge_sink *s)
+{
+	if(threads == 0)
+		return 1;
+	return erdos_lbl(r,n,p,nbl,threads,s);
+}
+
+igraph_t *ggen_generate_erdos_lbl(gsl_rng *r, unsigned long n, double p, unsigned long nbl)
+{
+	struct ggen_edge_sink *s;
+	igraph_t *g = igraph_sink_open(&s);
+	if(g == NULL)
+		return NULL;
+
+	return igraph_sink_close(g,s,ggen_stream_erdos_lbl(r,n,p,nbl,s));
+}
+
+/* Fan-in/ Fan-out method
+ * Vertices are kept in an array sorted by available out degree, with
+ * bucket[d] the position of the first vertex having d available
+ * out edges (the bucket trick used for k-cores). Since new vertices
+ * always have od available out edges, they are simply appended, the
+ * vertices of maximum availability are at the end of the array and the
+ * ones with some availability left form a suffix of it. Decrementing
+ * the availability of a vertex is a swap with the head of its bucket.
+*/
+struct fifo_buckets {
+	unsigned long *avail;	// available out degree of each vertex
+	unsigned long *vert;	// vertices sorted by availability
+	unsigned long *pos;	// position of each vertex in vert
+	unsigned long *bucket;	// first position of each availability
+	unsigned long count;	// number of vertices
+};
+
+static void fifo_add_vertex(struct fifo_buckets *b, unsigned long od)
+{
+	unsigned long v = b->count++;
+	b->avail[v] = od;
+	b->vert[v] = v;
+	b->pos[v] = v;
+}
 
-		// compute the available out degree of each vertex
-		err = igraph_degree(g,&out_degrees,igraph_vss_all(),IGRAPH_OUT,0);
-		if(err) goto error_common;
+static void fifo_use_edge(struct fifo_buckets *b, unsigned long v)
+{
+	unsigned long d = b->avail[v];
+	unsigned long p = b->pos[v];
+	unsigned long q = b->bucket[d];
+	unsigned long u = b->vert[q];
+
+	// swap v with the head of its bucket, then shrink the bucket
+	b->vert[q] = v;
+	b->pos[v] = q;
+	b->vert[p] = u;
+	b->pos[u] = p;
+	b->bucket[d]++;
+	b->avail[v]--;
+}
+
+int ggen_stream_fifo(gsl_rng *r, unsigned long n, unsigned long od, unsigned long id,
+		struct ggen_edge_sink *s)
+{
+	struct edge_batch e;
+	struct fifo_buckets b;
+	unsigned long *choice = NULL;
+	char *chosen = NULL;
+	unsigned long max,size,first;
+	unsigned long i,j,k,t;
+	int err;
 
-		// fill available with od and substract out_degrees
-		igraph_vector_fill(&available_od,od);
-		err = igraph_vector_sub(&available_od,&out_degrees);
-		if(err) goto error_common;
+	if(r == NULL || s == NULL)
+		return 1;
 
+	if(id == 0 || od == 0 || od > n || id > n)
+		return 1;
+
+	// a fan-out can overshoot n by at most od-1 vertices
+	size = n + od;
+	err = 1;
+	b.count = 0;
+	b.avail = malloc(size*sizeof(unsigned long));
+	b.vert = malloc(size*sizeof(unsigned long));
+	b.pos = malloc(size*sizeof(unsigned long));
+	b.bucket = calloc(od+1,sizeof(unsigned long));
+	choice = malloc(id*sizeof(unsigned long));
+	chosen = calloc(size,sizeof(char));
+	if(!b.avail || !b.vert || !b.pos || !b.bucket || !choice || !chosen)
+		goto cleanup;
+
+	err = s->begin(s,n,0);
+	if(err) goto cleanup;
+
+	edge_batch_init(&e,s);
+	fifo_add_vertex(&b,od);
+	while(b.count < n)
+	{
 		if(gsl_ran_bernoulli(r,0.5))     //Fan-out Step
 		{
-			// find max
-			max = igraph_vector_max(&available_od);
+			// vertices having max as available outdegree are at the end
+			max = b.avail[b.vert[b.count-1]];
+			first = b.bucket[max];
 
-			// register all vertices having max as outdegree
-			j = 0;
-			for (i = 0; i < vcount;i++)
-				if(VECTOR(available_od)[i] == max)
-					VECTOR(vertices)[j++] = i;
-
-			// choose randomly a vertex among availables
-			i = gsl_rng_uniform_int(r,j);
+			// choose randomly a vertex among them
+			i = b.vert[first + gsl_rng_uniform_int(r,b.count - first)];
 
 			// how many children ?
 			j = gsl_rng_uniform_int(r,max) +1;
 
 			// create all new nodes and add edges
-			err = igraph_add_vertices(g,j,NULL);
-			if(err)	goto error_common;
-
-			err = igraph_vector_init(&edges,j*2);
-			if(err)	goto error_common;
-
 			for(k = 0; k < j; k++)
 			{
-				VECTOR(edges)[2*k] = i;
-				VECTOR(edges)[2*k+1] = vcount + k;
+				err = edge_batch_push(&e,i,b.count);
+				if(err) goto cleanup;
+				fifo_add_vertex(&b,od);
+				fifo_use_edge(&b,i);
 			}
-			vcount+=k;
 		}
 		else	//Fan-In Step
 		{
-			// register all vertices having an available outdegree
-			j = 0;
-			for (i = 0; i < vcount;i++)
-				if(VECTOR(available_od)[i] > 0)
-					VECTOR(vertices)[j++] = i;
+			// vertices having an available outdegree are at the end
+			first = b.bucket[1];
+			j = b.count - first;
 
 			// we can add at most id vertices
 			max =( j > id)? id: j;
 			// how many edges to add
 			k = gsl_rng_uniform_int(r,max) +1;
 
-			// choose that many nodes and add edges from them to the new node
-			err = igraph_vector_init(&choice,k);
-			if(err)	goto error_common;
-
-			gsl_ran_choose(r,VECTOR(choice),k,
-				VECTOR(vertices),j,sizeof(VECTOR(vertices)[0]));
-
-			// add a vertex to the graph
-			err = igraph_add_vertices(g,1,NULL);
-			if(err)
+			// choose that many nodes (Floyd's sampling, no scan)
+			for(t = j - k, i = 0; t < j; t++, i++)
 			{
-				igraph_vector_destroy(&choice);
-				goto error_common;
+				choice[i] = gsl_rng_uniform_int(r,t+1);
+				if(chosen[choice[i]])
+					choice[i] = t;
+				chosen[choice[i]] = 1;
 			}
-
-			err = igraph_vector_init(&edges,k*2);
-			if(err)
+			// translate positions to vertices before any of them moves
+			for(i = 0; i < k; i++)
 			{
-				igraph_vector_destroy(&choice);
-				goto error_common;
+				chosen[choice[i]] = 0;
+				choice[i] = b.vert[first + choice[i]];
 			}
-			// be carefull, vcount is the last ID of vertices not vcount +1
+
+			// add edges from them to the new node
 			for(i = 0; i < k; i++)
 			{
-				VECTOR(edges)[2*i] = VECTOR(choice)[i];
-				VECTOR(edges)[2*i+1] = vcount;
+				err = edge_batch_push(&e,choice[i],b.count);
+				if(err) goto cleanup;
+				fifo_use_edge(&b,choice[i]);
 			}
-			vcount++;
-			igraph_vector_destroy(&choice);
-
+			fifo_add_vertex(&b,od);
 		}
-		// in all cases, edges should be added
-		err = igraph_add_edges(g,&edges,NULL);
-		igraph_vector_destroy(&edges);
-		if(err) goto error_common;
-
-		// destroy common vectors
-		igraph_vector_destroy(&vertices);
-		igraph_vector_destroy(&out_degrees);
-		igraph_vector_destroy(&available_od);
 	}
-	return g;
-error_common:
-	igraph_vector_destroy(&vertices);
-error_iv:
-	igraph_vector_destroy(&out_degrees);
-error_io:
-	igraph_vector_destroy(&available_od);
-error:
-	igraph_destroy(g);
-	free(g);
-	return NULL;
+
+	err = edge_batch_flush(&e);
+	if(err) goto cleanup;
+
+	err = s->end(s,b.count);
+cleanup:
+	free(chosen);
+	free(choice);
+	free(b.bucket);
+	free(b.pos);
+	free(b.vert);
+	free(b.avail);
+	return err;
 }
 
+igraph_t *ggen_generate_fifo(gsl_rng *r, unsigned long n, unsigned long od, unsigned long id)
+{
+	struct ggen_edge_sink *s;
+	igraph_t *g = igraph_sink_open(&s);
+	if(g == NULL)
+		return NULL;
+
+	return igraph_sink_close(g,s,ggen_stream_fifo(r,n,od,id,s));
+}
 
 /* Random Orders Method :
+ * The partial order is the intersection of total orders. Vertices are
+ * labelled by their position in the first order, so the predecessors
+ * of a vertex v are a subset of [0,v) and only orders-1 random
+ * permutations are needed: pos[o][v] is the position of v in order o+1.
+ *
+ * With at most two orders, u < v precedes v iff pos[0][u] < pos[0][v]:
+ * a dominance sweep finds these pairs with O(n) memory.
+ * With more orders, the predecessors of each vertex are stored in a
+ * bit matrix and intersected order after order, 64 at a time.
+ *
+ * If hasse is set, only the covering edges (the transitive reduction of
+ * the order) are pushed.
 */
-igraph_t * ggen_generate_random_orders(gsl_rng *r, unsigned long n, unsigned int orders)
+
+/* In two dimensions, the covers of v are the maximal points of the
+ * quadrant below v. Taken by decreasing x, their y increase: the first
+ * one is the largest u < v with y[u] < y[v], and the next after c the
+ * largest u with y[u] in (y[c],y[v]), any u > c in that range being
+ * below an earlier cover. Vertices are inserted by increasing x in a
+ * tree over y keeping the largest x of each range, so each cover costs
+ * one O(log n) query and the sweep O((n + edges) log n).
+ */
+static long ro_tree_max(const long *tree, unsigned long size, unsigned long lo,
+		unsigned long hi)
 {
-	igraph_t *g = NULL;
-	igraph_matrix_t m,edge_validity;
-	int err = 0;
-	long long i = 0,j,k;
-	igraph_vector_t posets[orders];
-	igraph_vector_t index[orders];
+	long m = -1;
+	// maximum over [lo,hi)
+	for(lo += size, hi += size; lo < hi; lo /= 2, hi /= 2)
+	{
+		if((lo & 1) && tree[lo++] > m)
+			m = tree[lo-1];
+		if((hi & 1) && tree[--hi] > m)
+			m = tree[hi];
+	}
+	return m;
+}
 
-	if(r == NULL)
-		return NULL;
+static int ro_sweep_hasse(struct edge_batch *b, unsigned long n, unsigned long *y)
+{
+	unsigned long v,i,size,lo;
+	long *tree,u;
+	int err = 1;
 
-	if(orders == 0)
-		return NULL;
+	for(size = 1; size < n; size *= 2)
+		;
+	tree = malloc(2*size*sizeof(long));
+	if(tree == NULL)
+		return 1;
+	for(i = 0; i < 2*size; i++)
+		tree[i] = -1;
 
-	// init structures
-	g = malloc(sizeof(igraph_t));
-	if(g == NULL)
-		return NULL;
+	for(v = 0; v < n; v++)
+	{
+		for(lo = 0; (u = ro_tree_max(tree,size,lo,y[v])) != -1; lo = y[u] + 1)
+		{
+			err = edge_batch_push(b,u,v);
+			if(err) goto cleanup;
+		}
+		// insertion: x only grows, v is the maximum of its ranges
+		for(i = y[v] + size; i > 0; i /= 2)
+			tree[i] = v;
+	}
+	err = 0;
+cleanup:
+	free(tree);
+	return err;
+}
 
-	err = igraph_matrix_init(&m,n,n);
-	if(err)
-		goto f_g;
+static int ro_sweep(struct edge_batch *b, unsigned long n, unsigned long *y, int hasse)
+{
+	unsigned long u,v;
+	int err;
 
-	err = igraph_matrix_init(&edge_validity,n,n);
-	if(err)
-		goto d_m;
+	if(hasse)
+		return ro_sweep_hasse(b,n,y);
 
-	for(i = 0; i < orders; i++)
+	for(v = 1; v < n; v++)
+		for(u = v; u-- > 0;)
+		{
+			if(y[u] > y[v])
+				continue;
+			err = edge_batch_push(b,u,v);
+			if(err) return err;
+		}
+	return 0;
+}
+
+static int ro_bitsets(struct edge_batch *b, unsigned long n, unsigned int orders,
+		unsigned long **pos, int hasse)
+{
+	struct bit_matrix preds;
+	uint64_t *seen = NULL;
+	uint64_t *col,*ucol;
+	unsigned long *perm = NULL;
+	unsigned long i,o,u,v,w,k;
+	uint64_t bits;
+	int err = 1;
+
+	// column v of preds holds the predecessors of v
+	if(bit_matrix_init(&preds,n))
+		return 1;
+
+	perm = malloc((n+1)*sizeof(unsigned long));
+	seen = malloc((BM_WORDS(n)+1)*sizeof(uint64_t));
+	if(!perm || !seen)
+		goto cleanup;
+
+	// intersect the prefixes of each order
+	for(o = 0; o < orders - 1; o++)
 	{
-		// posets is used for permutation computations
-		// it should contain vertices
-		err = igraph_vector_init_seq(&(posets[i]),0,n-1);
-		if(err)
-			goto d_p;
-
-		err = igraph_vector_init(&(index[i]),n);
-		if(err)
-			goto d_i;
-	}
+		for(v = 0; v < n; v++)
+			perm[pos[o][v]] = v;
 
-	// zero all structs
-	igraph_matrix_null(&m);
-	igraph_matrix_null(&edge_validity);
+		memset(seen,0,BM_WORDS(n)*sizeof(uint64_t));
+		for(i = 0; i < n; i++)
+		{
+			v = perm[i];
+			col = bit_matrix_column(&preds,v);
+			for(w = 0; w < BM_WORDS(v); w++)
+				col[w] = (o == 0) ? seen[w] : col[w] & seen[w];
+			// forget vertices above v
+			if(v % 64)
+				col[v/64] &= (UINT64_C(1) << (v % 64)) - 1;
+			seen[v/64] |= UINT64_C(1) << (v % 64);
+		}
+	}
 
-	// use gsl to shuffle each poset
-	for( j = 0; j < orders; j++)
-		gsl_ran_shuffle(r,VECTOR(posets[j]), n, sizeof(VECTOR(posets[j])[0]));
+	if(!hasse)
+	{
+		err = bit_matrix_stream(&preds,b,NULL,0,n);
+		goto cleanup;
+	}
 
-	// index saves the indices of each vertex in each permutation
-	for( i = 0; i < orders; i++)
-		for( j = 0; j < n; j++)
+	// seen is now used to mark vertices that cannot be covers
+	memset(seen,0,BM_WORDS(n)*sizeof(uint64_t));
+	for(v = 1; v < n; v++)
+	{
+		col = bit_matrix_column(&preds,v);
+		for(w = BM_WORDS(v); w-- > 0;)
 		{
-			k = VECTOR(posets[i])[j];
-			VECTOR(index[i])[k] = j;
+			bits = col[w] & ~seen[w];
+			while(bits)
+			{
+				k = 63 - __builtin_clzll(bits);
+				bits &= ~(UINT64_C(1) << k);
+				u = w*64 + k;
+				err = edge_batch_push(b,u,v);
+				if(err) goto cleanup;
+
+				// everything below u is not a cover of v
+				ucol = bit_matrix_column(&preds,u);
+				for(i = 0; i < BM_WORDS(u); i++)
+					seen[i] |= ucol[i];
+				bits &= ~seen[w];
+			}
 		}
+		memset(seen,0,BM_WORDS(v)*sizeof(uint64_t));
+	}
+	err = 0;
+cleanup:
+	free(seen);
+	free(perm);
+	bit_matrix_destroy(&preds);
+	return err;
+}
+
+static int random_orders(gsl_rng *r, unsigned long n, unsigned int orders, int hasse,
+		struct ggen_edge_sink *s)
+{
+	struct edge_batch b;
+	unsigned long **pos = NULL;
+	unsigned long *perm = NULL;
+	unsigned long i,o,npos;
+	int err;
+
+	if(r == NULL || s == NULL)
+		return 1;
 
-	// edge_validity count if an edge is in all permutations
-	for( i = 0; i < n; i++)
-		for( j = 0; j < n; j++)
-			for( k = 0; k < orders; k++)
-				if( VECTOR(index[k])[i] < VECTOR(index[k])[j])
-					igraph_matrix_set(&edge_validity,i,j,
-						igraph_matrix_e(&edge_validity,i,j)+1);
-
-	// if an edge is present in all permutations then add it to the graph
-	for( i = 0; i < n; i++)
-		for( j = 0; j < n; j++)
-			if(igraph_matrix_e(&edge_validity,i,j) == orders)
-				igraph_matrix_set(&m,i,j,1);
-
-	// translate the matrix to a graph
-	err = igraph_adjacency(g,&m,IGRAPH_ADJ_DIRECTED);
-
-	// cleanup
-	// we destroy vector in the opposite way we initialized them
-	// and skip the index one if any failed
-	i = orders -1;
-	for(; i >= 0; i--)
+	if(orders == 0)
+		return 1;
+
+	// with a single order, the sweep runs against the identity
+	npos = (orders > 1) ? orders - 1 : 1;
+	err = 1;
+	pos = calloc(npos,sizeof(unsigned long *));
+	perm = malloc((n+1)*sizeof(unsigned long));
+	if(!pos || !perm)
+		goto cleanup;
+
+	for(o = 0; o < npos; o++)
 	{
-		igraph_vector_destroy(&(index[i]));
-d_i:
-		igraph_vector_destroy(&(posets[i]));
-d_p:
-		;
+		pos[o] = malloc((n+1)*sizeof(unsigned long));
+		if(pos[o] == NULL)
+			goto cleanup;
 	}
 
-	igraph_matrix_destroy(&edge_validity);
-d_m:
-	igraph_matrix_destroy(&m);
-	if(err)
+	// use gsl to shuffle each order but the first, and save the
+	// position of each vertex in it
+	for(i = 0; i < n; i++)
+		pos[0][i] = i;
+	for(o = 0; o < orders - 1; o++)
 	{
-f_g:
-		free(g);
-		g = NULL;
+		for(i = 0; i < n; i++)
+			perm[i] = i;
+		gsl_ran_shuffle(r,perm,n,sizeof(unsigned long));
+		for(i = 0; i < n; i++)
+			pos[o][perm[i]] = i;
 	}
-	return g;
+
+	err = s->begin(s,n,0);
+	if(err) goto cleanup;
+
+	edge_batch_init(&b,s);
+	if(orders <= 2)
+		err = ro_sweep(&b,n,pos[0],hasse);
+	else
+		err = ro_bitsets(&b,n,orders,pos,hasse);
+	if(err) goto cleanup;
+
+	err = edge_batch_flush(&b);
+	if(err) goto cleanup;
+
+	err = s->end(s,n);
+cleanup:
+	if(pos != NULL)
+		for(o = 0; o < npos; o++)
+			free(pos[o]);
+	free(pos);
+	free(perm);
+	return err;
+}
+
+int ggen_stream_random_orders(gsl_rng *r, unsigned long n, unsigned int orders,
+		struct ggen_edge_sink *s)
+{
+	return random_orders(r,n,orders,0,s);
+}
+
+int ggen_stream_random_orders_hasse(gsl_rng *r, unsigned long n, unsigned int orders,
+		struct ggen_edge_sink *s)
+{
+	return random_orders(r,n,orders,1,s);
+}
+
+igraph_t *ggen_generate_random_orders(gsl_rng *r, unsigned long n, unsigned int orders)
+{
+	struct ggen_edge_sink *s;
+	igraph_t *g = igraph_sink_open(&s);
+	if(g == NULL)
+		return NULL;
+
+	return igraph_sink_close(g,s,random_orders(r,n,orders,0,s));
+}
+
+igraph_t *ggen_generate_random_orders_hasse(gsl_rng *r, unsigned long n, unsigned int orders)
+{
+	struct ggen_edge_sink *s;
+	igraph_t *g = igraph_sink_open(&s);
+	if(g == NULL)
+		return NULL;
+
+	return igraph_sink_close(g,s,random_orders(r,n,orders,1,s));
 }
@@ -0,0 +1,265 @@
+/* Copyright Swann Perarnau 2009
+*
+*   contact : Swann.Perarnau@imag.fr
+*
+* This software is a computer program whose purpose is to help the
+* random generation of graph structures and adding various properties
+* on those structures.
+*
+* This software is governed by the CeCILL  license under French law and
+* abiding by the rules of distribution of free software.  You can  use,
+* modify and/ or redistribute the software under the terms of the CeCILL
+* license as circulated by CEA, CNRS and INRIA at the following URL
+* "http://www.cecill.info".
+*
+* As a counterpart to the access to the source code and  rights to copy,
+* modify and redistribute granted by the license, users are provided only
+* with a limited warranty  and the software's author,  the holder of the
+* economic rights,  and the successive licensors  have only  limited
+* liability.
+*
+* In this respect, the user's attention is drawn to the risks associated
+* with loading,  using,  modifying and/or developing or reproducing the
+* software by the user in light of its specific status of free software,
+* that may mean  that it is complicated to manipulate,  and  that  also
+* therefore means  that it is reserved for developers  and  experienced
+* professionals having in-depth computer knowledge. Users are therefore
+* encouraged to load and test the software's suitability as regards their
+* requirements in conditions enabling the security of their systems and/or
+* data to be ensured and,  more generally, to use and operate it in the
+* same conditions as regards security.
+*
+* The fact that you are presently reading this means that you have had
+* knowledge of the CeCILL license and that you accept its terms.
+*/
+
+/* Graph input/output:
+ * the whole input is loaded in memory, mapped when it is a regular file,
+ * and its first bytes tell us which reader to use. The input can hold
+ * several graphs, found by a quick scan, without parsing them: readers are
+ * handed one graph at a time. Output only depends on the format asked for.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "utils.h"
+#include "log.h"
+
+enum ggen_format ggen_input_format = GGEN_FORMAT_AUTO;
+enum ggen_format ggen_output_format = GGEN_FORMAT_DOT;
+
+unsigned int ggen_read_attrs = GGEN_ATTRS_ALL;
+enum ggen_object ggen_read_kind = GGEN_OBJECT_VERTEX;
+const char *ggen_read_name = NULL;
+
+unsigned long ggen_io_threads = 1;
+
+#define GGEN_READ_EXTRA 4
+static struct { enum ggen_object kind; const char *name; } read_extra[GGEN_READ_EXTRA];
+static int nread_extra = 0;
+
+void ggen_read_property(enum ggen_object kind, const char *name)
+{
+	if(name == NULL || nread_extra == GGEN_READ_EXTRA)
+		return;
+	read_extra[nread_extra].kind = kind;
+	read_extra[nread_extra].name = name;
+	nread_extra++;
+}
+
+static int attr_is(const char *name, size_t len, const char *s)
+{
+	return s != NULL && strlen(s) == len && !memcmp(name,s,len);
+}
+
+int ggen_attr_wanted(enum ggen_object kind, const char *name, size_t len)
+{
+	int i;
+	for(i = 0; i < nread_extra; i++)
+		if(kind == read_extra[i].kind && attr_is(name,len,read_extra[i].name))
+			return 1;
+	if((ggen_read_attrs & GGEN_ATTRS_PROPERTY) && kind == ggen_read_kind
+			&& attr_is(name,len,ggen_read_name))
+		return 1;
+	if((kind == GGEN_OBJECT_GRAPH && attr_is(name,len,GGEN_GRAPH_NAME_ATTR))
+			|| (kind == GGEN_OBJECT_VERTEX && attr_is(name,len,GGEN_VERTEX_NAME_ATTR)))
+		return (ggen_read_attrs & GGEN_ATTRS_NAMES) != 0;
+	return (ggen_read_attrs & GGEN_ATTRS_OTHERS) != 0;
+}
+
+/* a pipe is read by large blocks in a growing buffer */
+#define INPUT_BLOCK (1 << 20)
+
+int ggen_input_load(struct ggen_input *in, FILE *f)
+{
+	struct stat st;
+	size_t size,n;
+	char *tmp;
+
+	in->data = NULL;
+	in->len = 0;
+	in->mapped = 0;
+
+	/* only a regular file that nobody read from can be mapped */
+	if(fstat(fileno(f),&st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0
+			&& ftello(f) == 0)
+	{
+		tmp = mmap(NULL,st.st_size,PROT_READ,MAP_PRIVATE,fileno(f),0);
+		if(tmp != MAP_FAILED)
+		{
+			madvise(tmp,st.st_size,MADV_SEQUENTIAL);
+			in->data = tmp;
+			in->len = st.st_size;
+			in->mapped = 1;
+			return 0;
+		}
+	}
+
+	size = 0;
+	do {
+		if(in->len == size)
+		{
+			size = size ? 2*size : INPUT_BLOCK;
+			tmp = realloc(in->data,size);
+			if(tmp == NULL)
+				goto error;
+			in->data = tmp;
+		}
+		n = fread(in->data + in->len,1,size - in->len,f);
+		in->len += n;
+	} while(n > 0);
+
+	if(ferror(f))
+		goto error;
+	return 0;
+error:
+	free(in->data);
+	in->data = NULL;
+	return 1;
+}
+
+void ggen_input_free(struct ggen_input *in)
+{
+	if(in->mapped)
+		munmap(in->data,in->len);
+	else
+		free(in->data);
+}
+
+int ggen_corpus_open(struct ggen_corpus *c, FILE *f)
+{
+	c->pos = 0;
+	c->count = 0;
+	c->next = 0;
+	c->container = 0;
+	if(ggen_input_load(&c->in,f))
+		return 1;
+
+	c->format = ggen_input_format;
+	if(c->format == GGEN_FORMAT_AUTO)
+		c->format = ggen_is_binary(c->in.data,c->in.len) ? GGEN_FORMAT_BINARY : GGEN_FORMAT_DOT;
+
+	if(c->format == GGEN_FORMAT_BINARY && ggen_is_container(c->in.data,c->in.len))
+	{
+		if(ggen_container_index(c->in.data,c->in.len,&c->count))
+		{
+			ggen_input_free(&c->in);
+			return 1;
+		}
+		c->container = 1;
+	}
+	return 0;
+}
+
+int ggen_corpus_next(struct ggen_corpus *c, char **data, size_t *len)
+{
+	uint64_t off,size;
+	size_t rest;
+
+	if(c->container)
+	{
+		if(ggen_container_graph(c->in.data,c->in.len,c->next,&off,&size))
+			return 0;
+		c->next++;
+		*data = c->in.data + off;
+		*len = size;
+		return 1;
+	}
+
+	rest = c->in.len - c->pos;
+	*data = c->in.data + c->pos;
+	if(c->format == GGEN_FORMAT_DOT)
+		*len = ggen_dot_graph_end(*data,rest);
+	else if(c->format == GGEN_FORMAT_BINARY)
+		*len = ggen_binary_record_size(*data,rest);
+	else
+		/* an edge list is the whole input */
+		*len = rest;
+
+	/* an empty input is still one (invalid) graph */
+	if(*len == 0 && (c->next > 0 || rest > 0))
+		return 0;
+	c->pos += *len;
+	c->next++;
+	return 1;
+}
+
+void ggen_corpus_close(struct ggen_corpus *c)
+{
+	ggen_input_free(&c->in);
+}
+
+int ggen_read_graph_data(igraph_t *g, enum ggen_format format, char *data, size_t len)
+{
+	if(len == 0)
+	{
+		error("Empty graph input\n");
+		return 1;
+	}
+	if(format == GGEN_FORMAT_BINARY)
+		return ggen_read_graph_binary(g,data,len);
+	if(format == GGEN_FORMAT_EDGELIST)
+		return ggen_read_graph_edgelist(g,data,len);
+	return ggen_read_graph_dot(g,data,len);
+}
+
+/* the first graph of the input */
+int ggen_read_graph(igraph_t *g, FILE *input)
+{
+	struct ggen_corpus c;
+	char *data;
+	size_t len;
+	int err;
+
+	if(ggen_corpus_open(&c,input))
+		return 1;
+	if(ggen_corpus_next(&c,&data,&len) == 1)
+		err = ggen_read_graph_data(g,c.format,data,len);
+	else
+	{
+		error("Empty graph input\n");
+		err = 1;
+	}
+	ggen_corpus_close(&c);
+	return err;
+}
+
+int ggen_write_graph(igraph_t *g, FILE *output)
+{
+	if(ggen_output_format == GGEN_FORMAT_BINARY)
+		return ggen_write_graph_binary(g,output);
+	if(ggen_output_format == GGEN_FORMAT_EDGELIST)
+		return ggen_write_graph_edgelist(g,output);
+	return ggen_write_graph_dot(g,output);
+}
+
+struct ggen_edge_sink *ggen_output_sink(FILE *output)
+{
+	if(ggen_output_format == GGEN_FORMAT_BINARY)
+		return ggen_edge_sink_binary(output);
+	if(ggen_output_format == GGEN_FORMAT_EDGELIST)
+		return ggen_edge_sink_edgelist(output);
+	return ggen_edge_sink_dot(output,GGEN_DEFAULT_GRAPH_NAME);
+}
@@ -44,10 +44,30 @@
 
 #include "ggen.h"
 
+/* sources (in-degree zero) or sinks of d, in vertices. Self loops are
+ * not counted, like igraph_degree() without loops did */
+static unsigned int dag_ends(const struct ggen_dag *d, enum ggen_transform_t t,
+		igraph_vector_t *vertices)
+{
+	const uint32_t *off,*adj;
+	uint32_t v,i;
+	unsigned int ssize = 0;
+
+	off = t == GGEN_TRANSFORM_SOURCE ? d->in_off : d->out_off;
+	adj = t == GGEN_TRANSFORM_SOURCE ? d->in : d->out;
+	for(v = 0; v < d->n; v++)
+	{
+		for(i = off[v]; i < off[v+1] && adj[i] == v; i++);
+		if(i == off[v+1])
+			VECTOR(*vertices)[ssize++] = v;
+	}
+	return ssize;
+}
+
 int ggen_transform_add(igraph_t *g, enum ggen_transform_t t)
 {
+	struct ggen_dag d;
 	igraph_vector_t vertices;
-	igraph_vector_t degrees;
 	igraph_vector_t edges;
 	unsigned int i,vcount,ssize;
 	int err;
@@ -60,28 +80,21 @@ int ggen_transform_add(igraph_t *g, enum ggen_transform_t t)
 	err = igraph_vector_init(&vertices,vcount);
 	if(err) return 1;
 
-	err = igraph_vector_init(&degrees,vcount);
+	err = ggen_dag_init(&d,g);
 	if(err) goto error_id;
 
-	/* find degree of each vertex, in if new source is wanted. */
-	err = igraph_degree(g,&degrees,igraph_vss_all(),
-		(t==GGEN_TRANSFORM_SOURCE)?IGRAPH_IN:IGRAPH_OUT,0);
-	if(err) goto error;
-
 	/* only sources or sinks are of interest */
-	ssize = 0;
-	for(i = 0; i < vcount; i++)
-		if(VECTOR(degrees)[i] == 0)
-			VECTOR(vertices)[ssize++] = i;
+	ssize = dag_ends(&d,t,&vertices);
+	ggen_dag_destroy(&d);
 
 	/* we have something to do */
 	if(ssize > 0)
 	{
 		err = igraph_add_vertices(g,1,NULL);
-		if(err) goto error;
+		if(err) goto error_id;
 
 		err = igraph_vector_init(&edges,ssize*2);
-		if(err) goto error;
+		if(err) goto error_id;
 
 		for(i = 0; i < ssize; i++)
 		{
@@ -99,10 +112,7 @@ int ggen_transform_add(igraph_t *g, enum ggen_transform_t t)
 
 		err = igraph_add_edges(g,&edges,NULL);
 		igraph_vector_destroy(&edges);
-		if(err) goto error;
 	}
-error:
-	igraph_vector_destroy(&degrees);
 error_id:
 	igraph_vector_destroy(&vertices);
 	return err;
@@ -110,9 +120,9 @@ error_id:
 
 int ggen_transform_delete(igraph_t *g, enum ggen_transform_t t)
 {
+	struct ggen_dag d;
 	igraph_vector_t vertices;
-	igraph_vector_t degrees;
-	unsigned int i,vcount,ssize;
+	unsigned int vcount,ssize;
 	int err;
 
 	if(g == NULL)
@@ -123,32 +133,22 @@ int ggen_transform_delete(igraph_t *g, enum ggen_transform_t t)
 	err = igraph_vector_init(&vertices,vcount);
 	if(err) return 1;
 
-	err = igraph_vector_init(&degrees,vcount);
+	err = ggen_dag_init(&d,g);
 	if(err) goto error_id;
 
-	/* find degree of each vertex, igraph_in if we need to identify sources. */
-	err = igraph_degree(g,&degrees,igraph_vss_all(),
-		(t==GGEN_TRANSFORM_SOURCE)?IGRAPH_IN:IGRAPH_OUT,0);
-	if(err) goto error;
-
 	/* only sources or sinks are of interest */
-	ssize = 0;
-	for(i = 0; i < vcount; i++)
-		if(VECTOR(degrees)[i] == 0)
-			VECTOR(vertices)[ssize++] = i;
+	ssize = dag_ends(&d,t,&vertices);
+	ggen_dag_destroy(&d);
 
 	/* delete all identified vertices */
 	if(ssize > 0)
 	{
 		/* we should resize the array to avoid strange behaviors */
 		err = igraph_vector_resize(&vertices,ssize);
-		if(err) goto error;
+		if(err) goto error_id;
 
 		err = igraph_delete_vertices(g,igraph_vss_vector(&vertices));
-		if(err) goto error;
 	}
-error:
-	igraph_vector_destroy(&degrees);
 error_id:
 	igraph_vector_destroy(&vertices);
 	return err;
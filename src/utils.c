@@ -34,6 +34,7 @@
 */
 #define GGEN_CGRAPH_DEFAULT_VALUE ""
 #include <graphviz/cgraph.h>
+#include <math.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -128,6 +129,63 @@ int s2d(char *s,double *d)
 
 }
 
+void d2s(double d,char *s,size_t size)
+{
+	/* shortest of the usual precisions that reads back exactly */
+	snprintf(s,size,"%.15g",d);
+	if(strtod(s,NULL) != d)
+		snprintf(s,size,"%.17g",d);
+}
+
+int ggen_is_number(const char *s,size_t len)
+{
+	char tmp[GGEN_DEFAULT_NAME_SIZE],back[GGEN_DEFAULT_NAME_SIZE];
+	size_t i = 0,digits = 0;
+	int integer = 1;
+	double d;
+
+	if(i < len && s[i] == '-')
+		i++;
+	/* leading zeros would be lost */
+	if(i + 1 < len && s[i] == '0' && s[i+1] >= '0' && s[i+1] <= '9')
+		return 0;
+	for(; i < len && s[i] >= '0' && s[i] <= '9'; i++)
+		digits++;
+	if(i < len && s[i] == '.')
+		for(i++, integer = 0; i < len && s[i] >= '0' && s[i] <= '9'; i++)
+			digits++;
+	if(digits == 0)
+		return 0;
+	if(i < len && (s[i] == 'e' || s[i] == 'E'))
+	{
+		integer = 0;
+		i++;
+		if(i < len && (s[i] == '-' || s[i] == '+'))
+			i++;
+		if(i == len || s[i] < '0' || s[i] > '9')
+			return 0;
+		while(i < len && s[i] >= '0' && s[i] <= '9')
+			i++;
+	}
+	if(i != len)
+		return 0;
+
+	/* integers of up to 15 digits are exact doubles, printed back the same */
+	if(integer && digits <= 15)
+		return 1;
+	/* anything else must be printed back the same by d2s: no trailing
+	 * zeros, extra digits or overflow, the value is data */
+	if(len >= sizeof(tmp))
+		return 0;
+	memcpy(tmp,s,len);
+	tmp[len] = '\0';
+	d = strtod(tmp,NULL);
+	if(!isfinite(d))
+		return 0;
+	d2s(d,back,sizeof(back));
+	return !strcmp(tmp,back);
+}
+
 /* graph io */
 /* this use cgraph to read/write dot */
 static char * vid2vname_unsafe(char *s, igraph_t *g, unsigned long id)
@@ -162,31 +220,134 @@ char * ggen_vname(char *s, igraph_t *g, unsigned long id)
 	return r;
 }
 
-/* find an id in an array */
-static unsigned long find_id(unsigned long id,igraph_vector_t v,unsigned long n)
+/* each cgraph node carries its igraph id in a record,
+ * looking it up is a pointer dereference instead of a search */
+#define GGEN_VREC_NAME "ggen_vrec"
+
+struct ggen_vrec {
+	Agrec_t header;
+	unsigned long id;
+};
+
+#define VREC_ID(v) (((struct ggen_vrec *)AGDATA(v))->id)
+
+
+/* attributes of one kind of cgraph objects, read column by column:
+ * values are collected in the same pass as the structure and given to
+ * igraph in bulk.
+ */
+struct attr_columns {
+	unsigned long count;
+	Agsym_t **syms;
+	igraph_strvector_t *values;
+};
+
+static void attr_columns_destroy(struct attr_columns *c)
 {
 	unsigned long i;
-	for(i = 0; i < n; i++)
-		if(VECTOR(v)[i] == id)
-			return i;
+	for(i = 0; i < c->count; i++)
+		igraph_strvector_destroy(&c->values[i]);
+	free(c->values);
+	free(c->syms);
+}
 
-	error("BUG: this function should not fail: %s\n",__func__);
+static int attr_columns_init(struct attr_columns *c, Agraph_t *cg, int kind, unsigned long size)
+{
+	Agsym_t *att;
+	unsigned long i,n;
+	int err;
+
+	i = 0;
+	n = 0;
+	for(att = agnxtattr(cg,kind,NULL); att; att = agnxtattr(cg,kind,att))
+		n++;
+
+	c->syms = malloc(n*sizeof(Agsym_t *));
+	c->values = malloc(n*sizeof(igraph_strvector_t));
+	if(n && (c->syms == NULL || c->values == NULL))
+		goto error;
+
+	/* attributes nobody asked for are not read */
+	for(att = agnxtattr(cg,kind,NULL); att; att = agnxtattr(cg,kind,att))
+	{
+		if(!ggen_attr_wanted(kind == AGNODE ? GGEN_OBJECT_VERTEX : GGEN_OBJECT_EDGE,
+					att->name,strlen(att->name)))
+			continue;
+		err = igraph_strvector_init(&c->values[i],size);
+		if(err) goto error;
+		c->syms[i++] = att;
+	}
+	c->count = i;
 	return 0;
+error:
+	c->count = i;
+	attr_columns_destroy(c);
+	return 1;
 }
 
+static int attr_columns_read(struct attr_columns *c, void *obj, unsigned long id)
+{
+	unsigned long i;
+	int err;
 
-int ggen_read_graph(igraph_t *g,FILE *input)
+	for(i = 0; i < c->count; i++)
+	{
+		err = igraph_strvector_set(&c->values[i],id,agxget(obj,c->syms[i]));
+		if(err) return err;
+	}
+	return 0;
+}
+
+/* numeric values are given to igraph as numbers, so that analysis does not
+ * convert them again and again */
+static int attr_is_numeric(igraph_strvector_t *values)
+{
+	long i;
+
+	for(i = 0; i < igraph_strvector_size(values); i++)
+		if(!ggen_is_number(STR(*values,i),strlen(STR(*values,i))))
+			return 0;
+	return igraph_strvector_size(values) > 0;
+}
+
+int ggen_set_graph_attr(igraph_t *g,const char *name,const char *value)
+{
+	if(ggen_is_number(value,strlen(value)))
+		return SETGAN(g,name,strtod(value,NULL));
+	return SETGAS(g,name,value);
+}
+
+int ggen_set_attr_column(igraph_t *g,const char *name,igraph_strvector_t *values,int vertex)
+{
+	igraph_vector_t numbers;
+	long i;
+	int err;
+
+	if(!attr_is_numeric(values))
+		return vertex ? SETVASV(g,name,values) : SETEASV(g,name,values);
+
+	err = igraph_vector_init(&numbers,igraph_strvector_size(values));
+	if(err) return err;
+	for(i = 0; i < igraph_strvector_size(values); i++)
+		VECTOR(numbers)[i] = strtod(STR(*values,i),NULL);
+	err = vertex ? SETVANV(g,name,&numbers) : SETEANV(g,name,&numbers);
+	igraph_vector_destroy(&numbers);
+	return err;
+}
+
+int ggen_read_graph_cgraph(igraph_t *g,FILE *input)
 {
 	Agraph_t *cg;
 	Agnode_t *v;
 	Agedge_t *e;
 	igraph_vector_t edges;
-	igraph_vector_t vertices;
-	int err;
+	igraph_strvector_t vnames;
+	struct attr_columns vattrs,eattrs;
+	int err,names;
+	unsigned long i;
 	unsigned long esize;
 	unsigned long vsize;
 	unsigned long from, to;
-	igraph_integer_t eid;
 	Agsym_t *att;
 
 	/* read the graph */
@@ -204,25 +365,52 @@ int ggen_read_graph(igraph_t *g,FILE *input)
 	err = igraph_vector_init(&edges,2*agnedges(cg));
 	if(err) goto error_d;
 
-	err = igraph_vector_init(&vertices,agnnodes(cg));
+	/* init attribute columns */
+	names = ggen_attr_wanted(GGEN_OBJECT_VERTEX,GGEN_VERTEX_NAME_ATTR,
+			strlen(GGEN_VERTEX_NAME_ATTR));
+	err = igraph_strvector_init(&vnames,names ? agnnodes(cg) : 0);
 	if(err) goto error_de;
 
+	err = attr_columns_init(&vattrs,cg,AGNODE,agnnodes(cg));
+	if(err) goto error_dvn;
+
+	err = attr_columns_init(&eattrs,cg,AGEDGE,agnedges(cg));
+	if(err) goto error_dva;
+
 	/* init igraph */
 	igraph_empty(g,agnnodes(cg),1);
 
-	/* asign id to each vertex */
+	/* asign id to each vertex, the record is kept in front of the
+	 * others so that AGDATA points to it */
+	aginit(cg,AGNODE,GGEN_VREC_NAME,sizeof(struct ggen_vrec),1);
 	vsize = 0;
 	for(v = agfstnode(cg); v; v = agnxtnode(cg,v))
-		VECTOR(vertices)[vsize++] = AGID(v);
+	{
+		/* we keep each vertex name in a special attribute */
+		if(names)
+		{
+			err = igraph_strvector_set(&vnames,vsize,agnameof(v));
+			if(err) goto error;
+		}
+
+		err = attr_columns_read(&vattrs,v,vsize);
+		if(err) goto error;
 
-	/* loop through each edge */
+		VREC_ID(v) = vsize++;
+	}
+
+	/* loop through each edge, edge ids in igraph will follow
+	 * the order of the edge array */
 	esize = 0;
 	for(v = agfstnode(cg); v; v = agnxtnode(cg,v))
 	{
-		from = find_id(AGID(v),vertices,vsize);
+		from = VREC_ID(v);
 		for(e = agfstout(cg,v); e; e = agnxtout(cg,e))
 		{
-			to = find_id(AGID(aghead(e)),vertices,vsize);
+			err = attr_columns_read(&eattrs,e,esize/2);
+			if(err) goto error;
+
+			to = VREC_ID(aghead(e));
 			VECTOR(edges)[esize++] = from;
 			VECTOR(edges)[esize++] = to;
 		}
@@ -237,56 +425,41 @@ int ggen_read_graph(igraph_t *g,FILE *input)
 	while(att != NULL)
 	{
 		/* copy this attribute to igraph */
-		SETGAS(g,att->name,agxget(cg,att));
+		if(ggen_attr_wanted(GGEN_OBJECT_GRAPH,att->name,strlen(att->name)))
+			ggen_set_graph_attr(g,att->name,agxget(cg,att));
 		att = agnxtattr(cg,AGRAPH,att);
 	}
 	/* we keep the graph name using a special attribute */
-	SETGAS(g,GGEN_GRAPH_NAME_ATTR,agnameof(cg));
+	if(ggen_attr_wanted(GGEN_OBJECT_GRAPH,GGEN_GRAPH_NAME_ATTR,strlen(GGEN_GRAPH_NAME_ATTR)))
+		SETGAS(g,GGEN_GRAPH_NAME_ATTR,agnameof(cg));
 
-	/* read vertex properties */
-	att = agnxtattr(cg,AGNODE,NULL);
-	while(att != NULL)
+	/* give vertex and edge properties to igraph */
+	for(i = 0; i < vattrs.count; i++)
 	{
-		/* iterate over all vertices for this attribute */
-		for(v = agfstnode(cg); v; v = agnxtnode(cg,v))
-		{
-			from = find_id(AGID(v),vertices,vsize);
-			SETVAS(g,att->name,from,agxget(v,att));
-		}
-		att = agnxtattr(cg,AGNODE,att);
+		err = ggen_set_attr_column(g,vattrs.syms[i]->name,&vattrs.values[i],1);
+		if(err) goto error;
 	}
-	/* we keep each vertex name in a special attribute */
-	for(v = agfstnode(cg); v; v = agnxtnode(cg,v))
+	if(names)
 	{
-			from = find_id(AGID(v),vertices,vsize);
-			SETVAS(g,GGEN_VERTEX_NAME_ATTR,from,agnameof(v));
+		err = SETVASV(g,GGEN_VERTEX_NAME_ATTR,&vnames);
+		if(err) goto error;
 	}
 
-
-	/* read edges properties */
-	att = agnxtattr(cg,AGEDGE,NULL);
-	while(att != NULL)
+	for(i = 0; i < eattrs.count; i++)
 	{
-		/* the only way to iterate over all edges is to iterate
-		 * over the vertices */
-		for(v = agfstnode(cg); v; v = agnxtnode(cg,v))
-		{
-			from = find_id(AGID(v),vertices,vsize);
-			for(e = agfstout(cg,v); e; e = agnxtout(cg,e))
-			{
-				to = find_id(AGID(aghead(e)),vertices,vsize);
-				igraph_get_eid(g,&eid,from,to,1);
-				SETEAS(g,att->name,eid,agxget(e,att));
-			}
-		}
-		att = agnxtattr(cg,AGEDGE,att);
+		err = ggen_set_attr_column(g,eattrs.syms[i]->name,&eattrs.values[i],0);
+		if(err) goto error;
 	}
 
 	goto cleanup;
 error:
 	igraph_destroy(g);
 cleanup:
-	igraph_vector_destroy(&vertices);
+	attr_columns_destroy(&eattrs);
+error_dva:
+	attr_columns_destroy(&vattrs);
+error_dvn:
+	igraph_strvector_destroy(&vnames);
 error_de:
 	igraph_vector_destroy(&edges);
 error_d:
@@ -294,7 +467,7 @@ error_d:
 	return err;
 }
 
-int ggen_write_graph(igraph_t *g, FILE *output)
+int ggen_write_graph_cgraph(igraph_t *g, FILE *output)
 {
 	Agraph_t *cg;
 	Agnode_t *f,*t;
@@ -386,8 +559,7 @@ int ggen_write_graph(igraph_t *g, FILE *output)
 		if(strcmp(GGEN_GRAPH_NAME_ATTR,STR(gnames,i)))
 		{
 			if(VECTOR(gtypes)[i]==IGRAPH_ATTRIBUTE_NUMERIC) {
-				snprintf(name,GGEN_DEFAULT_NAME_SIZE,"%f",
-						(double)GAN(g,STR(gnames,i)));
+				d2s((double)GAN(g,STR(gnames,i)),name,GGEN_DEFAULT_NAME_SIZE);
 				agattr(cg,AGRAPH,(char *)STR(gnames,i),name);
 			}
 			else
@@ -407,8 +579,7 @@ int ggen_write_graph(igraph_t *g, FILE *output)
 			{
 				f = (Agnode_t *) VECTOR(vertices)[j];
 				if(VECTOR(vtypes)[i]==IGRAPH_ATTRIBUTE_NUMERIC) {
-					snprintf(name,GGEN_DEFAULT_NAME_SIZE,"%f",
-							(double)VAN(g,STR(vnames,i),j));
+					d2s((double)VAN(g,STR(vnames,i),j),name,GGEN_DEFAULT_NAME_SIZE);
 					agxset(f,attr,name);
 				}
 				else
@@ -429,8 +600,7 @@ int ggen_write_graph(igraph_t *g, FILE *output)
 			t = (Agnode_t *) VECTOR(vertices)[(unsigned long)to];
 			edge = agedge(cg,f,t,NULL,0);
 			if(VECTOR(etypes)[i]==IGRAPH_ATTRIBUTE_NUMERIC) {
-				snprintf(name,GGEN_DEFAULT_NAME_SIZE,"%f",
-						(double)EAN(g,STR(enames,i),j));
+				d2s((double)EAN(g,STR(enames,i),j),name,GGEN_DEFAULT_NAME_SIZE);
 				agxset(edge,attr,name);
 			}
 			else
@@ -36,6 +36,8 @@
 #ifndef UTILS_H
 #define UTILS_H
 
+#include <stdint.h>
+
 #include "ggen.h"
 
 /* gsl rng stuff */
@@ -47,15 +49,176 @@ int ggen_rng_load(gsl_rng **r,const char *file);
 int s2ul(char *s,unsigned long *l);
 int s2d(char *s,double *d);
 
+/* prints d with as few digits as possible, so that it reads back as d */
+void d2s(double d,char *s,size_t size);
+
+/* does s (of len bytes) hold a decimal number that is stored exactly as a
+ * double and written back by d2s as the same string */
+int ggen_is_number(const char *s,size_t len);
+
 /* graph io */
 #define GGEN_GRAPH_NAME_ATTR "__ggen_graph_name"
 #define GGEN_DEFAULT_GRAPH_NAME "dag"
 #define GGEN_VERTEX_NAME_ATTR "__ggen_vname"
 #define GGEN_DEFAULT_NAME_SIZE 80
-int ggen_read_graph(igraph_t *g,FILE *input);
 
+/* graph formats: the input format is guessed from the first bytes unless
+ * asked for, output is DOT unless asked for (see graph-io.c) */
+enum ggen_format { GGEN_FORMAT_AUTO, GGEN_FORMAT_DOT, GGEN_FORMAT_BINARY,
+	GGEN_FORMAT_EDGELIST };
+extern enum ggen_format ggen_input_format;
+extern enum ggen_format ggen_output_format;
+
+int ggen_read_graph(igraph_t *g,FILE *input);
 int ggen_write_graph(igraph_t *g,FILE *output);
 
+/* attributes given to igraph when reading a graph: the vertex and graph
+ * names, the property ggen_read_name of ggen_read_kind objects and the
+ * others. Readers skip the attributes not asked for */
+enum ggen_object { GGEN_OBJECT_GRAPH, GGEN_OBJECT_VERTEX, GGEN_OBJECT_EDGE };
+
+#define GGEN_ATTRS_NAMES	1
+#define GGEN_ATTRS_PROPERTY	2
+#define GGEN_ATTRS_OTHERS	4
+#define GGEN_ATTRS_ALL		7
+extern unsigned int ggen_read_attrs;
+extern enum ggen_object ggen_read_kind;
+extern const char *ggen_read_name;
+
+/* other properties read whatever the mask, e.g. the costs of a
+ * scheduling analysis, NULL names are ignored */
+void ggen_read_property(enum ggen_object kind,const char *name);
+
+/* threads a reader or a compressed output can use, 1 by default: the tool
+ * sets it from --threads, or to 1 where work is already split */
+extern unsigned long ggen_io_threads;
+
+int ggen_attr_wanted(enum ggen_object kind,const char *name,size_t len);
+
+/* sink writing a generated graph in the output format */
+struct ggen_edge_sink *ggen_output_sink(FILE *output);
+
+/* the whole input, mapped in memory when possible */
+struct ggen_input {
+	char *data;
+	size_t len;
+	int mapped;
+};
+
+int ggen_input_load(struct ggen_input *in,FILE *f);
+void ggen_input_free(struct ggen_input *in);
+
+/* an input holding several graphs: concatenated DOT graphs or binary
+ * records, or a binary container. Graphs are handed out in order as
+ * ranges of the input, ggen_corpus_next() returns 1 for a graph and 0
+ * at the end. The input is loaded as a whole first: a pipe or a
+ * compressed input takes as much memory as the uncompressed corpus */
+struct ggen_corpus {
+	struct ggen_input in;
+	enum ggen_format format;
+	size_t pos;
+	uint64_t count;
+	uint64_t next;
+	int container;
+};
+
+int ggen_corpus_open(struct ggen_corpus *c,FILE *f);
+int ggen_corpus_next(struct ggen_corpus *c,char **data,size_t *len);
+void ggen_corpus_close(struct ggen_corpus *c);
+int ggen_read_graph_data(igraph_t *g,enum ggen_format format,char *data,size_t len);
+
+/* DOT graphs are read by the native reader (see dot-io.c), which hands
+ * anything it does not support to the cgraph one. They are written by
+ * the native writer unless ggen_dot_writer asks for the cgraph one */
+enum ggen_writer { GGEN_WRITER_NATIVE, GGEN_WRITER_CGRAPH };
+extern enum ggen_writer ggen_dot_writer;
+
+int ggen_read_graph_dot(igraph_t *g,char *data,size_t len);
+size_t ggen_dot_graph_end(const char *data,size_t len);
+int ggen_read_graph_cgraph(igraph_t *g,FILE *input);
+int ggen_write_graph_dot(igraph_t *g,FILE *output);
+int ggen_write_graph_native(igraph_t *g,FILE *output);
+int ggen_write_graph_cgraph(igraph_t *g,FILE *output);
+
+/* attributes read from DOT: values that are all numbers are stored as
+ * numeric attributes, the others as strings */
+int ggen_set_graph_attr(igraph_t *g,const char *name,const char *value);
+int ggen_set_attr_column(igraph_t *g,const char *name,igraph_strvector_t *values,int vertex);
+
+/* binary graphs (see binary-io.c) */
+int ggen_is_binary(const char *data,size_t len);
+int ggen_read_graph_binary(igraph_t *g,const char *data,size_t len);
+int ggen_write_graph_binary(igraph_t *g,FILE *output);
+size_t ggen_binary_record_size(const char *data,size_t len);
+
+/* binary corpora: reading the index of a container, and writing one */
+int ggen_is_container(const char *data,size_t len);
+int ggen_container_index(const char *data,size_t len,uint64_t *count);
+int ggen_container_graph(const char *data,size_t len,uint64_t i,uint64_t *offset,uint64_t *size);
+
+struct ggen_container {
+	FILE *f;
+	uint64_t pos;
+	uint64_t *index;
+	uint64_t count;
+	uint64_t size;
+};
+
+int ggen_container_open(struct ggen_container *c,FILE *output);
+int ggen_container_add(struct ggen_container *c,const char *data,size_t len);
+int ggen_container_close(struct ggen_container *c);
+
+/* text edge lists (see edgelist-io.c), never guessed */
+int ggen_read_graph_edgelist(igraph_t *g,const char *data,size_t len);
+int ggen_write_graph_edgelist(igraph_t *g,FILE *output);
+
+/* streaming conversion (see builtin-convert.c): a reader hands a graph
+ * to a writer piece by piece, without building it. Fields are not NUL
+ * terminated and only live during the call, attributes are given as
+ * name/value pairs. Vertices without a name (name == NULL) are known by
+ * their id. Vertices declared on their own (with attributes or
+ * isolated) are given to vertex(), the others may only appear in edges.
+ */
+struct ggen_field {
+	const char *s;
+	size_t len;
+};
+
+struct ggen_stream {
+	/* name of the graph (NULL if it has none), before anything else */
+	int (*graph)(struct ggen_stream *s,const struct ggen_field *name);
+	/* graph attributes, or vertex and edge default values */
+	int (*attr)(struct ggen_stream *s,enum ggen_object kind,
+			const struct ggen_field *name,const struct ggen_field *value);
+	int (*vertex)(struct ggen_stream *s,unsigned long id,const struct ggen_field *name,
+			unsigned long nattrs,const struct ggen_field *attrs);
+	int (*edge)(struct ggen_stream *s,unsigned long from,const struct ggen_field *fname,
+			unsigned long to,const struct ggen_field *tname,
+			unsigned long nattrs,const struct ggen_field *attrs);
+
+	/* writers go through the input once per pass and write on the last
+	 * one, close() finishes the output and frees the writer */
+	unsigned int passes;
+	void (*pass)(struct ggen_stream *s,unsigned int i);
+	int (*close)(struct ggen_stream *s);
+};
+
+/* readers return GGEN_STREAM_UNSUPPORTED for inputs they cannot stream,
+ * which must be read as a whole */
+#define GGEN_STREAM_UNSUPPORTED (-1)
+int ggen_stream_dot(const char *data,size_t len,struct ggen_stream *s);
+int ggen_stream_edgelist(const char *data,size_t len,struct ggen_stream *s);
+int ggen_stream_binary(const char *data,size_t len,struct ggen_stream *s);
+struct ggen_stream *ggen_stream_dot_writer(FILE *output);
+struct ggen_stream *ggen_stream_edgelist_writer(FILE *output);
+struct ggen_stream *ggen_stream_binary_writer(FILE *output);
+
+/* compressed streams (see compress.c): inputs are recognized by their
+ * first bytes, outputs by the extension of their name (.gz or .zst).
+ * The stream returned owns f */
+FILE *ggen_open_input(FILE *f);
+FILE *ggen_fopen_output(const char *path);
+
 /* get vertex name:
  * if name exists in graph, will return a pointer to it.
  * if not, will print at most GGEN_DEFAULT_NAME_SIZE into buf
@@ -0,0 +1,298 @@
+/* Copyright Swann Perarnau 2009
+ *
+ *   contributor(s) :
+ *
+ *   contact : Swann.Perarnau@imag.fr
+ *
+ * This software is a computer program whose purpose is to help the
+ * random generation of graph structures and adding various properties
+ * on those structures.
+ *
+ * This software is governed by the CeCILL  license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+
+/* This program checks the binary graph format: a graph and a container
+ * must read back the same, truncated or corrupted records and containers
+ * must be refused.
+ */
+
+#include "ggen.h"
+#include "utils.h"
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static void put_le(char *p, uint64_t v, unsigned int width)
+{
+	unsigned int i;
+
+	for(i = 0; i < width; i++, v >>= 8)
+		p[i] = v & 0xff;
+}
+
+static uint64_t get_le(const char *p, unsigned int width)
+{
+	uint64_t v = 0;
+	unsigned int i;
+
+	for(i = width; i > 0; i--)
+		v = (v << 8) | (unsigned char)p[i-1];
+	return v;
+}
+
+static long find_attr(igraph_strvector_t *names, const char *name)
+{
+	long i;
+
+	for(i = 0; i < igraph_strvector_size(names); i++)
+		if(!strcmp(STR(*names,i),name))
+			return i;
+	return -1;
+}
+
+/* same structure, attributes and values */
+static void same_graph(igraph_t *a, igraph_t *b)
+{
+	igraph_strvector_t an[3],bn[3];
+	igraph_vector_t at[3],bt[3];
+	igraph_integer_t af,ato,bf,bto;
+	const char *name;
+	long i,j,k,count;
+	double x,y;
+
+	assert(igraph_vcount(a) == igraph_vcount(b));
+	assert(igraph_ecount(a) == igraph_ecount(b));
+	for(i = 0; i < igraph_ecount(a); i++)
+	{
+		igraph_edge(a,i,&af,&ato);
+		igraph_edge(b,i,&bf,&bto);
+		assert(af == bf && ato == bto);
+	}
+
+	for(i = 0; i < 3; i++)
+	{
+		igraph_strvector_init(&an[i],0);
+		igraph_strvector_init(&bn[i],0);
+		igraph_vector_init(&at[i],0);
+		igraph_vector_init(&bt[i],0);
+	}
+	assert(igraph_cattribute_list(a,&an[0],&at[0],&an[1],&at[1],&an[2],&at[2]) == 0);
+	assert(igraph_cattribute_list(b,&bn[0],&bt[0],&bn[1],&bt[1],&bn[2],&bt[2]) == 0);
+	for(i = 0; i < 3; i++)
+	{
+		assert(igraph_strvector_size(&an[i]) == igraph_strvector_size(&bn[i]));
+		count = i == 0 ? 1 : i == 1 ? igraph_vcount(a) : igraph_ecount(a);
+		for(j = 0; j < igraph_strvector_size(&an[i]); j++)
+		{
+			name = STR(an[i],j);
+			assert(find_attr(&bn[i],name) >= 0);
+			assert(VECTOR(at[i])[j] == VECTOR(bt[i])[find_attr(&bn[i],name)]);
+			for(k = 0; k < count; k++)
+			{
+				if(VECTOR(at[i])[j] == IGRAPH_ATTRIBUTE_NUMERIC)
+				{
+					x = i == 0 ? GAN(a,name) : i == 1 ? VAN(a,name,k) : EAN(a,name,k);
+					y = i == 0 ? GAN(b,name) : i == 1 ? VAN(b,name,k) : EAN(b,name,k);
+					assert(x == y || (isnan(x) && isnan(y)));
+				}
+				else if(i == 0)
+					assert(!strcmp(GAS(a,name),GAS(b,name)));
+				else if(i == 1)
+					assert(!strcmp(VAS(a,name,k),VAS(b,name,k)));
+				else
+					assert(!strcmp(EAS(a,name,k),EAS(b,name,k)));
+			}
+		}
+		igraph_strvector_destroy(&an[i]);
+		igraph_strvector_destroy(&bn[i]);
+		igraph_vector_destroy(&at[i]);
+		igraph_vector_destroy(&bt[i]);
+	}
+}
+
+/* data must be refused as a graph */
+static void refused(const char *data, size_t len)
+{
+	igraph_t g;
+
+	assert(ggen_read_graph_binary(&g,data,len) != 0);
+}
+
+int main(int argc,char** argv)
+{
+	static const char *names[] = { "a", "b", "c", "d" };
+	static const char *labels[] = { "x", "", "x", "y z", "\"q\"" };
+	static const double w[] = { 1, 2.5, NAN, -4 };
+	struct ggen_container c;
+	igraph_t g,back;
+	FILE *f;
+	char *data,*copy,*corpus;
+	size_t len,clen,size,i;
+	uint64_t count,off,rsize,pos,nstrings;
+
+	igraph_i_set_attribute_table(&igraph_cattribute_table);
+
+	// graph is
+	//		0--->1--->3--->0
+	//		---->2----^
+	// edges are grouped by tail, like the binary format stores them
+	igraph_small(&g,4,1,0,1,0,2,1,3,2,3,3,0,-1);
+	assert(SETGAS(&g,GGEN_GRAPH_NAME_ATTR,"g") == 0);
+	assert(SETGAN(&g,"size",3) == 0);
+	for(i = 0; i < 4; i++)
+	{
+		assert(SETVAS(&g,GGEN_VERTEX_NAME_ATTR,i,names[i]) == 0);
+		assert(SETVAN(&g,"w",i,w[i]) == 0);
+	}
+	for(i = 0; i < 5; i++)
+	{
+		assert(SETEAS(&g,"label",i,labels[i]) == 0);
+		assert(SETEAN(&g,"cost",i,i + 0.5) == 0);
+	}
+
+	/* round trip */
+	f = open_memstream(&data,&len);
+	assert(f != NULL);
+	assert(ggen_write_graph_binary(&g,f) == 0);
+	fclose(f);
+	assert(ggen_is_binary(data,len));
+	assert(ggen_binary_record_size(data,len) == len);
+	assert(len % 8 == 0 && get_le(data + 16,8) == len);
+	assert(ggen_read_graph_binary(&back,data,len) == 0);
+	same_graph(&g,&back);
+	igraph_destroy(&back);
+
+	/* truncated records, whether the header says so or not */
+	copy = malloc(len);
+	assert(copy != NULL);
+	for(size = 0; size < len; size++)
+		refused(data,size);
+	for(size = 64; size + 8 <= len; size++)
+	{
+		memcpy(copy,data,len);
+		put_le(copy + 16,size,8);
+		refused(copy,size);
+	}
+
+	/* corrupted header: magic, version, width, vertex count */
+	memcpy(copy,data,len);
+	copy[0] = 'X';
+	refused(copy,len);
+	memcpy(copy,data,len);
+	put_le(copy + 8,2,4);
+	refused(copy,len);
+	memcpy(copy,data,len);
+	put_le(copy + 12,3,4);
+	refused(copy,len);
+	memcpy(copy,data,len);
+	put_le(copy + 24,5,8);
+	refused(copy,len);
+	/* offsets start at 64, heads after the 5 offsets and their padding:
+	 * first offset not 0, decreasing offsets, head out of range */
+	memcpy(copy,data,len);
+	put_le(copy + 64,1,4);
+	refused(copy,len);
+	memcpy(copy,data,len);
+	put_le(copy + 72,1,4);
+	refused(copy,len);
+	memcpy(copy,data,len);
+	put_le(copy + 88,4,4);
+	refused(copy,len);
+
+	/* corrupted string column: type, index, table size and missing NUL */
+	for(pos = 0; pos + 6 <= len && memcmp(data + pos,"label",6); pos++);
+	assert(pos + 6 <= len);
+	memcpy(copy,data,len);
+	put_le(copy + pos - 8,3,4);
+	refused(copy,len);
+	pos = (pos + 6 + 7) & ~(uint64_t)7;
+	nstrings = get_le(data + pos,8);
+	assert(nstrings == 4);
+	memcpy(copy,data,len);
+	put_le(copy + pos + 16,nstrings,4);
+	refused(copy,len);
+	memcpy(copy,data,len);
+	put_le(copy + pos + 8,len,8);
+	refused(copy,len);
+	memcpy(copy,data,len);
+	off = pos + 16 + 24 + 8*(nstrings + 1) + get_le(data + pos + 8,8) - 1;
+	assert(copy[off] == '\0');
+	copy[off] = 'x';
+	refused(copy,len);
+	free(copy);
+
+	/* a container of two graphs */
+	f = open_memstream(&corpus,&clen);
+	assert(f != NULL);
+	assert(ggen_container_open(&c,f) == 0);
+	assert(ggen_container_add(&c,data,len) == 0);
+	assert(ggen_container_add(&c,data,len) == 0);
+	assert(ggen_container_close(&c) == 0);
+	fclose(f);
+	assert(ggen_is_container(corpus,clen));
+	assert(ggen_container_index(corpus,clen,&count) == 0 && count == 2);
+	assert(ggen_container_graph(corpus,clen,1,&off,&rsize) == 0);
+	assert(rsize == len && off + rsize <= clen);
+	assert(ggen_read_graph_binary(&back,corpus + off,rsize) == 0);
+	same_graph(&g,&back);
+	igraph_destroy(&back);
+	assert(ggen_container_graph(corpus,clen,2,&off,&rsize) != 0);
+	/* the first graph of a container is read as a graph */
+	assert(ggen_read_graph_binary(&back,corpus,clen) == 0);
+	same_graph(&g,&back);
+	igraph_destroy(&back);
+
+	/* truncated and corrupted containers */
+	copy = malloc(clen);
+	assert(copy != NULL);
+	for(size = 0; size < clen; size++)
+		assert(ggen_container_index(corpus,size,&count) != 0);
+	memcpy(copy,corpus,clen);
+	put_le(copy + 8,2,4);
+	assert(ggen_container_index(copy,clen,&count) != 0);
+	memcpy(copy,corpus,clen);
+	put_le(copy + clen - 24,3,8);
+	assert(ggen_container_index(copy,clen,&count) != 0);
+	memcpy(copy,corpus,clen);
+	put_le(copy + clen - 16,clen,8);
+	assert(ggen_container_index(copy,clen,&count) != 0);
+	memcpy(copy,corpus,clen);
+	copy[clen - 1] = 'X';
+	assert(ggen_container_index(copy,clen,&count) != 0);
+	/* a record going past the index */
+	memcpy(copy,corpus,clen);
+	pos = get_le(corpus + clen - 16,8);
+	put_le(copy + pos + 16 + 8,pos,8);
+	assert(ggen_container_index(copy,clen,&count) != 0);
+	free(copy);
+
+	free(corpus);
+	free(data);
+	igraph_destroy(&g);
+	return 0;
+}
@@ -0,0 +1,42 @@
+#!/bin/sh
+set -e
+set -u
+dir=`mktemp -d`
+# the same seed gives the same graphs, whatever the number of threads
+GSL_RNG_SEED=42
+export GSL_RNG_SEED
+for t in 1 4; do
+	../src/ggen -l 0 -t $t -c 6 -p $dir/t$t-%d.dot generate-graph gnp 20 0.3
+	../src/ggen -l 0 -t $t -c 6 generate-graph gnp 20 0.3 > $dir/all$t.dot
+done
+for i in 0 1 2 3 4 5; do
+	cmp $dir/t1-$i.dot $dir/t4-$i.dot
+done
+cmp $dir/all1.dot $dir/all4.dot
+cat $dir/t1-0.dot $dir/t1-1.dot $dir/t1-2.dot $dir/t1-3.dot $dir/t1-4.dot \
+	$dir/t1-5.dot | cmp $dir/all1.dot -
+# graphs of a batch differ from each other
+if cmp -s $dir/t1-0.dot $dir/t1-1.dot; then
+	exit 1
+fi
+# compressed files hold the same graphs
+if command -v gzip > /dev/null; then
+	../src/ggen -l 0 -t 4 -c 6 -p $dir/z-%02d.dot.gz generate-graph gnp 20 0.3
+	for i in 0 1 2 3 4 5; do
+		gzip -dc $dir/z-0$i.dot.gz | cmp $dir/t1-$i.dot -
+	done
+fi
+# a pattern needs a single integer conversion, and a count
+for p in 'bad.dot' 'bad-%s.dot' 'bad-%d-%d.dot' 'bad-%ld.dot' 'bad-%n.dot'; do
+	if ../src/ggen -l 0 -c 2 -p "$dir/$p" generate-graph gnp 20 0.3; then
+		exit 1
+	fi
+done
+if ../src/ggen -l 0 -p $dir/bad-%d.dot generate-graph gnp 20 0.3; then
+	exit 1
+fi
+if ls $dir/bad* > /dev/null 2>&1; then
+	exit 1
+fi
+# cleanup
+rm -r $dir
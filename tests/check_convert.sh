@@ -0,0 +1,54 @@
+#!/bin/sh
+set -e
+set -u
+file=`mktemp`
+a=`mktemp`
+b=`mktemp`
+out=`mktemp`
+log=`mktemp`
+cat > $file << 'END'
+digraph g {
+	label="test";
+	a [cost=1.5, label="x y"];
+	b [cost=2];
+	c [cost=3];
+	a -> b [w=1];
+	b -> c [w=2];
+	a -> c [w="1.50"];
+}
+END
+# DOT to binary and back: the graph read again gives the same DOT
+../src/ggen -l 0 convert binary -i $file > $a
+../src/ggen -l 0 convert dot -i $a > $out
+../src/ggen -l 0 convert binary -i $out > $b
+../src/ggen -l 0 convert dot -i $b | cmp $out -
+grep -q 'label=test' $out
+grep -q 'a	\[cost=1.5, label="x y"\]' $out
+grep -qF 'a -> c	[w=1.50]' $out
+grep -qF 'b -> c	[w=2]' $out
+# DOT to edge list and back: edges, names and edge attributes are kept
+../src/ggen -l 0 convert edgelist -i $file > $a
+../src/ggen -l 0 --input-format edgelist convert dot -i $a > $out
+../src/ggen -l 0 convert edgelist -i $out > $b
+cmp $a $b
+grep -qF 'a -> b	[w=1]' $out
+grep -qF 'a -> c	[w=1.50]' $out
+# an edge default given after an edge cannot be streamed: the graph is
+# read as a whole, and converted the same
+cat > $file << 'END'
+digraph g {
+	a -> b [w=1];
+	edge [w=5];
+	b -> c;
+}
+END
+../src/ggen -l 4 convert dot -i $file 2> $log > $out
+grep -q 'cannot be streamed' $log
+grep -qF 'a -> b	[w=1]' $out
+grep -qF 'b -> c	[w=5]' $out
+../src/ggen -l 4 convert binary -i $file 2> $log > $a
+grep -q 'cannot be streamed' $log
+../src/ggen -l 0 convert dot -i $a > $out
+grep -qF 'b -> c	[w=5]' $out
+# cleanup
+rm $file $a $b $out $log
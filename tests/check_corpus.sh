@@ -0,0 +1,41 @@
+#!/bin/sh
+set -e
+set -u
+file=`mktemp`
+out=`mktemp`
+expected=`mktemp`
+# graphs of 2 to 9 vertices one after the other, so that the order of
+# the results tells which graph each of them comes from
+: > $file
+: > $expected
+for n in 2 3 4 5 6 7 8 9; do
+	echo "digraph g$n {" >> $file
+	i=1
+	while [ $i -lt $n ]; do
+		echo "	$((i - 1)) -> $i;" >> $file
+		i=$((i + 1))
+	done
+	echo "}" >> $file
+	echo "Number of vertices: $n" >> $expected
+done
+# several workers, from a file and from a pipe
+../src/ggen -l 0 -t 3 analyse-graph nb-vertices -i $file > $out
+cmp $out $expected
+cat $file | ../src/ggen -l 0 -t 3 analyse-graph nb-vertices > $out
+cmp $out $expected
+../src/ggen -l 0 -t 1 analyse-graph nb-vertices -i $file > $out
+cmp $out $expected
+if command -v gzip > /dev/null; then
+	gzip -c $file | ../src/ggen -l 0 -t 3 analyse-graph nb-vertices > $out
+	cmp $out $expected
+fi
+# transformed graphs are written in order too
+../src/ggen -l 0 -t 3 transform-graph add-sink -i $file |
+	../src/ggen -l 0 -t 2 analyse-graph nb-edges > $out
+n=2
+while [ $n -le 9 ]; do
+	echo "Number of edges: $n"
+	n=$((n + 1))
+done | cmp $out -
+# cleanup
+rm $file $out $expected
@@ -0,0 +1,39 @@
+#!/bin/sh
+set -e
+set -u
+file=`mktemp`
+out=`mktemp`
+# a triple edge gives a degree larger than the number of vertices,
+# the self loop counts in no degree, like with in-degree and out-degree
+cat > $file << 'END'
+digraph g {
+	0 -> 1;
+	0 -> 1;
+	0 -> 1;
+	1 -> 1;
+}
+END
+../src/ggen -l 0 analyse-graph summary -i $file > $out
+grep -qx 'sources: 1' $out
+grep -qx 'sinks: 1' $out
+grep -qx 'in-degree: 0:1,3:1' $out
+grep -qx 'out-degree: 0:1,3:1' $out
+../src/ggen -l 0 analyse-graph in-degree -i $file > $out
+grep -qx '1,3' $out
+../src/ggen -l 0 analyse-graph out-degree -i $file > $out
+grep -qx '1,0' $out
+# the same without the loop is a dag
+cat > $file << 'END'
+digraph g {
+	0 -> 1;
+	0 -> 1;
+	0 -> 1;
+	1 -> 2;
+}
+END
+../src/ggen -l 0 analyse-graph summary -i $file > $out
+grep -qx 'in-degree: 0:1,1:1,3:1' $out
+grep -qx 'out-degree: 0:1,1:1,3:1' $out
+grep -qx 'level-widths: 1,1,1' $out
+# cleanup
+rm $file $out
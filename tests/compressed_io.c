@@ -0,0 +1,252 @@
+/* Copyright Swann Perarnau 2009
+ *
+ *   contributor(s) :
+ *
+ *   contact : Swann.Perarnau@imag.fr
+ *
+ * This software is a computer program whose purpose is to help the
+ * random generation of graph structures and adding various properties
+ * on those structures.
+ *
+ * This software is governed by the CeCILL  license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+
+/* This program checks the compressed streams: an output of several blocks,
+ * compressed by several threads into as many gzip members or zstd frames,
+ * must read back the same from a file or a pipe, while truncated or
+ * corrupted inputs must fail.
+ */
+
+#include "config.h"
+#include "utils.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/* more than three blocks of uncompressed data */
+#define SIZE ((13 << 20) + 12345)
+
+/* an edge list, compressible but not too much */
+static char *make_data(size_t size)
+{
+	char *data;
+	size_t len = 0;
+	unsigned long x = 12345;
+
+	data = malloc(size + 32);
+	assert(data != NULL);
+	while(len < size)
+	{
+		x = x*6364136223846793005UL + 1442695040888963407UL;
+		len += sprintf(data + len,"%lu %lu\n",(x >> 33) % 100000,(x >> 17) % 100000);
+	}
+	return data;
+}
+
+static void write_raw(const char *path, const char *data, size_t len)
+{
+	FILE *f = fopen(path,"w");
+	assert(f != NULL);
+	assert(fwrite(data,1,len,f) == len);
+	assert(fclose(f) == 0);
+}
+
+static char *read_raw(const char *path, size_t *len)
+{
+	FILE *f = fopen(path,"r");
+	char *data;
+	long size;
+
+	assert(f != NULL);
+	assert(fseek(f,0,SEEK_END) == 0);
+	size = ftell(f);
+	rewind(f);
+	data = malloc(size + 64);
+	assert(data != NULL);
+	assert(fread(data,1,size,f) == (size_t)size);
+	fclose(f);
+	*len = size;
+	return data;
+}
+
+/* a pipe fed by a child */
+static FILE *pipe_from(const char *data, size_t len, pid_t *pid)
+{
+	int p[2];
+	FILE *f;
+
+	assert(pipe(p) == 0);
+	*pid = fork();
+	assert(*pid >= 0);
+	if(*pid == 0)
+	{
+		close(p[0]);
+		f = fdopen(p[1],"w");
+		fwrite(data,1,len,f);
+		fclose(f);
+		_exit(0);
+	}
+	close(p[1]);
+	f = fdopen(p[0],"r");
+	assert(f != NULL);
+	return f;
+}
+
+/* read through a decompressing stream, 0 if it failed */
+static int read_stream(FILE *raw, char **out, size_t *len)
+{
+	FILE *f;
+	size_t size = 1 << 20,n;
+	int err;
+
+	f = ggen_open_input(raw);
+	assert(f != NULL);
+	*out = malloc(size);
+	*len = 0;
+	assert(*out != NULL);
+	while((n = fread(*out + *len,1,size - *len,f)) > 0)
+	{
+		*len += n;
+		if(*len == size)
+		{
+			size *= 2;
+			*out = realloc(*out,size);
+			assert(*out != NULL);
+		}
+	}
+	err = ferror(f);
+	fclose(f);
+	return !err;
+}
+
+static int read_file(const char *path, char **out, size_t *len)
+{
+	FILE *f = fopen(path,"r");
+	assert(f != NULL);
+	return read_stream(f,out,len);
+}
+
+/* hdr is a byte of the header that has reserved bits */
+static void check_codec(const char *path, const char *data, size_t len,
+		size_t hdr, unsigned char reserved)
+{
+	FILE *f;
+	pid_t pid;
+	char *out,*raw;
+	size_t n,rawlen;
+
+	/* several blocks, compressed by several threads, written in order */
+	f = ggen_fopen_output(path);
+	assert(f != NULL);
+	assert(fwrite(data,1,len,f) == len);
+	assert(fclose(f) == 0);
+
+	/* each member or frame follows the previous one */
+	assert(read_file(path,&out,&n));
+	assert(n == len && !memcmp(out,data,len));
+	free(out);
+
+	/* only the first bytes of a pipe are looked at */
+	raw = read_raw(path,&rawlen);
+	f = pipe_from(raw,rawlen,&pid);
+	assert(read_stream(f,&out,&n));
+	assert(n == len && !memcmp(out,data,len));
+	free(out);
+	waitpid(pid,NULL,0);
+
+	/* truncated in the middle of a block, or at its very end */
+	write_raw(path,raw,rawlen/2);
+	assert(!read_file(path,&out,&n));
+	free(out);
+	write_raw(path,raw,rawlen - 1);
+	assert(!read_file(path,&out,&n));
+	free(out);
+
+	/* garbage where the next member or frame should start */
+	memcpy(raw + rawlen,"not compressed at all\n",22);
+	write_raw(path,raw,rawlen + 22);
+	assert(!read_file(path,&out,&n));
+	free(out);
+
+	/* a corrupted header */
+	raw[hdr] |= reserved;
+	write_raw(path,raw,rawlen);
+	assert(!read_file(path,&out,&n));
+	free(out);
+	free(raw);
+
+	/* even an empty output is a valid stream */
+	f = ggen_fopen_output(path);
+	assert(f != NULL);
+	assert(fclose(f) == 0);
+	raw = read_raw(path,&rawlen);
+	assert(rawlen > 0);
+	free(raw);
+	assert(read_file(path,&out,&n));
+	assert(n == 0);
+	free(out);
+
+	unlink(path);
+}
+
+int main(int argc,char** argv)
+{
+	FILE *f;
+	pid_t pid;
+	char *data,*out;
+	size_t n;
+
+	/* the blocks are compressed by several threads, even on a single
+	 * processor */
+	ggen_io_threads = 3;
+	data = make_data(SIZE);
+
+#ifdef HAVE_LIBZ
+	check_codec("compressed_io.gz",data,SIZE,3,0xe0);
+#endif
+#ifdef HAVE_LIBZSTD
+	check_codec("compressed_io.zst",data,SIZE,4,0x08);
+#endif
+
+	/* plain text goes through untouched */
+	write_raw("compressed_io.txt",data,SIZE);
+	assert(read_file("compressed_io.txt",&out,&n));
+	assert(n == SIZE && !memcmp(out,data,SIZE));
+	free(out);
+	unlink("compressed_io.txt");
+	f = pipe_from(data,SIZE,&pid);
+	assert(read_stream(f,&out,&n));
+	assert(n == SIZE && !memcmp(out,data,SIZE));
+	free(out);
+	waitpid(pid,NULL,0);
+
+	free(data);
+	return 0;
+}
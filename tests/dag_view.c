@@ -0,0 +1,107 @@
+/* Copyright Swann Perarnau 2009
+ *
+ *   contributor(s) :
+ *
+ *   contact : Swann.Perarnau@imag.fr
+ *
+ * This software is a computer program whose purpose is to help the
+ * random generation of graph structures and adding various properties
+ * on those structures.
+ *
+ * This software is governed by the CeCILL  license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+
+/* This program is an usage example of the dag views of ggen.
+ * It also works as a unit test.
+ */
+
+#include "ggen.h"
+#include <assert.h>
+
+int main(int argc,char** argv)
+{
+	struct ggen_dag d;
+	igraph_t g;
+	uint32_t i,v,pos[5];
+
+	// all ggen methods should fail on incorrect arguments
+	assert(ggen_dag_init(NULL,NULL) == 1);
+	assert(ggen_dag_init(&d,NULL) == 1);
+	assert(ggen_dag_longest_path(NULL) == NULL);
+
+	// an empty graph has no edge and every vertex on level 0
+	igraph_empty(&g,3,1);
+	assert(ggen_dag_init(&d,&g) == 0);
+	assert(d.n == 3 && d.m == 0 && d.is_dag);
+	for(v = 0; v < 3; v++)
+	{
+		assert(GGEN_DAG_OUTDEG(&d,v) == 0);
+		assert(GGEN_DAG_INDEG(&d,v) == 0);
+		assert(d.level[v] == 0);
+	}
+	ggen_dag_destroy(&d);
+	igraph_destroy(&g);
+
+	// graph is
+	//		----------v
+	//		4--->1--->2
+	//		3----^    0
+	igraph_small(&g,5,1,4,1,4,2,1,2,3,1,-1);
+	assert(ggen_dag_init(&d,&g) == 0);
+	assert(d.n == 5 && d.m == 4 && d.is_dag);
+	assert(GGEN_DAG_OUTDEG(&d,4) == 2 && GGEN_DAG_INDEG(&d,4) == 0);
+	assert(GGEN_DAG_OUTDEG(&d,1) == 1 && GGEN_DAG_INDEG(&d,1) == 2);
+	assert(GGEN_DAG_INDEG(&d,2) == 2 && GGEN_DAG_OUTDEG(&d,0) == 0);
+
+	// edges keep their igraph ids, in order
+	assert(d.out[d.out_off[4]] == 1 && d.out_eid[d.out_off[4]] == 0);
+	assert(d.out[d.out_off[4]+1] == 2 && d.out_eid[d.out_off[4]+1] == 1);
+	assert(d.in[d.in_off[1]] == 4 && d.in[d.in_off[1]+1] == 3);
+	assert(d.in_eid[d.in_off[1]+1] == 3);
+
+	// edges go forward in the order
+	for(i = 0; i < d.n; i++)
+		pos[d.order[i]] = i;
+	for(v = 0; v < d.n; v++)
+		for(i = d.out_off[v]; i < d.out_off[v+1]; i++)
+			assert(pos[v] < pos[d.out[i]]);
+	assert(d.level[4] == 0 && d.level[3] == 0 && d.level[0] == 0);
+	assert(d.level[1] == 1 && d.level[2] == 2);
+	ggen_dag_destroy(&d);
+	igraph_destroy(&g);
+
+	// a cycle is seen, the adjacency is still there
+	igraph_small(&g,3,1,0,1,1,2,2,0,-1);
+	assert(ggen_dag_init(&d,&g) == 0);
+	assert(!d.is_dag);
+	assert(GGEN_DAG_OUTDEG(&d,2) == 1 && d.out[d.out_off[2]] == 0);
+	assert(ggen_dag_longest_path(&d) == NULL);
+	ggen_dag_destroy(&d);
+	igraph_destroy(&g);
+
+	return 0;
+}
@@ -0,0 +1,326 @@
+/* Copyright Swann Perarnau 2009
+ *
+ *   contributor(s) :
+ *
+ *   contact : Swann.Perarnau@imag.fr
+ *
+ * This software is a computer program whose purpose is to help the
+ * random generation of graph structures and adding various properties
+ * on those structures.
+ *
+ * This software is governed by the CeCILL  license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+
+/* This program checks the native DOT reader and writer against cgraph:
+ * both readers must give the same edge order, attribute types and
+ * values, and the output of each writer must read back the same. Both
+ * readers must also skip the attributes a command does not use.
+ */
+
+#include "ggen.h"
+#include "utils.h"
+#include "log.h"
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *inputs[] = {
+	/* edges are grouped by tail, in order of appearance */
+	"digraph g {\n"
+	"\tc -> a;\n"
+	"\ta -> b;\n"
+	"\tb -> c;\n"
+	"\ta -> c;\n"
+	"}\n",
+	/* numeric and string columns, default values */
+	"digraph g {\n"
+	"\tgraph [color=red, size=3];\n"
+	"\tnode [w=\"\"];\n"
+	"\t0 [w=1, t=\"2.5e3\"];\n"
+	"\t1 [w=2, t=-1];\n"
+	"\t2 [w=x, t=0.5];\n"
+	"\t0 -> 2 [c=1];\n"
+	"\t2 -> 1 [c=\"01\"];\n"
+	"\t1 -> 2 [c=3];\n"
+	"}\n",
+	/* quoted identifiers and values, chains */
+	"digraph \"the graph\" {\n"
+	"\t\"a b\" [label=\"say \\\"hi\\\"\"];\n"
+	"\t\"c,d\" [label=\"x;y\"];\n"
+	"\t\"a b\" -> \"c,d\" -> e [weight=2];\n"
+	"\te -> \"a b\" [weight=\"1.5\", note=\"[x]\"];\n"
+	"}\n",
+	NULL
+};
+
+/* vertex and edge costs, a property and attributes nobody uses */
+static const char *filtered =
+	"digraph g {\n"
+	"\tgraph [color=red];\n"
+	"\ta [cost=1, color=blue, mark=x];\n"
+	"\tb [cost=2, color=blue, mark=y];\n"
+	"\ta -> b [w=3, label=e, mark=z];\n"
+	"}\n";
+
+static long find_attr(igraph_strvector_t *names, const char *name)
+{
+	long i;
+
+	for(i = 0; i < igraph_strvector_size(names); i++)
+		if(!strcmp(STR(*names,i),name))
+			return i;
+	return -1;
+}
+
+/* same attributes, same types and same values */
+static void same_attrs(igraph_t *a, igraph_t *b, int kind, igraph_strvector_t *an,
+		igraph_vector_t *at, igraph_strvector_t *bn, igraph_vector_t *bt)
+{
+	long i,j,k,count;
+	const char *name;
+	double x,y;
+
+	assert(igraph_strvector_size(an) == igraph_strvector_size(bn));
+	count = kind == 0 ? 1 : kind == 1 ? igraph_vcount(a) : igraph_ecount(a);
+	for(i = 0; i < igraph_strvector_size(an); i++)
+	{
+		name = STR(*an,i);
+		j = find_attr(bn,name);
+		assert(j >= 0);
+		assert(VECTOR(*at)[i] == VECTOR(*bt)[j]);
+		for(k = 0; k < count; k++)
+		{
+			if(VECTOR(*at)[i] == IGRAPH_ATTRIBUTE_NUMERIC)
+			{
+				x = kind == 0 ? GAN(a,name) : kind == 1 ? VAN(a,name,k) : EAN(a,name,k);
+				y = kind == 0 ? GAN(b,name) : kind == 1 ? VAN(b,name,k) : EAN(b,name,k);
+				assert(x == y || (isnan(x) && isnan(y)));
+			}
+			else if(kind == 0)
+				assert(!strcmp(GAS(a,name),GAS(b,name)));
+			else if(kind == 1)
+				assert(!strcmp(VAS(a,name,k),VAS(b,name,k)));
+			else
+				assert(!strcmp(EAS(a,name,k),EAS(b,name,k)));
+		}
+	}
+}
+
+static void same_graph(igraph_t *a, igraph_t *b)
+{
+	igraph_strvector_t an[3],bn[3];
+	igraph_vector_t at[3],bt[3];
+	igraph_integer_t af,ato,bf,bto;
+	long i;
+
+	assert(igraph_vcount(a) == igraph_vcount(b));
+	assert(igraph_ecount(a) == igraph_ecount(b));
+	for(i = 0; i < igraph_ecount(a); i++)
+	{
+		igraph_edge(a,i,&af,&ato);
+		igraph_edge(b,i,&bf,&bto);
+		assert(af == bf && ato == bto);
+	}
+
+	for(i = 0; i < 3; i++)
+	{
+		igraph_strvector_init(&an[i],0);
+		igraph_strvector_init(&bn[i],0);
+		igraph_vector_init(&at[i],0);
+		igraph_vector_init(&bt[i],0);
+	}
+	assert(igraph_cattribute_list(a,&an[0],&at[0],&an[1],&at[1],&an[2],&at[2]) == 0);
+	assert(igraph_cattribute_list(b,&bn[0],&bt[0],&bn[1],&bt[1],&bn[2],&bt[2]) == 0);
+	for(i = 0; i < 3; i++)
+	{
+		same_attrs(a,b,i,&an[i],&at[i],&bn[i],&bt[i]);
+		igraph_strvector_destroy(&an[i]);
+		igraph_strvector_destroy(&bn[i]);
+		igraph_vector_destroy(&at[i]);
+		igraph_vector_destroy(&bt[i]);
+	}
+}
+
+static void read_cgraph(igraph_t *g, char *data, size_t len)
+{
+	FILE *f;
+
+	f = fmemopen(data,len,"r");
+	assert(f != NULL);
+	assert(ggen_read_graph_cgraph(g,f) == 0);
+	fclose(f);
+}
+
+/* type of a graph (0), vertex (1) or edge (2) attribute, -1 if it was
+ * not read */
+static int attr_type(igraph_t *g, int kind, const char *name)
+{
+	igraph_strvector_t n[3];
+	igraph_vector_t t[3];
+	long i,j;
+	int type = -1;
+
+	for(i = 0; i < 3; i++)
+	{
+		igraph_strvector_init(&n[i],0);
+		igraph_vector_init(&t[i],0);
+	}
+	assert(igraph_cattribute_list(g,&n[0],&t[0],&n[1],&t[1],&n[2],&t[2]) == 0);
+	j = find_attr(&n[kind],name);
+	if(j >= 0)
+		type = VECTOR(t[kind])[j];
+	for(i = 0; i < 3; i++)
+	{
+		igraph_strvector_destroy(&n[i]);
+		igraph_vector_destroy(&t[i]);
+	}
+	return type;
+}
+
+/* names and the edge property mark only when asked for, costs always,
+ * nothing else, whatever the reader */
+static void check_filtered(int names, int property)
+{
+	igraph_t g[2];
+	char *data;
+	int i;
+
+	data = strdup(filtered);
+	assert(data != NULL);
+	assert(ggen_read_graph_dot(&g[0],data,strlen(data)) == 0);
+	free(data);
+	data = strdup(filtered);
+	assert(data != NULL);
+	read_cgraph(&g[1],data,strlen(data));
+	free(data);
+	same_graph(&g[0],&g[1]);
+
+	for(i = 0; i < 2; i++)
+	{
+		assert(attr_type(&g[i],0,GGEN_GRAPH_NAME_ATTR) ==
+				(names ? IGRAPH_ATTRIBUTE_STRING : -1));
+		assert(attr_type(&g[i],1,GGEN_VERTEX_NAME_ATTR) ==
+				(names ? IGRAPH_ATTRIBUTE_STRING : -1));
+		assert(attr_type(&g[i],2,"mark") == (property ? IGRAPH_ATTRIBUTE_STRING : -1));
+		if(property)
+			assert(!strcmp(EAS(&g[i],"mark",0),"z"));
+		assert(attr_type(&g[i],1,"cost") == IGRAPH_ATTRIBUTE_NUMERIC);
+		assert(VAN(&g[i],"cost",1) == 2);
+		assert(attr_type(&g[i],2,"w") == IGRAPH_ATTRIBUTE_NUMERIC);
+		assert(EAN(&g[i],"w",0) == 3);
+		assert(attr_type(&g[i],0,"color") == -1);
+		assert(attr_type(&g[i],1,"color") == -1);
+		assert(attr_type(&g[i],1,"mark") == -1);
+		assert(attr_type(&g[i],2,"label") == -1);
+		igraph_destroy(&g[i]);
+	}
+}
+
+static void write_graph(igraph_t *g, int (*writer)(igraph_t *,FILE *),
+		char **data, size_t *len)
+{
+	FILE *f;
+
+	f = open_memstream(data,len);
+	assert(f != NULL);
+	assert(writer(g,f) == 0);
+	fclose(f);
+}
+
+int main(int argc,char** argv)
+{
+	igraph_t native,cgraph,back;
+	char *data,*out,line[256];
+	size_t len,olen;
+	FILE *log;
+	int i;
+
+	igraph_i_set_attribute_table(&igraph_cattribute_table);
+	/* the native reader logs when it hands its input to cgraph */
+	log = tmpfile();
+	assert(log != NULL);
+	log_init(log,"dot_native");
+	log_filter_above(LOG_DEBUG);
+
+	for(i = 0; inputs[i] != NULL; i++)
+	{
+		/* the native reader tokenizes its input in place */
+		len = strlen(inputs[i]);
+		data = strdup(inputs[i]);
+		assert(data != NULL);
+		assert(ggen_read_graph_dot(&native,data,len) == 0);
+		read_cgraph(&cgraph,data,len);
+		same_graph(&native,&cgraph);
+
+		/* the native output reads back as the same graph */
+		write_graph(&native,ggen_write_graph_native,&out,&olen);
+		read_cgraph(&back,out,olen);
+		same_graph(&native,&back);
+		igraph_destroy(&back);
+		assert(ggen_read_graph_dot(&back,out,olen) == 0);
+		same_graph(&native,&back);
+		igraph_destroy(&back);
+		free(out);
+
+		/* cgraph interleaves vertices and edges, vertex ids change
+		 * but both readers must still agree */
+		write_graph(&cgraph,ggen_write_graph_cgraph,&out,&olen);
+		read_cgraph(&back,out,olen);
+		igraph_destroy(&cgraph);
+		assert(ggen_read_graph_dot(&cgraph,out,olen) == 0);
+		same_graph(&cgraph,&back);
+		igraph_destroy(&back);
+		free(out);
+
+		igraph_destroy(&native);
+		igraph_destroy(&cgraph);
+		free(data);
+	}
+
+	/* like handle_second_lvl: costs given on the command line are read
+	 * whatever the command uses */
+	ggen_read_property(GGEN_OBJECT_VERTEX,"cost");
+	ggen_read_property(GGEN_OBJECT_EDGE,"w");
+	/* names alone, like lp or out-degree */
+	ggen_read_attrs = GGEN_ATTRS_NAMES;
+	check_filtered(1,0);
+	/* a property alone, like analyse-property */
+	ggen_read_attrs = GGEN_ATTRS_PROPERTY;
+	ggen_read_kind = GGEN_OBJECT_EDGE;
+	ggen_read_name = "mark";
+	check_filtered(0,1);
+	/* the structure alone, like nb-edges */
+	ggen_read_attrs = 0;
+	check_filtered(0,0);
+
+	rewind(log);
+	while(fgets(line,sizeof(line),log) != NULL)
+		assert(strstr(line,"Falling back") == NULL);
+	fclose(log);
+	return 0;
+}
@@ -0,0 +1,212 @@
+/* Copyright Swann Perarnau 2009
+ *
+ *   contributor(s) :
+ *
+ *   contact : Swann.Perarnau@imag.fr
+ *
+ * This software is a computer program whose purpose is to help the
+ * random generation of graph structures and adding various properties
+ * on those structures.
+ *
+ * This software is governed by the CeCILL  license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+*/
+
+/* This file is an usage exemple of the edge sinks. It also serves
+ * as a test file to ensure the streaming generators work correctly
+ */
+
+#include "ggen.h"
+#include <assert.h>
+#include <string.h>
+
+/* counts the edges received, checks they come after begin */
+struct counter {
+	unsigned long n;
+	unsigned long m;
+	int begun;
+	int ended;
+};
+
+static int count_begin(struct ggen_edge_sink *s, unsigned long n, unsigned long m)
+{
+	struct counter *c = s->data;
+	c->begun = 1;
+	c->n = n;
+	return 0;
+}
+
+static int count_edges(struct ggen_edge_sink *s, const unsigned long *edges, unsigned long count)
+{
+	struct counter *c = s->data;
+	unsigned long i;
+	assert(c->begun && !c->ended);
+	for(i = 0; i < count; i++)
+		assert(edges[2*i] < edges[2*i+1]);
+	c->m += count;
+	return 0;
+}
+
+static int count_end(struct ggen_edge_sink *s, unsigned long n)
+{
+	struct counter *c = s->data;
+	c->ended = 1;
+	c->n = n;
+	return 0;
+}
+
+static void count_destroy(struct ggen_edge_sink *s)
+{
+}
+
+static unsigned long read_le(const unsigned char *buf, unsigned int width)
+{
+	unsigned long v = 0;
+	while(width--)
+		v = (v << 8) | buf[width];
+	return v;
+}
+
+int main()
+{
+	struct ggen_edge_sink *s;
+	struct ggen_edge_sink user;
+	struct counter c;
+	igraph_t *g;
+	gsl_rng *r;
+	FILE *f;
+	char line[80];
+	unsigned char buf[32];
+	unsigned long i,lines;
+
+	r = gsl_rng_alloc(gsl_rng_mt19937);
+	assert(r != NULL);
+
+	// a user defined sink receives all the edges, in batches
+	memset(&c,0,sizeof(c));
+	user.begin = count_begin;
+	user.edges = count_edges;
+	user.end = count_end;
+	user.destroy = count_destroy;
+	user.data = &c;
+	assert(ggen_stream_erdos_gnm(r,1000,5000,&user) == 0);
+	assert(c.ended && c.n == 1000 && c.m == 5000);
+
+	// fifo reports the final number of vertices at the end
+	memset(&c,0,sizeof(c));
+	assert(ggen_stream_fifo(r,100,3,3,&user) == 0);
+	assert(c.ended && c.n >= 100);
+
+	// invalid parameters are rejected
+	assert(ggen_stream_erdos_gnp(r,10,2.0,&user) != 0);
+	assert(ggen_stream_erdos_gnp(r,10,0.5,NULL) != 0);
+
+	// the igraph sink builds the same graph as the igraph version
+	g = malloc(sizeof(igraph_t));
+	s = ggen_edge_sink_igraph(g);
+	assert(s != NULL);
+	gsl_rng_set(r,42);
+	assert(ggen_stream_erdos_gnp(r,200,0.1,s) == 0);
+	ggen_edge_sink_free(s);
+	gsl_rng_set(r,42);
+	{
+		igraph_t *h = ggen_generate_erdos_gnp(r,200,0.1);
+		assert(h != NULL);
+		assert(igraph_ecount(g) == igraph_ecount(h));
+		igraph_destroy(h);
+		free((void *)h);
+	}
+	igraph_destroy(g);
+	free((void *)g);
+
+	// the dot sink declares every vertex, then every edge
+	f = tmpfile();
+	assert(f != NULL);
+	s = ggen_edge_sink_dot(f,"dag");
+	assert(s != NULL);
+	assert(ggen_stream_erdos_gnm(r,10,45,s) == 0);
+	ggen_edge_sink_free(s);
+	rewind(f);
+	assert(fgets(line,sizeof(line),f) != NULL);
+	assert(!strcmp(line,"digraph dag {\n"));
+	for(i = 0; i < 10; i++)
+	{
+		assert(fgets(line,sizeof(line),f) != NULL);
+		assert(strchr(line,'>') == NULL);
+	}
+	lines = 0;
+	while(fgets(line,sizeof(line),f) != NULL && strcmp(line,"}\n"))
+	{
+		assert(strstr(line," -> ") != NULL);
+		lines++;
+	}
+	assert(lines == 45);
+	fclose(f);
+
+	// the binary sink patches its header with the final counts
+	f = tmpfile();
+	assert(f != NULL);
+	s = ggen_edge_sink_binary(f);
+	assert(s != NULL);
+	assert(ggen_stream_random_orders(r,50,1,s) == 0);
+	ggen_edge_sink_free(s);
+	rewind(f);
+	assert(fread(buf,1,32,f) == 32);
+	assert(!memcmp(buf,"GGENEDGE",8));
+	assert(read_le(buf+8,4) == 1);
+	assert(read_le(buf+12,4) == 4);
+	assert(read_le(buf+16,8) == 50);
+	assert(read_le(buf+24,8) == 50*49/2);
+	for(i = 0; i < 50*49/2; i++)
+	{
+		assert(fread(buf,1,8,f) == 8);
+		assert(read_le(buf,4) < read_le(buf+4,4));
+	}
+	assert(fread(buf,1,1,f) == 0);
+	fclose(f);
+
+	// the edge list sink writes one line per edge
+	f = tmpfile();
+	assert(f != NULL);
+	s = ggen_edge_sink_edgelist(f);
+	assert(s != NULL);
+	assert(ggen_stream_erdos_gnm(r,10,20,s) == 0);
+	ggen_edge_sink_free(s);
+	rewind(f);
+	lines = 0;
+	while(fgets(line,sizeof(line),f) != NULL)
+	{
+		unsigned long from,to;
+		assert(sscanf(line,"%lu %lu",&from,&to) == 2);
+		assert(from < to && to < 10);
+		lines++;
+	}
+	assert(lines == 20);
+	fclose(f);
+
+	gsl_rng_free(r);
+	return 0;
+}
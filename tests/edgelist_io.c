@@ -0,0 +1,254 @@
+/* Copyright Swann Perarnau 2009
+ *
+ *   contributor(s) :
+ *
+ *   contact : Swann.Perarnau@imag.fr
+ *
+ * This software is a computer program whose purpose is to help the
+ * random generation of graph structures and adding various properties
+ * on those structures.
+ *
+ * This software is governed by the CeCILL  license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+
+/* This program checks the edge list reader: inputs big enough to be cut
+ * in chunks must give the edges in order with their attributes, quoted
+ * fields, header and named or numbered vertices included, sparse ids being
+ * read as names. The writer must warn about the vertices it loses.
+ */
+
+#include "ggen.h"
+#include "utils.h"
+#include "log.h"
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* a few megabytes, several chunks */
+#define N 60000
+
+static void read_list(igraph_t *g, const char *data)
+{
+	assert(ggen_read_graph_edgelist(g,data,strlen(data)) == 0);
+}
+
+/* the output of the writer, and does the log tell about lost vertices */
+static int write_list(igraph_t *g, FILE *log, char **out)
+{
+	char line[256];
+	size_t len;
+	long pos;
+	FILE *f;
+	int lost = 0;
+
+	f = open_memstream(out,&len);
+	assert(f != NULL);
+	fseek(log,0,SEEK_END);
+	pos = ftell(log);
+	assert(ggen_write_graph_edgelist(g,f) == 0);
+	fclose(f);
+	fflush(log);
+	fseek(log,pos,SEEK_SET);
+	while(fgets(line,sizeof(line),log) != NULL)
+		lost = lost || strstr(line,"isolated vertices are lost") != NULL;
+	return lost;
+}
+
+static int has_attr(igraph_t *g, const char *name, int type)
+{
+	igraph_strvector_t gn,vn,en;
+	igraph_vector_t gt,vt,et;
+	long i;
+	int found = 0;
+
+	igraph_strvector_init(&gn,0);
+	igraph_strvector_init(&vn,0);
+	igraph_strvector_init(&en,0);
+	igraph_vector_init(&gt,0);
+	igraph_vector_init(&vt,0);
+	igraph_vector_init(&et,0);
+	assert(igraph_cattribute_list(g,&gn,&gt,&vn,&vt,&en,&et) == 0);
+	for(i = 0; i < igraph_strvector_size(&en); i++)
+		if(!strcmp(STR(en,i),name) && VECTOR(et)[i] == type)
+			found = 1;
+	igraph_strvector_destroy(&gn);
+	igraph_strvector_destroy(&vn);
+	igraph_strvector_destroy(&en);
+	igraph_vector_destroy(&gt);
+	igraph_vector_destroy(&vt);
+	igraph_vector_destroy(&et);
+	return found;
+}
+
+/* the label of line i, quoted when it needs to be */
+static const char *label(unsigned long i, int quoted)
+{
+	static char s[64];
+
+	if(i % 7 == 0)
+		snprintf(s,sizeof(s),quoted ? "\"say \"\"%lu\"\"\"" : "say \"%lu\"",i);
+	else if(i % 3 == 0)
+		snprintf(s,sizeof(s),quoted ? "\"a, %lu\"" : "a, %lu",i);
+	else
+		snprintf(s,sizeof(s),"l%lu",i);
+	return s;
+}
+
+int main(int argc,char** argv)
+{
+	igraph_t g;
+	igraph_integer_t from,to;
+	char *data,*out,name[32],cost[GGEN_DEFAULT_NAME_SIZE];
+	size_t size,len;
+	unsigned long i;
+	FILE *log;
+
+	igraph_i_set_attribute_table(&igraph_cattribute_table);
+	/* several chunks, even on a single processor */
+	ggen_io_threads = 4;
+	log = tmpfile();
+	assert(log != NULL);
+	log_init(log,"edgelist_io");
+	log_filter_above(LOG_DEBUG);
+	size = 64*N + 64;
+	data = malloc(size);
+	assert(data != NULL);
+
+	/* numbered vertices, a header naming the columns, comments and
+	 * blank lines in the middle */
+	len = snprintf(data,size,"# source target cost label\n");
+	for(i = 0; i < N; i++)
+	{
+		if(i % 1000 == 0)
+			len += snprintf(data + len,size - len,"# %lu\n\n",i);
+		d2s(i*0.25,cost,sizeof(cost));
+		len += snprintf(data + len,size - len,"%lu,%lu %s\t%s\n",
+				i,i + 1,cost,label(i,1));
+	}
+	read_list(&g,data);
+	assert(igraph_vcount(&g) == N + 1);
+	assert(igraph_ecount(&g) == N);
+	assert(has_attr(&g,"cost",IGRAPH_ATTRIBUTE_NUMERIC));
+	assert(has_attr(&g,"label",IGRAPH_ATTRIBUTE_STRING));
+	for(i = 0; i < N; i++)
+	{
+		igraph_edge(&g,i,&from,&to);
+		assert(from == i && to == i + 1);
+		assert(EAN(&g,"cost",i) == i*0.25);
+		assert(!strcmp(EAS(&g,"label",i),label(i,0)));
+	}
+	igraph_destroy(&g);
+
+	/* named vertices, numbered by order of appearance, a leading
+	 * comment that is not a header */
+	len = snprintf(data,size,"# generated\n");
+	for(i = 0; i < N; i++)
+		len += snprintf(data + len,size - len,"v%lu \"w %lu\" %lu\n",i,i,i);
+	read_list(&g,data);
+	assert(igraph_vcount(&g) == 2*N);
+	assert(igraph_ecount(&g) == N);
+	assert(has_attr(&g,"weight",IGRAPH_ATTRIBUTE_NUMERIC));
+	for(i = 0; i < N; i++)
+	{
+		igraph_edge(&g,i,&from,&to);
+		assert(from == 2*i && to == 2*i + 1);
+		snprintf(name,sizeof(name),"v%lu",i);
+		assert(!strcmp(VAS(&g,GGEN_VERTEX_NAME_ATTR,from),name));
+		snprintf(name,sizeof(name),"w %lu",i);
+		assert(!strcmp(VAS(&g,GGEN_VERTEX_NAME_ATTR,to),name));
+		assert(EAN(&g,"weight",i) == i);
+	}
+	igraph_destroy(&g);
+
+	/* a header of the wrong size, a column that is not all numbers */
+	read_list(&g,"# a b c\n0 1 5 x\n1 2 6 7\n");
+	assert(has_attr(&g,"weight",IGRAPH_ATTRIBUTE_NUMERIC));
+	assert(has_attr(&g,"weight2",IGRAPH_ATTRIBUTE_STRING));
+	assert(EAN(&g,"weight",1) == 6);
+	assert(!strcmp(EAS(&g,"weight2",1),"7"));
+	igraph_destroy(&g);
+
+	/* numbers that would not be written back the same stay strings:
+	 * too long, trailing zeros, too many digits, overflow */
+	len = snprintf(data,size,"0 1 1.");
+	for(i = 0; i < 200; i++)
+		data[len++] = '0';
+	strcpy(data + len,"5\n");
+	read_list(&g,data);
+	assert(has_attr(&g,"weight",IGRAPH_ATTRIBUTE_STRING));
+	data[len + 1] = '\0';
+	assert(!strcmp(EAS(&g,"weight",0),data + 4));
+	igraph_destroy(&g);
+	read_list(&g,"0 1 1.50\n1 2 12345678901234567890\n2 3 1e400\n");
+	assert(has_attr(&g,"weight",IGRAPH_ATTRIBUTE_STRING));
+	assert(!strcmp(EAS(&g,"weight",0),"1.50"));
+	assert(!strcmp(EAS(&g,"weight",1),"12345678901234567890"));
+	assert(!strcmp(EAS(&g,"weight",2),"1e400"));
+	igraph_destroy(&g);
+	read_list(&g,"0 1 1.5\n1 2 123456789012345\n2 3 -0.125\n");
+	assert(has_attr(&g,"weight",IGRAPH_ATTRIBUTE_NUMERIC));
+	igraph_destroy(&g);
+
+	/* a huge id would create billions of vertices: sparse ids are
+	 * names, kept as written */
+	read_list(&g,"4000000000 1\n1 7\n");
+	assert(igraph_vcount(&g) == 3);
+	assert(igraph_ecount(&g) == 2);
+	assert(!strcmp(VAS(&g,GGEN_VERTEX_NAME_ATTR,0),"4000000000"));
+	assert(!strcmp(VAS(&g,GGEN_VERTEX_NAME_ATTR,2),"7"));
+	assert(!write_list(&g,log,&out));
+	assert(!strcmp(out,"4000000000 1\n1 7\n"));
+	free(out);
+	igraph_destroy(&g);
+	/* small gaps are isolated vertices */
+	read_list(&g,"0 1\n5 6\n");
+	assert(igraph_vcount(&g) == 7);
+
+	/* isolated vertices below the biggest id are kept, not the others */
+	assert(!write_list(&g,log,&out));
+	assert(!strcmp(out,"0 1\n5 6\n"));
+	free(out);
+	igraph_add_vertices(&g,2,NULL);
+	assert(write_list(&g,log,&out));
+	assert(!strcmp(out,"0 1\n5 6\n"));
+	free(out);
+	igraph_destroy(&g);
+	/* named ones are all lost */
+	read_list(&g,"a b\n");
+	igraph_add_vertices(&g,1,NULL);
+	assert(write_list(&g,log,&out));
+	free(out);
+	igraph_destroy(&g);
+
+	/* unterminated quote */
+	assert(ggen_read_graph_edgelist(&g,"0 1 \"x\n",7) != 0);
+
+	fclose(log);
+	free(data);
+	return 0;
+}
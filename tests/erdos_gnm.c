@@ -46,6 +46,8 @@ int main()
 {
 	igraph_t *g;
 	gsl_rng *r;
+	igraph_integer_t from,to,eid;
+	unsigned long i;
 
 	r = gsl_rng_alloc(gsl_rng_mt19937);
 	assert(r != NULL);
@@ -75,6 +77,27 @@ int main()
 	igraph_destroy(g);
 	free((void *)g);
 
+	// a dense call picks the edges to exclude, edges must still be unique
+	g = ggen_generate_erdos_gnm(r,10,40);
+	assert(g != NULL);
+	assert(igraph_ecount(g) == 40);
+	for(i = 0; i < igraph_ecount(g); i++)
+	{
+		igraph_edge(g,i,&from,&to);
+		assert(from < to);
+		assert(igraph_get_eid(g,&eid,from,to,1) == 0 && eid == i);
+	}
+	igraph_destroy(g);
+	free((void *)g);
+
+	// a big sparse graph must not cost n*n
+	g = ggen_generate_erdos_gnm(r,100000,200000);
+	assert(g != NULL);
+	assert(igraph_vcount(g) == 100000);
+	assert(igraph_ecount(g) == 200000);
+	igraph_destroy(g);
+	free((void *)g);
+
 	gsl_rng_free(r);
 	return 0;
 }
@@ -46,6 +46,8 @@ int main()
 {
 	igraph_t *g;
 	gsl_rng *r;
+	igraph_integer_t from,to;
+	unsigned long i;
 
 	r = gsl_rng_alloc(gsl_rng_mt19937);
 	assert(r != NULL);
@@ -82,6 +84,33 @@ int main()
 	igraph_destroy(g);
 	free((void *)g);
 
+	// a dense graph goes through a bit matrix, edges must still go forward
+	g = ggen_generate_erdos_gnp(r,200,0.9);
+	assert(g != NULL);
+	for(i = 0; i < igraph_ecount(g); i++)
+	{
+		igraph_edge(g,i,&from,&to);
+		assert(from < to);
+	}
+	// expected number of edges is 17910, stddev is around 42
+	assert(igraph_ecount(g) > 17700 && igraph_ecount(g) < 18100);
+	igraph_destroy(g);
+	free((void *)g);
+
+	// a big sparse graph must not cost n*n, and all edges must go forward
+	g = ggen_generate_erdos_gnp(r,100000,0.00001);
+	assert(g != NULL);
+	assert(igraph_vcount(g) == 100000);
+	for(i = 0; i < igraph_ecount(g); i++)
+	{
+		igraph_edge(g,i,&from,&to);
+		assert(from < to);
+	}
+	// expected number of edges is 49999.5, stddev is around 224
+	assert(igraph_ecount(g) > 48000 && igraph_ecount(g) < 52000);
+	igraph_destroy(g);
+	free((void *)g);
+
 	gsl_rng_free(r);
 	return 0;
 }
@@ -84,6 +84,13 @@ int main()
 	igraph_destroy(g);
 	free((void *)g);
 
+	// a big sparse graph must not cost n*n
+	g = ggen_generate_erdos_lbl(r,100000,0.00001,10);
+	assert(g != NULL);
+	assert(igraph_vcount(g) == 100000);
+	igraph_destroy(g);
+	free((void *)g);
+
 	gsl_rng_free(r);
 	return 0;
 }
@@ -0,0 +1,128 @@
+/* Copyright Swann Perarnau 2009
+ *
+ *   contributor(s) :
+ *
+ *   contact : Swann.Perarnau@imag.fr
+ *
+ * This software is a computer program whose purpose is to help the
+ * random generation of graph structures and adding various properties
+ * on those structures.
+ *
+ * This software is governed by the CeCILL  license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+*/
+
+/* This file is an usage exemple of the parallel gnp and lbl generation
+ * methods. It also serves as a test file to ensure they work correctly
+ */
+
+#include "ggen.h"
+#include <assert.h>
+
+/* generates with the given number of threads, from a fixed seed */
+static igraph_t *generate(gsl_rng *r, int lbl, unsigned long n, double p, unsigned int threads)
+{
+	struct ggen_edge_sink *s;
+	igraph_t *g;
+	int err;
+
+	g = malloc(sizeof(igraph_t));
+	assert(g != NULL);
+	s = ggen_edge_sink_igraph(g);
+	assert(s != NULL);
+	gsl_rng_set(r,4242);
+	if(lbl)
+		err = ggen_stream_erdos_lbl_parallel(r,n,p,5,threads,s);
+	else
+		err = ggen_stream_erdos_gnp_parallel(r,n,p,threads,s);
+	ggen_edge_sink_free(s);
+	assert(err == 0);
+	return g;
+}
+
+static void same_graph(igraph_t *a, igraph_t *b)
+{
+	igraph_integer_t f1,t1,f2,t2;
+	unsigned long i;
+
+	assert(igraph_vcount(a) == igraph_vcount(b));
+	assert(igraph_ecount(a) == igraph_ecount(b));
+	for(i = 0; i < igraph_ecount(a); i++)
+	{
+		igraph_edge(a,i,&f1,&t1);
+		igraph_edge(b,i,&f2,&t2);
+		assert(f1 == f2 && t1 == t2);
+	}
+}
+
+static void check_threads(gsl_rng *r, int lbl, unsigned long n, double p,
+		double low, double high)
+{
+	igraph_t *ref,*g;
+	unsigned int threads[] = { 2, 3, 8 };
+	unsigned long i;
+
+	ref = generate(r,lbl,n,p,1);
+	assert(igraph_ecount(ref) >= low && igraph_ecount(ref) <= high);
+	for(i = 0; i < sizeof(threads)/sizeof(threads[0]); i++)
+	{
+		g = generate(r,lbl,n,p,threads[i]);
+		same_graph(ref,g);
+		igraph_destroy(g);
+		free((void *)g);
+	}
+	igraph_destroy(ref);
+	free((void *)ref);
+}
+
+int main()
+{
+	struct ggen_edge_sink *s;
+	gsl_rng *r;
+	igraph_t g;
+
+	r = gsl_rng_alloc(gsl_rng_mt19937);
+	assert(r != NULL);
+
+	// zero threads is not a valid parameter
+	s = ggen_edge_sink_igraph(&g);
+	assert(ggen_stream_erdos_gnp_parallel(r,10,0.5,0,s) != 0);
+	ggen_edge_sink_free(s);
+
+	// the graph does not depend on the number of threads, be it
+	// sparse or dense, expected edge counts are 0.01*n*(n-1)/2 and
+	// 0.8*n*(n-1)/2
+	check_threads(r,0,20000,0.001,190000,210000);
+	check_threads(r,0,1000,0.8,396000,403000);
+
+	// same thing for layer by layer, with 5 layers 4/5th of the
+	// edges are possible
+	check_threads(r,1,20000,0.001,150000,170000);
+	check_threads(r,1,1000,0.8,312000,327000);
+
+	gsl_rng_free(r);
+	return 0;
+}
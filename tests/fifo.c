@@ -45,6 +45,7 @@
 int main()
 {
 	igraph_t *g;
+	igraph_vector_t d;
 	gsl_rng *r;
 
 	r = gsl_rng_alloc(gsl_rng_mt19937);
@@ -63,6 +64,19 @@ int main()
 	igraph_destroy(g);
 	free((void *)g);
 
+	// degree bounds must be respected, even on big graphs
+	g = ggen_generate_fifo(r,100000,5,3);
+	assert(g != NULL);
+	assert(igraph_vcount(g) >= 100000 && igraph_vcount(g) < 100005);
+	igraph_vector_init(&d,0);
+	igraph_degree(g,&d,igraph_vss_all(),IGRAPH_OUT,0);
+	assert(igraph_vector_max(&d) <= 5);
+	igraph_degree(g,&d,igraph_vss_all(),IGRAPH_IN,0);
+	assert(igraph_vector_max(&d) <= 3);
+	igraph_vector_destroy(&d);
+	igraph_destroy(g);
+	free((void *)g);
+
 	gsl_rng_free(r);
 	return 0;
 }
@@ -46,6 +46,8 @@ int main(int argc,char** argv)
 {
 	igraph_vector_t *lp;
 	igraph_t g;
+	igraph_vector_t vcost,ecost,path,start;
+	double length;
 
 	// all ggen methods should fail on incorrect arguments
 	assert(ggen_analyze_longest_path(NULL) == NULL);
@@ -84,5 +86,45 @@ int main(int argc,char** argv)
 	igraph_vector_destroy(lp);
 	free((void *)lp);
 
+	// weighted critical path: 0 -> 1 -> 3 and 0 -> 2 -> 3
+	// vertex 1 is long, edge 0 -> 2 is long
+	igraph_small(&g,4,1,0,1,0,2,1,3,2,3,-1);
+	igraph_vector_init(&vcost,4);
+	igraph_vector_init(&ecost,4);
+	igraph_vector_init(&path,0);
+	igraph_vector_init(&start,0);
+	assert(ggen_analyze_critical_path(NULL,NULL,NULL,&path,&start,&length) == 1);
+
+	// edge costs only: the path goes through 2
+	VECTOR(ecost)[0] = 1; VECTOR(ecost)[1] = 5;
+	VECTOR(ecost)[2] = 1; VECTOR(ecost)[3] = 1;
+	assert(ggen_analyze_critical_path(&g,NULL,&ecost,&path,&start,&length) == 0);
+	assert(length == 6);
+	assert(igraph_vector_size(&path) == 3);
+	assert(VECTOR(path)[0] == 0 && VECTOR(path)[1] == 2 && VECTOR(path)[2] == 3);
+
+	// with vertex costs, vertex 1 wins
+	VECTOR(vcost)[0] = 2; VECTOR(vcost)[1] = 10;
+	VECTOR(vcost)[2] = 1; VECTOR(vcost)[3] = 1;
+	assert(ggen_analyze_critical_path(&g,&vcost,&ecost,&path,&start,&length) == 0);
+	assert(length == 15);
+	assert(VECTOR(path)[1] == 1);
+	assert(VECTOR(start)[0] == 0 && VECTOR(start)[1] == 3);
+	assert(VECTOR(start)[2] == 7 && VECTOR(start)[3] == 14);
+
+	// costs of the wrong size are refused
+	igraph_vector_resize(&ecost,2);
+	assert(ggen_analyze_critical_path(&g,NULL,&ecost,&path,&start,&length) == 1);
+	igraph_destroy(&g);
+
+	// cycles are refused
+	igraph_small(&g,3,1,0,1,1,2,2,0,-1);
+	assert(ggen_analyze_critical_path(&g,&vcost,NULL,&path,&start,&length) == 1);
+	igraph_destroy(&g);
+
+	igraph_vector_destroy(&vcost);
+	igraph_vector_destroy(&ecost);
+	igraph_vector_destroy(&path);
+	igraph_vector_destroy(&start);
 	return 0;
 }
@@ -0,0 +1,138 @@
+/* Copyright Swann Perarnau 2009
+ *
+ *   contributor(s) :
+ *
+ *   contact : Swann.Perarnau@imag.fr
+ *
+ * This software is a computer program whose purpose is to help the
+ * random generation of graph structures and adding various properties
+ * on those structures.
+ *
+ * This software is governed by the CeCILL  license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+
+/* This program is an usage example of the maximal paths methods of ggen.
+ * It also works as a unit test.
+ */
+
+#include "ggen.h"
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+static int count_path(const uint32_t *path, uint32_t len, void *data)
+{
+	unsigned long *c = data;
+	// paths go forward in a full dag
+	for(uint32_t i = 1; i < len; i++)
+		assert(path[i-1] < path[i]);
+	(*c)++;
+	return 0;
+}
+
+static int stop(const uint32_t *path, uint32_t len, void *data)
+{
+	return 1;
+}
+
+int main(int argc,char** argv)
+{
+	struct ggen_dag d;
+	igraph_t g;
+	igraph_vector_t lthrough;
+	igraph_strvector_t through;
+	unsigned long c,count;
+	double total;
+	char *s;
+	uint32_t v;
+
+	// all ggen methods should fail on incorrect arguments
+	assert(ggen_dag_count_paths(NULL,NULL,&total) == 1);
+	assert(ggen_dag_count_paths_exact(NULL,NULL,&s) == 1);
+	assert(ggen_dag_maximal_paths(NULL,0,count_path,&c,&count) == 1);
+
+	// a full dag of n vertices has 2^(n-2) maximal paths, from 0 to n-1
+	igraph_full_citation(&g,20,1);
+	assert(ggen_dag_init(&d,&g) == 0);
+	assert(ggen_dag_maximal_paths(&d,0,NULL,NULL,&count) == 1);
+	c = 0;
+	assert(ggen_dag_maximal_paths(&d,0,count_path,&c,&count) == 0);
+	assert(c == 262144 && count == 262144);
+
+	// with a limit
+	c = 0;
+	assert(ggen_dag_maximal_paths(&d,10,count_path,&c,&count) == 0);
+	assert(c == 10 && count == 10);
+
+	// the callback can stop
+	assert(ggen_dag_maximal_paths(&d,0,stop,NULL,&count) == 0);
+	assert(count == 1);
+
+	igraph_vector_init(&lthrough,0);
+	assert(ggen_dag_count_paths(&d,&lthrough,&total) == 0);
+	assert(fabs(total - 18*log(2)) < 1e-9);
+	assert(fabs(VECTOR(lthrough)[0] - 18*log(2)) < 1e-9);
+	assert(fabs(VECTOR(lthrough)[5] - 17*log(2)) < 1e-9);
+	igraph_vector_destroy(&lthrough);
+	ggen_dag_destroy(&d);
+	igraph_destroy(&g);
+
+	// exact counts do not overflow
+	igraph_full_citation(&g,100,1);
+	assert(ggen_dag_init(&d,&g) == 0);
+	igraph_strvector_init(&through,0);
+	assert(ggen_dag_count_paths_exact(&d,&through,&s) == 0);
+	assert(!strcmp(s,"316912650057057350374175801344"));
+	assert(!strcmp(STR(through,0),"316912650057057350374175801344"));
+	assert(!strcmp(STR(through,99),"316912650057057350374175801344"));
+	for(v = 1; v < 99; v++)
+		assert(!strcmp(STR(through,v),"158456325028528675187087900672"));
+	free(s);
+	igraph_strvector_destroy(&through);
+	ggen_dag_destroy(&d);
+	igraph_destroy(&g);
+
+	// isolated vertices are paths on their own
+	igraph_empty(&g,3,1);
+	assert(ggen_dag_init(&d,&g) == 0);
+	assert(ggen_dag_count_paths_exact(&d,NULL,&s) == 0);
+	assert(!strcmp(s,"3"));
+	free(s);
+	assert(ggen_dag_maximal_paths(&d,0,count_path,&c,&count) == 0);
+	assert(count == 3);
+	ggen_dag_destroy(&d);
+	igraph_destroy(&g);
+
+	// cycles are refused
+	igraph_small(&g,3,1,0,1,1,2,2,0,-1);
+	assert(ggen_dag_init(&d,&g) == 0);
+	assert(ggen_dag_count_paths(&d,NULL,&total) == 1);
+	assert(ggen_dag_maximal_paths(&d,0,count_path,&c,&count) == 1);
+	ggen_dag_destroy(&d);
+	igraph_destroy(&g);
+	return 0;
+}
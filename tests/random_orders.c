@@ -42,10 +42,51 @@
 #include "ggen.h"
 #include <assert.h>
 
+/* depth first search from u to v, vertices are labelled in
+ * topological order so we can stop early */
+static int reaches(igraph_t *g, igraph_integer_t u, igraph_integer_t v)
+{
+	igraph_vector_t neis;
+	unsigned long i;
+	int found = (u == v);
+
+	igraph_vector_init(&neis,0);
+	igraph_neighbors(g,&neis,u,IGRAPH_OUT);
+	for(i = 0; !found && i < igraph_vector_size(&neis); i++)
+		if(VECTOR(neis)[i] <= v)
+			found = reaches(g,VECTOR(neis)[i],v);
+	igraph_vector_destroy(&neis);
+	return found;
+}
+
+/* a sink that only counts edges */
+static int count_begin(struct ggen_edge_sink *s, unsigned long n, unsigned long m)
+{
+	*(unsigned long *)s->data = 0;
+	return 0;
+}
+
+static int count_edges(struct ggen_edge_sink *s, const unsigned long *edges,
+		unsigned long count)
+{
+	*(unsigned long *)s->data += count;
+	return 0;
+}
+
+static int count_end(struct ggen_edge_sink *s, unsigned long n)
+{
+	return 0;
+}
+
 int main()
 {
-	igraph_t *g;
+	struct ggen_edge_sink cs = { count_begin, count_edges, count_end, NULL, NULL };
+	unsigned long edges;
+	igraph_t *g,*h;
 	gsl_rng *r;
+	igraph_integer_t from,to,eid,w;
+	unsigned long i;
+	unsigned int o;
 
 	r = gsl_rng_alloc(gsl_rng_mt19937);
 	assert(r != NULL);
@@ -60,6 +101,62 @@ int main()
 	igraph_destroy(g);
 	free((void *)g);
 
+	// a single order is a total order
+	g = ggen_generate_random_orders(r,10,1);
+	assert(g != NULL);
+	assert(igraph_ecount(g) == 45);
+	igraph_destroy(g);
+	free((void *)g);
+
+	g = ggen_generate_random_orders_hasse(r,10,1);
+	assert(g != NULL);
+	assert(igraph_ecount(g) == 9);
+	igraph_destroy(g);
+	free((void *)g);
+
+	// the hasse diagram must be a subgraph of the order, with the same
+	// transitive closure, whatever the number of orders
+	for(o = 2; o < 5; o++)
+	{
+		gsl_rng_set(r,o);
+		g = ggen_generate_random_orders(r,50,o);
+		assert(g != NULL);
+		gsl_rng_set(r,o);
+		h = ggen_generate_random_orders_hasse(r,50,o);
+		assert(h != NULL);
+		assert(igraph_ecount(h) <= igraph_ecount(g));
+		for(i = 0; i < igraph_ecount(h); i++)
+		{
+			igraph_edge(h,i,&from,&to);
+			assert(igraph_get_eid(g,&eid,from,to,1) == 0);
+		}
+		// and no edge of the diagram is a path of two edges of the order
+		for(i = 0; i < igraph_ecount(h); i++)
+		{
+			igraph_edge(h,i,&from,&to);
+			for(w = from + 1; w < to; w++)
+				assert(igraph_get_eid(g,&eid,from,w,1) != 0
+					|| igraph_get_eid(g,&eid,w,to,1) != 0);
+		}
+		// every edge of the order is a path in the diagram
+		for(i = 0; i < igraph_ecount(g); i++)
+		{
+			igraph_edge(g,i,&from,&to);
+			assert(from < to);
+			assert(reaches(h,from,to));
+		}
+		igraph_destroy(g);
+		free((void *)g);
+		igraph_destroy(h);
+		free((void *)h);
+	}
+
+	// the diagram of two orders has O(n log n) edges, the sweep finds
+	// them without looking at all the pairs of vertices
+	cs.data = &edges;
+	assert(ggen_stream_random_orders_hasse(r,100000,2,&cs) == 0);
+	assert(edges > 100000 && edges < 40*100000);
+
 	gsl_rng_free(r);
 	return 0;
 }
@@ -69,5 +69,15 @@ int main(int argc,char** argv)
 	assert(igraph_ecount(&g) == 6);
 	igraph_destroy(&g);
 
+	// self loops do not count, graph is
+	//		0--->1--->2
+	//		0 and 2 loop on themselves
+	igraph_small(&g,3,1,0,0,0,1,1,2,2,2,-1);
+	assert(ggen_transform_add(&g,GGEN_TRANSFORM_SOURCE) == 0);
+	assert(igraph_ecount(&g) == 5);
+	assert(ggen_transform_add(&g,GGEN_TRANSFORM_SINK) == 0);
+	assert(igraph_ecount(&g) == 6);
+	igraph_destroy(&g);
+
 	return 0;
 }
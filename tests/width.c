@@ -0,0 +1,156 @@
+/* Copyright Swann Perarnau 2009
+ *
+ *   contributor(s) :
+ *
+ *   contact : Swann.Perarnau@imag.fr
+ *
+ * This software is a computer program whose purpose is to help the
+ * random generation of graph structures and adding various properties
+ * on those structures.
+ *
+ * This software is governed by the CeCILL  license under French law and
+ * abiding by the rules of distribution of free software.  You can  use,
+ * modify and/ or redistribute the software under the terms of the CeCILL
+ * license as circulated by CEA, CNRS and INRIA at the following URL
+ * "http://www.cecill.info".
+ *
+ * As a counterpart to the access to the source code and  rights to copy,
+ * modify and redistribute granted by the license, users are provided only
+ * with a limited warranty  and the software's author,  the holder of the
+ * economic rights,  and the successive licensors  have only  limited
+ * liability.
+ *
+ * In this respect, the user's attention is drawn to the risks associated
+ * with loading,  using,  modifying and/or developing or reproducing the
+ * software by the user in light of its specific status of free software,
+ * that may mean  that it is complicated to manipulate,  and  that  also
+ * therefore means  that it is reserved for developers  and  experienced
+ * professionals having in-depth computer knowledge. Users are therefore
+ * encouraged to load and test the software's suitability as regards their
+ * requirements in conditions enabling the security of their systems and/or
+ * data to be ensured and,  more generally, to use and operate it in the
+ * same conditions as regards security.
+ *
+ * The fact that you are presently reading this means that you have had
+ * knowledge of the CeCILL license and that you accept its terms.
+ */
+
+/* This program is an usage example of the width method of ggen.
+ * It also works as a unit test: the antichain and the chain cover
+ * returned are checked, being of the same size they are both optimal.
+ */
+
+#include "ggen.h"
+#include <assert.h>
+#include <string.h>
+
+#define N 60
+
+static char reach[N][N];
+
+/* reach[u][v] if there is a path from u to v */
+static void closure(igraph_t *g)
+{
+	struct ggen_dag d;
+	uint32_t i,k,u,v;
+	long w;
+
+	assert(ggen_dag_init(&d,g) == 0);
+	memset(reach,0,sizeof(reach));
+	for(i = d.n; i > 0; i--)
+	{
+		u = d.order[i-1];
+		reach[u][u] = 1;
+		for(k = d.out_off[u]; k < d.out_off[u+1]; k++)
+			for(v = d.out[k], w = 0; w < d.n; w++)
+				reach[u][w] |= reach[v][w];
+	}
+	ggen_dag_destroy(&d);
+}
+
+static void check(igraph_t *g)
+{
+	igraph_vector_t antichain,chain;
+	unsigned long width,i,j,u,v,n;
+
+	n = igraph_vcount(g);
+	closure(g);
+	igraph_vector_init(&antichain,0);
+	igraph_vector_init(&chain,0);
+	assert(ggen_analyze_width(g,&antichain,&chain,&width) == 0);
+	assert(igraph_vector_size(&antichain) == width);
+	assert(igraph_vector_size(&chain) == n);
+
+	// no two vertices of the antichain are comparable
+	for(i = 0; i < width; i++)
+		for(j = i+1; j < width; j++)
+		{
+			u = VECTOR(antichain)[i];
+			v = VECTOR(antichain)[j];
+			assert(!reach[u][v] && !reach[v][u]);
+		}
+	// any two vertices of a chain are
+	for(u = 0; u < n; u++)
+	{
+		assert(VECTOR(chain)[u] < width);
+		for(v = u+1; v < n; v++)
+			if(VECTOR(chain)[u] == VECTOR(chain)[v])
+				assert(reach[u][v] || reach[v][u]);
+	}
+	igraph_vector_destroy(&antichain);
+	igraph_vector_destroy(&chain);
+}
+
+int main(int argc,char** argv)
+{
+	igraph_t g;
+	igraph_t *rg;
+	gsl_rng *r;
+	unsigned long width;
+	int i;
+
+	// all ggen methods should fail on incorrect arguments
+	assert(ggen_analyze_width(NULL,NULL,NULL,&width) == 1);
+	assert(ggen_dag_width(NULL,NULL,NULL,&width) == 1);
+
+	// a graph without edges is an antichain
+	igraph_empty(&g,10,1);
+	assert(ggen_analyze_width(&g,NULL,NULL,&width) == 0);
+	assert(width == 10);
+	check(&g);
+	igraph_destroy(&g);
+
+	// a full dag is a chain
+	igraph_full_citation(&g,10,1);
+	assert(ggen_analyze_width(&g,NULL,NULL,&width) == 0);
+	assert(width == 1);
+	check(&g);
+	igraph_destroy(&g);
+
+	// chains may skip vertices: 0 -> 1 -> 2, 3 -> 1 -> 4
+	// the cover 0,1,2 and 3,4 needs the path 3 -> 1 -> 4
+	igraph_small(&g,5,1,0,1,1,2,3,1,1,4,-1);
+	assert(ggen_analyze_width(&g,NULL,NULL,&width) == 0);
+	assert(width == 2);
+	check(&g);
+	igraph_destroy(&g);
+
+	// a cycle is refused
+	igraph_small(&g,3,1,0,1,1,2,2,0,-1);
+	assert(ggen_analyze_width(&g,NULL,NULL,&width) == 1);
+	igraph_destroy(&g);
+
+	// random dags of various densities
+	r = gsl_rng_alloc(gsl_rng_mt19937);
+	assert(r != NULL);
+	for(i = 0; i < 40; i++)
+	{
+		rg = ggen_generate_erdos_gnp(r,N,0.01*(i%10) + 0.005);
+		assert(rg != NULL);
+		check(rg);
+		igraph_destroy(rg);
+		free((void *)rg);
+	}
+	gsl_rng_free(r);
+	return 0;
+}